@@ -163,6 +163,7 @@ void DismantleFacilityState::btnOkClick(Action *)
 			if (*i == _fac)
 			{
 				_base->getFacilities()->erase(i);
+				_base->invalidateCapacities();
 				// Determine if we leave behind any facilities when this one is removed
 				if (_fac->getBuildTime() == 0 && _fac->getRules()->getLeavesBehindOnSell().size() != 0)
 				{
@@ -190,6 +191,7 @@ void DismantleFacilityState::btnOkClick(Action *)
 							fac->setIfHadPreviousFacility(true);
 						}
 						_base->getFacilities()->push_back(fac);
+						_base->invalidateCapacities();
 					}
 					else
 					{
@@ -215,6 +217,7 @@ void DismantleFacilityState::btnOkClick(Action *)
 									fac->setIfHadPreviousFacility(true);
 								}
 								_base->getFacilities()->push_back(fac);
+								_base->invalidateCapacities();
 
 								++j;
 								if (j == facList.size())
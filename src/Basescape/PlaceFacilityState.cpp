@@ -294,6 +294,7 @@ void PlaceFacilityState::viewClick(Action *)
 
 					// Remove the facility from the base
 					_base->getFacilities()->erase(_base->getFacilities()->begin() + i);
+					_base->invalidateCapacities();
 					delete checkFacility;
 				}
 
@@ -312,6 +313,7 @@ void PlaceFacilityState::viewClick(Action *)
 				fac->setBuildTime(std::max(1, fac->getBuildTime() - reducedBuildTimeRounded));
 			}
 			_base->getFacilities()->push_back(fac);
+			_base->invalidateCapacities();
 			
 			if (fac->getRules()->getPlaceSound() != Mod::NO_SOUND)
 			{
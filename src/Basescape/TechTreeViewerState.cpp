@@ -373,9 +373,6 @@ void TechTreeViewerState::initLists()
 		}
 		//
 
-		const std::vector<std::string> &researchList = _game->getMod()->getResearchList();
-		const std::vector<std::string> &manufactureList = _game->getMod()->getManufactureList();
-
 		// 0. common pre-calculation
 		const std::vector<const RuleResearch*> reqs = rule->getRequirements();
 		const std::vector<const RuleResearch*> deps = rule->getDependencies();
@@ -397,47 +394,22 @@ void TechTreeViewerState::initLists()
 		const std::vector<const RuleResearch*> free = rule->getGetOneFree();
 		auto& freeProtected = rule->getGetOneFreeProtected();
 
-		for (auto& j : manufactureList)
+		const ResearchUnlocks &requiredBy = _game->getMod()->getResearchUnlocks(rule);
+		for (auto* i : requiredBy.manufacture)
 		{
-			RuleManufacture *temp = _game->getMod()->getManufacture(j);
-			for (auto& i : temp->getRequirements())
-			{
-				if (i == rule)
-				{
-					requiredByManufacture.push_back(j);
-				}
-			}
+			requiredByManufacture.push_back(i->getName());
 		}
-
-		for (auto &f : _game->getMod()->getBaseFacilitiesList())
+		for (auto* i : requiredBy.facilities)
 		{
-			RuleBaseFacility *temp = _game->getMod()->getBaseFacility(f);
-			for (auto &i : temp->getRequirements())
-			{
-				if (i == rule->getName())
-				{
-					requiredByFacilities.push_back(f);
-				}
-			}
+			requiredByFacilities.push_back(i->getType());
 		}
-
-		for (auto &item : _game->getMod()->getItemsList())
+		for (auto* i : requiredBy.items)
 		{
-			RuleItem *temp = _game->getMod()->getItem(item);
-			for (auto &i : temp->getRequirements())
-			{
-				if (i == rule)
-				{
-					requiredByItems.push_back(item);
-				}
-			}
-			for (auto &i : temp->getBuyRequirements())
-			{
-				if (i == rule)
-				{
-					requiredByItems.push_back(item);
-				}
-			}
+			requiredByItems.push_back(i->getType());
+		}
+		for (auto* i : requiredBy.crafts)
+		{
+			requiredByCrafts.push_back(i->getType());
 		}
 
 		for (auto& transf : _game->getMod()->getSoldierTransformationList())
@@ -452,81 +424,21 @@ void TechTreeViewerState::initLists()
 			}
 		}
 
-		for (auto &c : _game->getMod()->getCraftsList())
-		{
-			RuleCraft *temp = _game->getMod()->getCraft(c);
-			for (auto &i : temp->getRequirements())
-			{
-				if (i == rule->getName())
-				{
-					requiredByCrafts.push_back(c);
-				}
-			}
-		}
-
-		for (auto& j : researchList)
+		const ResearchLinks &links = _game->getMod()->getResearchLinks();
+		auto addNames = [&](std::vector<std::string> &names, const RuleLinks<const RuleResearch> &list)
 		{
-			RuleResearch *temp = _game->getMod()->getResearch(j);
-			for (auto& i : temp->getUnlocked())
-			{
-				if (i == rule)
-				{
-					unlockedBy.push_back(j);
-				}
-			}
-			for (auto& i : temp->getDisabled())
-			{
-				if (i == rule)
-				{
-					disabledBy.push_back(j);
-				}
-			}
-			for (auto& i : temp->getReenabled())
-			{
-				if (i == rule)
-				{
-					reenabledBy.push_back(j);
-				}
-			}
-			for (auto& i : temp->getGetOneFree())
-			{
-				if (i == rule)
-				{
-					getForFreeFrom.push_back(j);
-				}
-			}
-			for (auto& itMap : temp->getGetOneFreeProtected())
-			{
-				for (auto& i : itMap.second)
-				{
-					if (i == rule)
-					{
-						getForFreeFrom.push_back(j);
-					}
-				}
-			}
-			if (!Mod::isEmptyRuleName(temp->getLookup()))
-			{
-				if (temp->getLookup() == rule->getName())
-				{
-					lookupOf.push_back(j);
-				}
-			}
-			for (auto& i : temp->getRequirements())
+			for (auto* i : list.get(rule->getId()))
 			{
-				if (i == rule)
-				{
-					requiredByResearch.push_back(j);
-				}
-			}
-			for (auto& i : temp->getDependencies())
-			{
-				if (i == rule)
-				{
-					leadsTo.push_back(j);
-				}
+				names.push_back(i->getName());
 			}
-		}
+		};
+		addNames(unlockedBy, links.unlockedBy);
+		addNames(disabledBy, links.disabledBy);
+		addNames(reenabledBy, links.reenabledBy);
+		addNames(getForFreeFrom, links.getOneFreeFrom);
+		addNames(lookupOf, links.lookupOf);
+		addNames(requiredByResearch, links.requiredBy);
+		addNames(leadsTo, links.leadsTo);
 
 		// 1. item required
 		if (rule->needItem())
@@ -1636,36 +1548,11 @@ void TechTreeViewerState::initLists()
 		}
 
 		// 4. produced by
+		const ItemSources &sources = _game->getMod()->getItemSources();
 		std::vector<std::string> producedBy;
-		for (auto& j : _game->getMod()->getManufactureList())
+		for (auto* i : sources.producedBy.get(rule->getId()))
 		{
-			RuleManufacture* temp = _game->getMod()->getManufacture(j);
-			bool found = false;
-			for (auto& i : temp->getProducedItems())
-			{
-				if (i.first == rule)
-				{
-					producedBy.push_back(j);
-					found = true;
-					break;
-				}
-			}
-			if (!found)
-			{
-				for (auto& itMap : temp->getRandomProducedItems())
-				{
-					for (auto& i : itMap.second)
-					{
-						if (i.first == rule)
-						{
-							producedBy.push_back(j);
-							found = true;
-							break;
-						}
-					}
-					if (found) break;
-				}
-			}
+			producedBy.push_back(i->getName());
 		}
 		if (producedBy.size() > 0)
 		{
@@ -1692,24 +1579,9 @@ void TechTreeViewerState::initLists()
 
 		// 5. spawned by
 		std::vector<std::string> spawnedBy;
-		for (auto& j : _game->getMod()->getResearchList())
+		for (auto* i : sources.spawnedBy.get(rule->getId()))
 		{
-			RuleResearch* temp = _game->getMod()->getResearch(j);
-			if (temp->getSpawnedItem() == rule->getType())
-			{
-				spawnedBy.push_back(j);
-			}
-			else
-			{
-				for (auto& sil : temp->getSpawnedItemList())
-				{
-					if (sil == rule->getType())
-					{
-						spawnedBy.push_back(j);
-						break;
-					}
-				}
-			}
+			spawnedBy.push_back(i->getName());
 		}
 		if (spawnedBy.size() > 0)
 		{
@@ -1806,14 +1678,9 @@ void TechTreeViewerState::initLists()
 
 		// 3. produced by
 		std::vector<std::string> producedBy;
-		for (auto& j : _game->getMod()->getManufactureList())
+		for (auto* i : _game->getMod()->getCraftSources(rule))
 		{
-			RuleManufacture* temp = _game->getMod()->getManufacture(j);
-			if (temp->getProducedCraft() == rule)
-			{
-				producedBy.push_back(j);
-				break;
-			}
+			producedBy.push_back(i->getName());
 		}
 		if (producedBy.size() > 0)
 		{
@@ -2027,4 +1894,43 @@ bool TechTreeViewerState::isDiscoveredCraft(const std::string &topic) const
 	return true;
 }
 
+/**
+ * Gets the translated names of all topics of a kind in upper case,
+ * in the order of their mod lists. They're only translated the first
+ * time, so searching doesn't translate every topic on every key press.
+ * @param topicType Kind of topics.
+ * @return List of names.
+ */
+const std::vector<std::string> &TechTreeViewerState::getSearchNames(TTVMode topicType)
+{
+	auto i = _searchNames.find(topicType);
+	if (i != _searchNames.end())
+	{
+		return i->second;
+	}
+
+	const std::vector<std::string> *topics = nullptr;
+	switch (topicType)
+	{
+	case TTV_RESEARCH: topics = &_game->getMod()->getResearchList(); break;
+	case TTV_MANUFACTURING: topics = &_game->getMod()->getManufactureList(); break;
+	case TTV_FACILITIES: topics = &_game->getMod()->getBaseFacilitiesList(); break;
+	case TTV_ITEMS: topics = &_game->getMod()->getItemsList(); break;
+	case TTV_CRAFTS: topics = &_game->getMod()->getCraftsList(); break;
+	default: break;
+	}
+
+	std::vector<std::string> &names = _searchNames[topicType];
+	if (topics)
+	{
+		names.reserve(topics->size());
+		for (auto& topic : *topics)
+		{
+			names.push_back(tr(topic));
+			Unicode::upperCase(names.back());
+		}
+	}
+	return names;
+}
+
 }
@@ -56,6 +56,7 @@ private:
 	std::unordered_set<std::string> _disabledResearch;
 	std::unordered_set<std::string> _alreadyAvailableResearch, _alreadyAvailableManufacture, _alreadyAvailableFacilities, _alreadyAvailableCrafts;
 	std::unordered_set<std::string> _protectedItems, _alreadyAvailableItems;
+	std::map<TTVMode, std::vector<std::string> > _searchNames;
 	void initLists();
 	void onSelectLeftTopic(Action *action);
 	void onSelectRightTopic(Action *action);
@@ -90,6 +91,8 @@ public:
 	bool isProtectedAndDiscoveredItem(const std::string &topic) const;
 	/// Is given craft discovered/available for both purchase and usage/equipment?
 	bool isDiscoveredCraft(const std::string &topic) const;
+	/// Gets the translated names of all topics of a kind, for searching.
+	const std::vector<std::string> &getSearchNames(TTVMode topicType);
 };
 
 }
@@ -25,8 +25,10 @@
 #include "../Interface/Window.h"
 #include "../Interface/Text.h"
 #include "../Interface/TextList.h"
+#include "../Savegame/SavedGame.h"
 #include "../Savegame/Base.h"
 #include "../Savegame/Transfer.h"
+#include "../Savegame/EventScheduler.h"
 
 namespace OpenXcom
 {
@@ -89,7 +91,7 @@ TransfersState::TransfersState(Base *base) : _base(base)
 	{
 		std::ostringstream ss, ss2;
 		ss << (*i)->getQuantity();
-		ss2 << (*i)->getHours();
+		ss2 << (*i)->getHours(_game->getSavedGame()->getEventScheduler()->getClock());
 		_lstTransfers->addRow(3, (*i)->getName(_game->getLanguage()).c_str(), ss.str().c_str(), ss2.str().c_str());
 	}
 }
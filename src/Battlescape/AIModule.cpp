@@ -34,6 +34,7 @@
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
 #include "../fmath.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -199,6 +200,7 @@ void AIModule::dont_think(BattleAction *action)
  */
 void AIModule::think(BattleAction *action)
 {
+	ProfileScope profile(PROFILE_AI_THINK);
 	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon(false);
@@ -0,0 +1,475 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleReplay.h"
+#include <algorithm>
+#include <map>
+#include <SDL.h>
+#include <yaml-cpp/yaml.h>
+#include "BattlescapeGame.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/RNG.h"
+#include "../Mod/RuleInventory.h"
+#include "../Mod/RuleSkill.h"
+#include "../Savegame/BattleItem.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+const uint32_t FNV_OFFSET = 2166136261u;
+const uint32_t FNV_PRIME = 16777619u;
+
+/**
+ * Mixes an integer into an FNV-1a checksum.
+ */
+void hashValue(uint32_t &hash, int64_t value)
+{
+	for (int i = 0; i < 8; ++i)
+	{
+		hash = (hash ^ (uint8_t)(value >> (i * 8))) * FNV_PRIME;
+	}
+}
+
+/**
+ * Mixes a string into an FNV-1a checksum.
+ */
+void hashValue(uint32_t &hash, const std::string &value)
+{
+	for (char c : value)
+	{
+		hash = (hash ^ (uint8_t)c) * FNV_PRIME;
+	}
+	hash = (hash ^ 0) * FNV_PRIME;
+}
+
+/**
+ * Gets where an item is: who carries it, in which slot,
+ * on which tile, and what ammo is loaded in it.
+ */
+ReplayItem itemState(const BattleItem *item)
+{
+	ReplayItem state;
+	state.id = item->getId();
+	state.owner = item->getOwner() ? item->getOwner()->getId() : -1;
+	state.slot = item->getSlot() ? item->getSlot()->getId() : "";
+	state.x = item->getSlotX();
+	state.y = item->getSlotY();
+	if (item->getTile())
+	{
+		state.tile = item->getTile()->getPosition();
+	}
+	for (int slot = 0; slot < RuleItem::AmmoSlotMax; ++slot)
+	{
+		const BattleItem *ammo = item->getAmmoForSlot(slot);
+		state.ammo[slot] = ammo ? ammo->getId() : -1;
+	}
+	state.fuse = item->getFuseTimer();
+	return state;
+}
+
+}
+
+/**
+ * Compares two item positions.
+ * @param other Other item position.
+ * @return True if they're the same.
+ */
+bool ReplayItem::operator==(const ReplayItem &other) const
+{
+	return id == other.id && owner == other.owner && slot == other.slot && x == other.x && y == other.y && tile == other.tile
+		&& std::equal(ammo, ammo + RuleItem::AmmoSlotMax, other.ammo) && fuse == other.fuse;
+}
+
+/**
+ * Calculates a checksum of everything the player's commands and the AI
+ * can change: the turn, the random seed, and the state of every unit
+ * and item. Two battles with the same checksum played out the same way.
+ * @param save Pointer to the battle.
+ * @return Checksum.
+ */
+uint32_t BattleReplay::hashState(SavedBattleGame *save)
+{
+	uint32_t hash = FNV_OFFSET;
+	hashValue(hash, save->getTurn());
+	hashValue(hash, save->getSide());
+	hashValue(hash, (int64_t)RNG::getSeed());
+	for (const BattleUnit *unit : *save->getUnits())
+	{
+		Position pos = unit->getPosition();
+		hashValue(hash, unit->getId());
+		hashValue(hash, unit->getStatus());
+		hashValue(hash, unit->getFaction());
+		hashValue(hash, pos.x);
+		hashValue(hash, pos.y);
+		hashValue(hash, pos.z);
+		hashValue(hash, unit->getDirection());
+		hashValue(hash, unit->getTurretDirection());
+		hashValue(hash, unit->getHealth());
+		hashValue(hash, unit->getStunlevel());
+		hashValue(hash, unit->getFatalWounds());
+		hashValue(hash, unit->getTimeUnits());
+		hashValue(hash, unit->getEnergy());
+		hashValue(hash, unit->getMorale());
+		hashValue(hash, unit->getMana());
+	}
+	for (const BattleItem *item : *save->getItems())
+	{
+		hashValue(hash, item->getId());
+		hashValue(hash, item->getOwner() ? item->getOwner()->getId() : -1);
+		hashValue(hash, item->getSlot() ? item->getSlot()->getId() : "");
+		if (item->getTile())
+		{
+			Position pos = item->getTile()->getPosition();
+			hashValue(hash, pos.x);
+			hashValue(hash, pos.y);
+			hashValue(hash, pos.z);
+		}
+		hashValue(hash, item->getAmmoQuantity());
+		hashValue(hash, item->getFuseTimer());
+	}
+	return hash;
+}
+
+/**
+ * Creates an empty replay.
+ * @param name Name of the replay, used for its files in the user folder.
+ */
+BattleReplay::BattleReplay(const std::string &name) : _name(name), _recording(false), _playing(false), _diverged(false), _seed(0), _startHash(0), _endHash(0), _next(0), _startTime(0), _inventoryHash(0)
+{
+}
+
+/**
+ * Starts recording. The starting state itself has to be saved
+ * by the caller to getSaveFile() right before.
+ * @param save Pointer to the battle.
+ */
+void BattleReplay::startRecording(SavedBattleGame *save)
+{
+	_seed = RNG::getSeed();
+	_startHash = hashState(save);
+	_events.clear();
+	_recording = true;
+	Log(LOG_INFO) << "Recording battle replay " << _name;
+}
+
+/**
+ * Adds a command to the recording, along with the state of
+ * the battle right before it was given.
+ * @param type Type of command.
+ * @param position Map position clicked, if any.
+ * @param action Current action.
+ * @param save Pointer to the battle.
+ * @param modifiers Modifier keys held down, as ReplayEvent::Modifiers.
+ */
+void BattleReplay::record(ReplayEventType type, Position position, const BattleAction &action, SavedBattleGame *save, int modifiers)
+{
+	ReplayEvent event;
+	event.type = type;
+	event.position = position;
+	event.selected = save->getSelectedUnit() ? save->getSelectedUnit()->getId() : -1;
+	event.actor = action.actor ? action.actor->getId() : -1;
+	event.weapon = action.weapon ? action.weapon->getId() : -1;
+	event.action = action.type;
+	event.value = action.value;
+	event.reserved = save->getTUReserved();
+	event.flags = (action.targeting ? ReplayEvent::TARGETING : 0)
+		| (action.sprayTargeting ? ReplayEvent::SPRAY_TARGETING : 0)
+		| (action.run ? ReplayEvent::RUN : 0)
+		| (action.strafe ? ReplayEvent::STRAFE : 0)
+		| (action.sneak ? ReplayEvent::SNEAK : 0)
+		| (action.kneel ? ReplayEvent::KNEEL : 0)
+		| (save->getKneelReserved() ? ReplayEvent::KNEEL_RESERVED : 0);
+	event.modifiers = modifiers;
+	event.cost[0] = action.Time;
+	event.cost[1] = action.Energy;
+	event.cost[2] = action.Morale;
+	event.cost[3] = action.Health;
+	event.cost[4] = action.Stun;
+	event.cost[5] = action.Mana;
+	event.skill = action.skillRules ? action.skillRules->getType() : "";
+	event.result = action.result;
+	event.hash = hashState(save);
+	_events.push_back(event);
+}
+
+/**
+ * Remembers where every item is and how many time units every unit has,
+ * so closeInventory() can record what the player changed.
+ * @param save Pointer to the battle.
+ */
+void BattleReplay::openInventory(SavedBattleGame *save)
+{
+	_inventory.clear();
+	_inventoryTimeUnits.clear();
+	for (const BattleItem *item : *save->getItems())
+	{
+		_inventory.push_back(itemState(item));
+	}
+	for (const BattleUnit *unit : *save->getUnits())
+	{
+		_inventoryTimeUnits.push_back(std::make_pair(unit->getId(), unit->getTimeUnits()));
+	}
+	_inventoryHash = hashState(save);
+}
+
+/**
+ * Adds the inventory screen to the recording as a single command:
+ * the items that moved and the time units that were spent for it.
+ * The command is checked against the battle as it was when the
+ * inventory was opened.
+ * @param save Pointer to the battle.
+ */
+void BattleReplay::closeInventory(SavedBattleGame *save)
+{
+	std::map<int, const ReplayItem*> before;
+	for (const ReplayItem &state : _inventory)
+	{
+		before[state.id] = &state;
+	}
+	ReplayEvent event;
+	event.type = REPLAY_INVENTORY;
+	event.selected = save->getSelectedUnit() ? save->getSelectedUnit()->getId() : -1;
+	event.hash = _inventoryHash;
+	for (const BattleItem *item : *save->getItems())
+	{
+		ReplayItem state = itemState(item);
+		auto i = before.find(state.id);
+		if (i == before.end() || *i->second != state)
+		{
+			event.items.push_back(state);
+		}
+	}
+	size_t n = 0;
+	for (const BattleUnit *unit : *save->getUnits())
+	{
+		if (n >= _inventoryTimeUnits.size() || _inventoryTimeUnits[n] != std::make_pair(unit->getId(), unit->getTimeUnits()))
+		{
+			event.timeUnits.push_back(std::make_pair(unit->getId(), unit->getTimeUnits()));
+		}
+		++n;
+	}
+	_events.push_back(event);
+	_inventory.clear();
+	_inventoryTimeUnits.clear();
+}
+
+/**
+ * Saves the recorded commands to <name>.replay in the user folder,
+ * along with the checksum of the battle as it ended.
+ * @param save Pointer to the battle.
+ */
+void BattleReplay::save(SavedBattleGame *save) const
+{
+	YAML::Node node;
+	node["save"] = getSaveFile();
+	node["seed"] = _seed;
+	node["startHash"] = _startHash;
+	node["endHash"] = hashState(save);
+	for (const ReplayEvent &event : _events)
+	{
+		YAML::Node e;
+		e.SetStyle(YAML::EmitterStyle::Flow);
+		e["type"] = (int)event.type;
+		e["pos"] = event.position;
+		e["selected"] = event.selected;
+		e["actor"] = event.actor;
+		e["weapon"] = event.weapon;
+		e["action"] = event.action;
+		e["value"] = event.value;
+		e["reserved"] = event.reserved;
+		e["flags"] = event.flags;
+		e["modifiers"] = event.modifiers;
+		for (int cost : event.cost)
+		{
+			e["cost"].push_back(cost);
+		}
+		if (!event.skill.empty())
+		{
+			e["skill"] = event.skill;
+		}
+		if (!event.result.empty())
+		{
+			e["result"] = event.result;
+		}
+		e["hash"] = event.hash;
+		for (const ReplayItem &item : event.items)
+		{
+			YAML::Node i;
+			i["id"] = item.id;
+			i["owner"] = item.owner;
+			i["slot"] = item.slot;
+			i["x"] = item.x;
+			i["y"] = item.y;
+			i["tile"] = item.tile;
+			for (int ammo : item.ammo)
+			{
+				i["ammo"].push_back(ammo);
+			}
+			i["fuse"] = item.fuse;
+			e["items"].push_back(i);
+		}
+		for (const auto &tu : event.timeUnits)
+		{
+			YAML::Node t;
+			t.push_back(tu.first);
+			t.push_back(tu.second);
+			e["timeUnits"].push_back(t);
+		}
+		node["events"].push_back(e);
+	}
+	YAML::Emitter out;
+	out << node;
+	std::string filename = Options::getMasterUserFolder() + _name + ".replay";
+	if (CrossPlatform::writeFile(filename, out.c_str()))
+	{
+		Log(LOG_INFO) << "Battle replay saved to " << filename << " (" << _events.size() << " commands)";
+	}
+}
+
+/**
+ * Loads <name>.replay from the user folder and starts playing it back.
+ * The battle must already be loaded from getSaveFile().
+ * @param save Pointer to the battle.
+ * @return True if the replay was loaded.
+ */
+bool BattleReplay::startPlayback(SavedBattleGame *save)
+{
+	std::string filename = Options::getMasterUserFolder() + _name + ".replay";
+	try
+	{
+		YAML::Node node = YAML::Load(*CrossPlatform::readFile(filename));
+		_seed = node["seed"].as<uint64_t>();
+		_startHash = node["startHash"].as<uint32_t>();
+		_endHash = node["endHash"].as<uint32_t>();
+		_events.clear();
+		for (const YAML::Node &e : node["events"])
+		{
+			ReplayEvent event;
+			event.type = (ReplayEventType)e["type"].as<int>();
+			event.position = e["pos"].as<Position>();
+			event.selected = e["selected"].as<int>();
+			event.actor = e["actor"].as<int>();
+			event.weapon = e["weapon"].as<int>();
+			event.action = e["action"].as<int>();
+			event.value = e["value"].as<int>();
+			event.reserved = e["reserved"].as<int>();
+			event.flags = e["flags"].as<int>();
+			event.modifiers = e["modifiers"].as<int>();
+			for (size_t i = 0; i < e["cost"].size() && i < 6; ++i)
+			{
+				event.cost[i] = e["cost"][i].as<int>();
+			}
+			event.skill = e["skill"].as<std::string>("");
+			event.result = e["result"].as<std::string>("");
+			event.hash = e["hash"].as<uint32_t>();
+			for (const YAML::Node &i : e["items"])
+			{
+				ReplayItem item;
+				item.id = i["id"].as<int>();
+				item.owner = i["owner"].as<int>();
+				item.slot = i["slot"].as<std::string>();
+				item.x = i["x"].as<int>();
+				item.y = i["y"].as<int>();
+				item.tile = i["tile"].as<Position>();
+				for (size_t j = 0; j < i["ammo"].size() && j < RuleItem::AmmoSlotMax; ++j)
+				{
+					item.ammo[j] = i["ammo"][j].as<int>();
+				}
+				item.fuse = i["fuse"].as<int>();
+				event.items.push_back(item);
+			}
+			for (const YAML::Node &t : e["timeUnits"])
+			{
+				event.timeUnits.push_back(std::make_pair(t[0].as<int>(), t[1].as<int>()));
+			}
+			_events.push_back(event);
+		}
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << filename << ": " << e.what();
+		return false;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << filename << ": " << e.what();
+		return false;
+	}
+
+	RNG::setSeed(_seed);
+	if (hashState(save) != _startHash)
+	{
+		Log(LOG_WARNING) << "Battle replay " << _name << ": the loaded battle doesn't match the recorded one";
+		_diverged = true;
+	}
+	_playing = true;
+	_next = 0;
+	_startTime = SDL_GetTicks();
+	Log(LOG_INFO) << "Playing battle replay " << _name << " (" << _events.size() << " commands)";
+	return true;
+}
+
+/**
+ * Gets the next command to play back, checking first that the
+ * battle is in the same state as when it was recorded.
+ * Only the first divergence is reported, as all the rest follows from it.
+ * @param save Pointer to the battle.
+ * @return Next command, or nullptr when there are none left.
+ */
+const ReplayEvent *BattleReplay::next(SavedBattleGame *save)
+{
+	if (_next >= _events.size())
+	{
+		return nullptr;
+	}
+	const ReplayEvent *event = &_events[_next++];
+	if (!_diverged && hashState(save) != event->hash)
+	{
+		Log(LOG_WARNING) << "Battle replay " << _name << ": diverged before command " << _next << " of " << _events.size() << " on turn " << save->getTurn();
+		_diverged = true;
+	}
+	return event;
+}
+
+/**
+ * Stops the playback, compares the final state with the
+ * recorded one and logs how long the whole battle took.
+ * @param save Pointer to the battle.
+ */
+void BattleReplay::finish(SavedBattleGame *save)
+{
+	if (!_playing)
+	{
+		return;
+	}
+	_playing = false;
+	bool match = hashState(save) == _endHash && !_diverged;
+	Log(LOG_INFO) << "Battle replay " << _name << " finished: " << _next << " of " << _events.size() << " commands in " << (SDL_GetTicks() - _startTime) << " ms, "
+		<< (match ? "final state matches" : "final state differs");
+}
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <SDL_types.h>
+#include "Position.h"
+#include "../Mod/RuleItem.h"
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+struct BattleAction;
+
+enum ReplayEventType { REPLAY_PRIMARY, REPLAY_SECONDARY, REPLAY_NON_TARGET, REPLAY_LAUNCH, REPLAY_PSI, REPLAY_MOVE_UP, REPLAY_MOVE_DOWN, REPLAY_KNEEL, REPLAY_END_TURN, REPLAY_CANCEL, REPLAY_INVENTORY };
+
+/**
+ * Where an item was left when the player closed the inventory.
+ */
+struct ReplayItem
+{
+	int id = -1, owner = -1;
+	std::string slot;
+	int x = 0, y = 0;
+	Position tile = Position(-1, -1, -1);
+	int ammo[RuleItem::AmmoSlotMax] = { -1, -1, -1, -1 };
+	int fuse = -1;
+
+	bool operator==(const ReplayItem &other) const;
+	bool operator!=(const ReplayItem &other) const { return !(*this == other); }
+};
+
+/**
+ * A single command given by the player, with the current
+ * action as the menus and buttons left it at the time.
+ */
+struct ReplayEvent
+{
+	enum Flags { TARGETING = 1, SPRAY_TARGETING = 2, RUN = 4, STRAFE = 8, SNEAK = 16, KNEEL = 32, KNEEL_RESERVED = 64 };
+	enum Modifiers { CTRL = 1, ALT = 2, SHIFT = 4 };
+
+	ReplayEventType type = REPLAY_PRIMARY;
+	Position position;
+	int selected = -1, actor = -1, weapon = -1;
+	int action = 0, value = 0, reserved = 0;
+	int flags = 0, modifiers = 0;
+	int cost[6] = {};
+	std::string skill, result;
+	uint32_t hash = 0;
+	std::vector<ReplayItem> items;
+	std::vector<std::pair<int, int> > timeUnits;
+};
+
+/**
+ * Records the commands given during a battle, together with the
+ * starting save and random seed, and plays them back later
+ * to reproduce the exact same battle.
+ */
+class BattleReplay
+{
+private:
+	std::string _name;
+	bool _recording, _playing, _diverged;
+	uint64_t _seed;
+	uint32_t _startHash, _endHash;
+	std::vector<ReplayEvent> _events;
+	size_t _next;
+	Uint32 _startTime;
+	std::vector<ReplayItem> _inventory;
+	std::vector<std::pair<int, int> > _inventoryTimeUnits;
+	uint32_t _inventoryHash;
+public:
+	/// Calculates a checksum of the battle state.
+	static uint32_t hashState(SavedBattleGame *save);
+	/// Creates an empty replay.
+	BattleReplay(const std::string &name);
+	/// Gets the replay name.
+	const std::string &getName() const { return _name; }
+	/// Gets the save file with the starting state.
+	std::string getSaveFile() const { return _name + ".sav"; }
+	/// Starts recording from the current battle state.
+	void startRecording(SavedBattleGame *save);
+	/// Adds a command to the recording.
+	void record(ReplayEventType type, Position position, const BattleAction &action, SavedBattleGame *save, int modifiers);
+	/// Remembers the items as they were when the inventory was opened.
+	void openInventory(SavedBattleGame *save);
+	/// Adds the items moved in the inventory to the recording.
+	void closeInventory(SavedBattleGame *save);
+	/// Saves the recording.
+	void save(SavedBattleGame *save) const;
+	/// Loads a recording and starts playing it back.
+	bool startPlayback(SavedBattleGame *save);
+	/// Is the replay being recorded?
+	bool isRecording() const { return _recording; }
+	/// Is the replay being played back?
+	bool isPlaying() const { return _playing; }
+	/// Gets the next command to play back.
+	const ReplayEvent *next(SavedBattleGame *save);
+	/// Stops the playback and checks the final state.
+	void finish(SavedBattleGame *save);
+};
+
+}
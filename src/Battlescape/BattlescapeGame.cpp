@@ -16,6 +16,7 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <map>
 #include <sstream>
 #include "BattlescapeGame.h"
 #include "BattlescapeState.h"
@@ -194,7 +195,7 @@ bool BattleActionCost::spendTU(std::string *message)
 BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) :
 	_save(save), _parentState(parentState),
 	_playerPanicHandled(true), _AIActionCounter(0), _AISecondMove(false), _playedAggroSound(false),
-	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false)
+	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false), _replay(nullptr)
 {
 	if (_save->isPreview())
 	{
@@ -223,6 +224,7 @@ BattlescapeGame::~BattlescapeGame()
 		delete *i;
 	}
 	cleanupDeleted();
+	delete _replay;
 }
 
 /**
@@ -3606,6 +3608,364 @@ void BattlescapeGame::autoEndBattle()
 	}
 }
 
+/**
+ * Saves the battle as it is now and starts recording every
+ * command the player gives, so it can be played back later.
+ */
+void BattlescapeGame::startReplayRecording()
+{
+	delete _replay;
+	_replay = new BattleReplay("replay");
+	try
+	{
+		_parentState->getGame()->getSavedGame()->save(_replay->getSaveFile(), getMod());
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Battle replay not recorded: " << e.what();
+		delete _replay;
+		_replay = nullptr;
+		return;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Battle replay not recorded: " << e.what();
+		delete _replay;
+		_replay = nullptr;
+		return;
+	}
+	_replay->startRecording(_save);
+}
+
+/**
+ * Starts playing back a recorded battle. The battle itself
+ * must have been loaded from the replay's save file.
+ * @param name Name of the replay.
+ */
+void BattlescapeGame::startReplayPlayback(const std::string &name)
+{
+	delete _replay;
+	_replay = new BattleReplay(name);
+	if (!_replay->startPlayback(_save))
+	{
+		delete _replay;
+		_replay = nullptr;
+	}
+}
+
+/**
+ * Records a command given by the player, if recording.
+ * @param type Type of command.
+ * @param pos Map position clicked, if any.
+ */
+void BattlescapeGame::recordReplay(ReplayEventType type, Position pos)
+{
+	if (!_replay || !_replay->isRecording())
+	{
+		return;
+	}
+	if (type == REPLAY_NON_TARGET && (_currentAction.targeting || _currentAction.type == BA_NONE))
+	{
+		return;
+	}
+	Game *game = _parentState->getGame();
+	int modifiers = (game->isCtrlPressed(true) ? ReplayEvent::CTRL : 0)
+		| (game->isAltPressed(true) ? ReplayEvent::ALT : 0)
+		| (game->isShiftPressed(true) ? ReplayEvent::SHIFT : 0);
+	_replay->record(type, pos, _currentAction, _save, modifiers);
+}
+
+/**
+ * Remembers the items as they are before the player
+ * opens the inventory, if recording.
+ */
+void BattlescapeGame::recordInventoryOpened()
+{
+	if (_replay && _replay->isRecording())
+	{
+		_replay->openInventory(_save);
+	}
+}
+
+/**
+ * Records what the player changed in the inventory, if recording.
+ */
+void BattlescapeGame::recordInventoryClosed()
+{
+	if (_replay && _replay->isRecording())
+	{
+		_replay->closeInventory(_save);
+	}
+}
+
+/**
+ * Runs the battle as fast as it goes for a frame's worth of time:
+ * states are handled back to back without waiting for their timers
+ * and recorded commands are given as soon as the player could have.
+ * Stops whenever another screen comes up over the battlescape.
+ * With replayBattleNoRender, it doesn't stop to draw a frame at all.
+ */
+void BattlescapeGame::thinkReplay()
+{
+	Game *game = _parentState->getGame();
+	Uint32 start = SDL_GetTicks();
+	while (isReplaying() && game->isState(_parentState) && (Options::replayBattleNoRender || SDL_GetTicks() - start < 100))
+	{
+		if (_states.empty())
+		{
+			think();
+		}
+		if (!_states.empty())
+		{
+			handleState();
+		}
+		else if (_save->getSide() == FACTION_PLAYER && _playerPanicHandled)
+		{
+			const ReplayEvent *event = _replay->next(_save);
+			if (event)
+			{
+				playReplayEvent(*event);
+			}
+			else
+			{
+				stopReplay();
+			}
+		}
+	}
+}
+
+/**
+ * Puts the current action back the way it was recorded and
+ * repeats the player's command with it.
+ * @param event Recorded command.
+ */
+void BattlescapeGame::playReplayEvent(const ReplayEvent &event)
+{
+	auto findUnit = [&](int id) -> BattleUnit*
+	{
+		for (BattleUnit *unit : *_save->getUnits())
+		{
+			if (unit->getId() == id)
+				return unit;
+		}
+		return nullptr;
+	};
+	auto findItem = [&](int id) -> BattleItem*
+	{
+		for (BattleItem *item : *_save->getItems())
+		{
+			if (item->getId() == id)
+				return item;
+		}
+		return nullptr;
+	};
+
+	_save->setSelectedUnit(findUnit(event.selected));
+	if (event.type == REPLAY_INVENTORY)
+	{
+		playReplayInventory(event);
+		return;
+	}
+	_save->setTUReserved((BattleActionType)event.reserved);
+	_save->setKneelReserved(event.flags & ReplayEvent::KNEEL_RESERVED);
+
+	_currentAction.type = (BattleActionType)event.action;
+	_currentAction.actor = findUnit(event.actor);
+	_currentAction.weapon = findItem(event.weapon);
+	_currentAction.skillRules = event.skill.empty() ? nullptr : getMod()->getSkill(event.skill);
+	_currentAction.value = event.value;
+	_currentAction.result = event.result;
+	_currentAction.targeting = event.flags & ReplayEvent::TARGETING;
+	_currentAction.sprayTargeting = event.flags & ReplayEvent::SPRAY_TARGETING;
+	_currentAction.run = event.flags & ReplayEvent::RUN;
+	_currentAction.strafe = event.flags & ReplayEvent::STRAFE;
+	_currentAction.sneak = event.flags & ReplayEvent::SNEAK;
+	_currentAction.kneel = event.flags & ReplayEvent::KNEEL;
+	_currentAction.Time = event.cost[0];
+	_currentAction.Energy = event.cost[1];
+	_currentAction.Morale = event.cost[2];
+	_currentAction.Health = event.cost[3];
+	_currentAction.Stun = event.cost[4];
+	_currentAction.Mana = event.cost[5];
+
+	// the modifier keys are played back through the touch button flags
+	Game *game = _parentState->getGame();
+	bool ctrl = game->getCtrlPressedFlag(), alt = game->getAltPressedFlag(), shift = game->getShiftPressedFlag();
+	game->setCtrlPressedFlag(event.modifiers & ReplayEvent::CTRL);
+	game->setAltPressedFlag(event.modifiers & ReplayEvent::ALT);
+	game->setShiftPressedFlag(event.modifiers & ReplayEvent::SHIFT);
+
+	BattleUnit *selected = _save->getSelectedUnit();
+	switch (event.type)
+	{
+	case REPLAY_PRIMARY:
+		primaryAction(event.position);
+		break;
+	case REPLAY_SECONDARY:
+		if (selected)
+			secondaryAction(event.position);
+		break;
+	case REPLAY_NON_TARGET:
+		handleNonTargetAction();
+		break;
+	case REPLAY_LAUNCH:
+		launchAction();
+		break;
+	case REPLAY_PSI:
+		psiButtonAction();
+		break;
+	case REPLAY_MOVE_UP:
+	case REPLAY_MOVE_DOWN:
+		if (selected)
+		{
+			cancelAllActions();
+			moveUpDown(selected, event.type == REPLAY_MOVE_UP ? Pathfinding::DIR_UP : Pathfinding::DIR_DOWN);
+		}
+		break;
+	case REPLAY_KNEEL:
+		if (selected)
+			kneel(selected);
+		break;
+	case REPLAY_END_TURN:
+		requestEndTurn(false);
+		break;
+	case REPLAY_CANCEL:
+		cancelCurrentAction();
+		break;
+	case REPLAY_INVENTORY:
+		break;
+	}
+
+	game->setCtrlPressedFlag(ctrl);
+	game->setAltPressedFlag(alt);
+	game->setShiftPressedFlag(shift);
+}
+
+/**
+ * Repeats what the player did in the inventory screen: moves the
+ * recorded items back where they were left, spends the same time units,
+ * then updates the battle the same way closing the screen does.
+ * @param event Recorded inventory command.
+ */
+void BattlescapeGame::playReplayInventory(const ReplayEvent &event)
+{
+	std::map<int, BattleUnit*> units;
+	for (BattleUnit *unit : *_save->getUnits())
+	{
+		units[unit->getId()] = unit;
+	}
+	std::map<int, BattleItem*> items;
+	for (BattleItem *item : *_save->getItems())
+	{
+		items[item->getId()] = item;
+	}
+	auto findUnit = [&](int id) -> BattleUnit* { auto i = units.find(id); return i != units.end() ? i->second : nullptr; };
+	auto findItem = [&](int id) -> BattleItem* { auto i = items.find(id); return i != items.end() ? i->second : nullptr; };
+
+	cancelAllActions();
+	TileEngine *te = _save->getTileEngine();
+	// unload everything that changed first, so the ammo is free to move
+	for (const ReplayItem &state : event.items)
+	{
+		BattleItem *item = findItem(state.id);
+		for (int slot = 0; item && slot < RuleItem::AmmoSlotMax; ++slot)
+		{
+			BattleItem *ammo = item->getAmmoForSlot(slot);
+			if ((ammo ? ammo->getId() : -1) != state.ammo[slot])
+			{
+				item->setAmmoForSlot(slot, nullptr);
+			}
+		}
+	}
+	for (const ReplayItem &state : event.items)
+	{
+		BattleItem *item = findItem(state.id);
+		RuleInventory *slot = state.slot.empty() ? nullptr : getMod()->getInventory(state.slot);
+		if (!item || !slot)
+		{
+			continue;
+		}
+		if (slot->getType() == INV_GROUND)
+		{
+			te->itemMoveInventory(_save->getTile(state.tile), nullptr, item, slot, state.x, state.y);
+		}
+		else if (BattleUnit *owner = findUnit(state.owner))
+		{
+			if (item->getOwner() != owner && item->getSlot() && item->getSlot()->getType() != INV_GROUND)
+			{
+				item->moveToOwner(owner);
+			}
+			te->itemMoveInventory(owner->getTile(), owner, item, slot, state.x, state.y);
+		}
+	}
+	for (const ReplayItem &state : event.items)
+	{
+		BattleItem *item = findItem(state.id);
+		if (!item)
+		{
+			continue;
+		}
+		for (int slot = 0; slot < RuleItem::AmmoSlotMax; ++slot)
+		{
+			if (state.ammo[slot] != -1 && !item->getAmmoForSlot(slot))
+			{
+				item->setAmmoForSlot(slot, findItem(state.ammo[slot]));
+			}
+		}
+		item->setFuseTimer(state.fuse);
+	}
+	for (const auto &tu : event.timeUnits)
+	{
+		if (BattleUnit *unit = findUnit(tu.first))
+		{
+			unit->setTimeUnits(tu.second);
+		}
+	}
+
+	// the same as closing InventoryState
+	if (BattleUnit *unit = _save->getSelectedUnit())
+	{
+		te->applyGravity(unit->getTile());
+	}
+	te->calculateLighting(LL_ITEMS);
+	te->recalculateFOV();
+}
+
+/**
+ * Ends the playback and checks the final state. Without drawing
+ * there's nobody watching, so the game quits right away.
+ */
+void BattlescapeGame::stopReplay()
+{
+	_replay->finish(_save);
+	if (Options::replayBattleNoRender)
+	{
+		_parentState->getGame()->quit();
+	}
+}
+
+/**
+ * Called when the battle ends: saves the recording,
+ * or checks the final state of the played back battle.
+ */
+void BattlescapeGame::finishReplay()
+{
+	if (!_replay)
+	{
+		return;
+	}
+	if (_replay->isRecording())
+	{
+		_replay->save(_save);
+	}
+	else if (_replay->isPlaying())
+	{
+		stopReplay();
+	}
+	delete _replay;
+	_replay = nullptr;
+}
+
 /**
  * Processing all battleScripts, defined in the deployment.
  * @par scrirt a vector of BattleScripts.
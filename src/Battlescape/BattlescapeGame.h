@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http:///www.gnu.org/licenses/>.
  */
 #include "Position.h"
+#include "BattleReplay.h"
 #include "../Mod/RuleItem.h"
 #include <string>
 #include <list>
@@ -178,6 +179,7 @@ private:
 
 	SingleRun _endTurnProcessed;
 	SingleRun _triggerProcessed;
+	BattleReplay *_replay;
 
 	/// Ends the turn.
 	void endTurn();
@@ -198,6 +200,12 @@ private:
 	bool scriptSpawnUnit(BattleScript* command);
 	/// Display message fro the battlescript
 	void displayScriptMessage(BattleScript* command);
+	/// Gives a recorded command to the battle.
+	void playReplayEvent(const ReplayEvent &event);
+	/// Moves the items the way the player did in the inventory.
+	void playReplayInventory(const ReplayEvent &event);
+	/// Ends the playback of a recorded battle.
+	void stopReplay();
 public:
 	/// is debug mode enabled in the battlescape?
 	static bool _debugPlay;
@@ -328,6 +336,22 @@ public:
 	std::list<BattleState*> getStates();
 	/// Auto end the battle if conditions are met.
 	void autoEndBattle();
+	/// Saves the battle and starts recording the player's commands.
+	void startReplayRecording();
+	/// Starts playing back a recorded battle.
+	void startReplayPlayback(const std::string &name);
+	/// Is a recorded battle being played back?
+	bool isReplaying() const { return _replay && _replay->isPlaying(); }
+	/// Records a command given by the player.
+	void recordReplay(ReplayEventType type, Position pos = Position(-1, -1, -1));
+	/// Records the opening of the inventory screen.
+	void recordInventoryOpened();
+	/// Records the items moved in the inventory screen.
+	void recordInventoryClosed();
+	/// Plays back recorded commands as fast as possible.
+	void thinkReplay();
+	/// Saves the recording or checks the played back battle.
+	void finishReplay();
 	/// Were all enemies neutralized?
 	bool areAllEnemiesNeutralized() const { return _allEnemiesNeutralized; }
 	/// Resets the flag.
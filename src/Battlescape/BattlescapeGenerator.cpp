@@ -17,7 +17,13 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <SDL_thread.h>
 #include "BattlescapeGenerator.h"
 #include "TileEngine.h"
 #include "Inventory.h"
@@ -915,7 +921,10 @@ void BattlescapeGenerator::run()
 	}
 	_save->setStartingCondition(startingCondition);
 
+	Uint32 phaseStart = SDL_GetTicks();
 	generateMap(script, ruleDeploy->getCustomUfoName(), startingCondition);
+	Uint32 mapTime = SDL_GetTicks() - phaseStart;
+	phaseStart = SDL_GetTicks();
 
 	if (isPreview && ruleDeploy->isHidden())
 	{
@@ -980,7 +989,12 @@ void BattlescapeGenerator::run()
 	// set shade (alien bases are a little darker, sites depend on world shade)
 	_save->setGlobalShade(_worldShade);
 
+	Uint32 deployTime = SDL_GetTicks() - phaseStart;
+	phaseStart = SDL_GetTicks();
 	_save->getTileEngine()->calculateLighting(LL_AMBIENT, TileEngine::invalid, 0, true);
+	Uint32 lightTime = SDL_GetTicks() - phaseStart;
+
+	Log(LOG_INFO) << "Map generator: map " << mapTime << " ms, deployment " << deployTime << " ms, lighting " << lightTime << " ms";
 }
 
 /**
@@ -2165,6 +2179,231 @@ void BattlescapeGenerator::reloadFixedWeaponsByLayout()
 	}
 }
 
+namespace
+{
+
+/**
+ * Jobs shared by the prefetch threads, each thread
+ * takes the next one until there are none left.
+ */
+struct PrefetchQueue
+{
+	std::vector<std::function<void()> > jobs;
+	std::atomic<size_t> next;
+};
+
+/**
+ * Runs prefetch jobs until the queue is empty.
+ * @param data Pointer to the PrefetchQueue.
+ * @return Zero.
+ */
+int prefetchThread(void *data)
+{
+	PrefetchQueue *queue = (PrefetchQueue*)data;
+	for (size_t i = queue->next++; i < queue->jobs.size(); i = queue->next++)
+	{
+		queue->jobs[i]();
+	}
+	return 0;
+}
+
+}
+
+/**
+ * Loads the terrain data and reads the map block files of every terrain
+ * the script could end up using, spread over a few threads.
+ * Nothing here uses the RNG or places anything on the map, so the
+ * generation itself stays exactly the same, it just finds its data ready.
+ * @param script The script being used to generate the map.
+ * @param customUfoName Custom UFO name for the dummy 'addUFO' command.
+ */
+void BattlescapeGenerator::prefetchTerrains(const std::vector<MapScript*> *script, const std::string &customUfoName)
+{
+	Uint32 start = SDL_GetTicks();
+
+	std::set<RuleTerrain*> terrains;
+	auto addTerrain = [&](RuleTerrain *terrain)
+	{
+		if (terrain)
+		{
+			terrains.insert(terrain);
+		}
+	};
+	auto addTerrainName = [&](const std::string &name)
+	{
+		if (!name.empty() && name != "baseTerrain" && name != "globeTerrain")
+		{
+			addTerrain(_mod->getTerrain(name));
+		}
+	};
+	auto addUfo = [&](const std::string &name)
+	{
+		RuleUfo *ufo = name.empty() ? 0 : _mod->getUfo(name);
+		if (ufo)
+		{
+			addTerrain(ufo->getBattlescapeTerrainData());
+		}
+	};
+
+	addTerrain(_terrain);
+	addTerrain(_globeTerrain);
+	if (_ufo)
+	{
+		addTerrain(_ufo->getRules()->getBattlescapeTerrainData());
+	}
+	addUfo(customUfoName);
+	for (const auto* command : *script)
+	{
+		for (const auto& name : command->getRandomAlternateTerrain())
+		{
+			addTerrainName(name);
+		}
+		for (const auto& level : command->getVerticalLevels())
+		{
+			addTerrainName(level.levelTerrain);
+		}
+		addUfo(command->getUFOName());
+	}
+
+	PrefetchQueue queue;
+	queue.next = 0;
+
+	// terrain data, the craft's is left alone as its skin can still change it
+	std::set<MapDataSet*> dataSets;
+	for (auto* terrain : terrains)
+	{
+		for (auto* set : *terrain->getMapDataSets())
+		{
+			// cached sets are still loaded from an earlier battle
+			if (!set->isLoaded() && dataSets.insert(set).second)
+			{
+				_prefetchedDataSets.push_back(set);
+				MCDPatch *patch = _mod->getMCDPatch(set->getName());
+				queue.jobs.push_back([set, patch]()
+				{
+					try
+					{
+						set->loadData(patch);
+					}
+					catch (...)
+					{
+						// leave it for the generator to load again and report
+						set->unloadData();
+					}
+				});
+			}
+		}
+	}
+
+	// map blocks, each one gets its own slot so the threads never share anything
+	if (_craftRules)
+	{
+		addTerrain(_craftRules->getBattlescapeTerrainData());
+	}
+	std::vector<std::string> files;
+	for (auto* terrain : terrains)
+	{
+		for (auto* block : *terrain->getMapBlocks())
+		{
+			for (const std::string &filename : { "MAPS/" + block->getName() + ".MAP", "ROUTES/" + block->getName() + ".RMP" })
+			{
+				if (_prefetchedFiles.find(filename) == _prefetchedFiles.end() && FileMap::fileExists(filename))
+				{
+					_prefetchedFiles[filename];
+					files.push_back(filename);
+				}
+			}
+		}
+	}
+	for (const std::string &filename : files)
+	{
+		std::string *data = &_prefetchedFiles[filename];
+		queue.jobs.push_back([filename, data]()
+		{
+			try
+			{
+				std::ostringstream ss;
+				ss << FileMap::getIStream(filename)->rdbuf();
+				*data = ss.str();
+			}
+			catch (...)
+			{
+				// read it again later, when the error can be reported properly
+				data->clear();
+			}
+		});
+	}
+
+	size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+	threadCount = std::min(threadCount, queue.jobs.size());
+	std::vector<SDL_Thread*> threads;
+	for (size_t i = 1; i < threadCount; ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(prefetchThread, (void*)&queue);
+		if (thread != 0)
+		{
+			threads.push_back(thread);
+		}
+	}
+	// this thread works too, and finishes everything if no others could start
+	prefetchThread(&queue);
+	for (auto thread : threads)
+	{
+		SDL_WaitThread(thread, 0);
+	}
+
+	// anything that failed gets read the normal way
+	for (auto i = _prefetchedFiles.begin(); i != _prefetchedFiles.end();)
+	{
+		if (i->second.empty())
+		{
+			i = _prefetchedFiles.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	Log(LOG_INFO) << "Map generator: prefetched " << dataSets.size() << " terrain sets and " << _prefetchedFiles.size() << " map files from " << terrains.size() << " terrains on " << (threads.size() + 1) << " threads in " << (SDL_GetTicks() - start) << " ms";
+}
+
+/**
+ * Opens a MAP or RMP file. Files read ahead by prefetchTerrains()
+ * come from memory, everything else from the file system.
+ * @param filename Relative path of the file.
+ * @return Stream with the file contents.
+ */
+std::unique_ptr<std::istream> BattlescapeGenerator::openMapFile(const std::string &filename)
+{
+	auto i = _prefetchedFiles.find(filename);
+	if (i != _prefetchedFiles.end())
+	{
+		// blocks can be placed more than once, so keep the data
+		return std::unique_ptr<std::istream>(new std::istringstream(i->second));
+	}
+	return FileMap::getIStream(filename);
+}
+
+/**
+ * Frees the prefetched files, and hands the prefetched terrain data
+ * that the generated map didn't end up using over to the cache.
+ */
+void BattlescapeGenerator::releasePrefetched()
+{
+	std::vector<MapDataSet*> *used = _save->getMapDataSets();
+	for (auto* set : _prefetchedDataSets)
+	{
+		if (std::find(used->begin(), used->end(), set) == used->end())
+		{
+			// no battle uses it, so it only goes to the cache
+			_mod->releaseMapDataSet(set);
+		}
+	}
+	_prefetchedDataSets.clear();
+	_prefetchedFiles.clear();
+}
+
 /**
  * Loads an XCom format MAP file into the tiles of the battlegame.
  * @param mapblock Pointer to MapBlock.
@@ -2187,7 +2426,7 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, int zo
 	unsigned int terrainObjectID;
 
 	// Load file
-	auto mapFile = FileMap::getIStream(filename);
+	auto mapFile = openMapFile(filename);
 
 	mapFile->read((char*)&size, sizeof(size));
 	sizey = (int)size[0];
@@ -2404,7 +2643,7 @@ void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int z
 	unsigned char value[24];
 	std::string filename = "ROUTES/" + mapblock->getName() +".RMP";
 	// Load file
-	auto mapFile = FileMap::getIStream(filename);
+	auto mapFile = openMapFile(filename);
 
 	size_t nodeOffset = _save->getNodes()->size();
 	std::vector<int> badNodes;
@@ -2506,7 +2745,7 @@ int BattlescapeGenerator::loadExtraTerrain(RuleTerrain *terrain)
 
 		for (const auto& i : *terrain->getMapDataSets())
 		{
-			i->loadData(_game->getMod()->getMCDPatch(i->getName()));
+			_game->getMod()->loadMapDataSet(i);
 			_save->getMapDataSets()->push_back(i);
 		}
 
@@ -2747,16 +2986,6 @@ void BattlescapeGenerator::generateMap(const std::vector<MapScript*> *script, co
 	// create an array to track command success/failure
 	std::map<int, bool> conditionals;
 
-	// Load in the default terrain data
-	for (std::vector<MapDataSet*>::iterator i = _terrain->getMapDataSets()->begin(); i != _terrain->getMapDataSets()->end(); ++i)
-	{
-		(*i)->loadData(_game->getMod()->getMCDPatch((*i)->getName()));
-		_save->getMapDataSets()->push_back(*i);
-		mapDataSetIDOffset++;
-	}
-
-	_loadedTerrains[_terrain] = 0;
-
 	RuleTerrain* ufoTerrain = 0;
 	std::string consolidatedUfoType;
 	// lets generate the map now and store it inside the tile objects
@@ -2773,6 +3002,19 @@ void BattlescapeGenerator::generateMap(const std::vector<MapScript*> *script, co
 		}
 	}
 
+	// read everything the script might need up front, in parallel
+	prefetchTerrains(script, customUfoName);
+
+	// Load in the default terrain data
+	for (std::vector<MapDataSet*>::iterator i = _terrain->getMapDataSets()->begin(); i != _terrain->getMapDataSets()->end(); ++i)
+	{
+		_game->getMod()->loadMapDataSet(*i);
+		_save->getMapDataSets()->push_back(*i);
+		mapDataSetIDOffset++;
+	}
+
+	_loadedTerrains[_terrain] = 0;
+
 	// this mission type is "hard-coded" in terms of map layout
 	uint64_t seed = RNG::getSeed();
 	_baseTerrain = _terrain;
@@ -3202,7 +3444,7 @@ void BattlescapeGenerator::generateMap(const std::vector<MapScript*> *script, co
 	{
 		for (std::vector<MapDataSet*>::iterator i = ufoTerrain->getMapDataSets()->begin(); i != ufoTerrain->getMapDataSets()->end(); ++i)
 		{
-			(*i)->loadData(_game->getMod()->getMCDPatch((*i)->getName()));
+			_game->getMod()->loadMapDataSet(*i);
 			_save->getMapDataSets()->push_back(*i);
 			craftDataSetIDOffset++;
 		}
@@ -3228,7 +3470,7 @@ void BattlescapeGenerator::generateMap(const std::vector<MapScript*> *script, co
 		_craftRules->getBattlescapeTerrainData()->refreshMapDataSets(_craft->getSkinIndex(), _game->getMod()); // change skin if needed
 		for (std::vector<MapDataSet*>::iterator i = _craftRules->getBattlescapeTerrainData()->getMapDataSets()->begin(); i != _craftRules->getBattlescapeTerrainData()->getMapDataSets()->end(); ++i)
 		{
-			(*i)->loadData(_game->getMod()->getMCDPatch((*i)->getName()));
+			_game->getMod()->loadMapDataSet(*i);
 			_save->getMapDataSets()->push_back(*i);
 		}
 		loadMAP(craftMap, _craftPos.x * 10, _craftPos.y * 10, _craftZ, _craftRules->getBattlescapeTerrainData(), mapDataSetIDOffset + craftDataSetIDOffset, _craftRules->isMapVisible(), true);
@@ -3277,6 +3519,8 @@ void BattlescapeGenerator::generateMap(const std::vector<MapScript*> *script, co
 	{
 		RNG::setSeed(seed);
 	}
+
+	releasePrefetched();
 }
 
 /**
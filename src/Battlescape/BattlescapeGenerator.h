@@ -18,6 +18,9 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <vector>
+#include <map>
+#include <memory>
+#include <istream>
 #include "../Mod/RuleTerrain.h"
 #include "../Mod/MapScript.h"
 
@@ -93,6 +96,8 @@ private:
 	std::vector<VerticalLevel> _verticalLevels;
 	std::map<RuleTerrain*, int> _loadedTerrains;
 	std::vector<std::pair<MapBlock*, Position> > _verticalLevelSegments;
+	std::map<std::string, std::string> _prefetchedFiles;
+	std::vector<MapDataSet*> _prefetchedDataSets;
 
 	/// sets the map size and associated vars
 	void init(bool resetTerrain);
@@ -111,6 +116,12 @@ private:
 	/// Places an item on a soldier based on equipment layout.
 	bool placeItemByLayout(BattleItem *item, const std::vector<BattleItem*> &itemList);
 	void reloadFixedWeaponsByLayout();
+	/// Loads all the terrains and map blocks the script could use in parallel.
+	void prefetchTerrains(const std::vector<MapScript*> *script, const std::string &customUfoName);
+	/// Opens a MAP or RMP file, from the prefetched ones if possible.
+	std::unique_ptr<std::istream> openMapFile(const std::string &filename);
+	/// Frees the prefetched data that wasn't used.
+	void releasePrefetched();
 	/// Loads an XCom MAP file.
 	int loadMAP(MapBlock *mapblock, int xoff, int yoff, int zoff, RuleTerrain *terrain, int objectIDOffset, bool discovered = false, bool craft = false, int ufoIndex = -1);
 	/// Loads an XCom RMP file.
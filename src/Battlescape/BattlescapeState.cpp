@@ -52,6 +52,7 @@
 #include "../Engine/Screen.h"
 #include "../Engine/Sound.h"
 #include "../Engine/Action.h"
+#include "../Engine/Benchmark.h"
 #include "../Engine/Script.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Timer.h"
@@ -826,6 +827,15 @@ void BattlescapeState::init()
 			_battleGame->setupCursor();
 			_map->getCamera()->centerOnPosition(_save->getSelectedUnit()->getPosition());
 		}
+		if (!Options::replayBattle.empty())
+		{
+			_battleGame->startReplayPlayback(Options::replayBattle);
+			Options::replayBattle = "";
+		}
+		else if (Options::recordBattleReplay && !_save->isPreview())
+		{
+			_battleGame->startReplayRecording();
+		}
 		_firstInit = false;
 		_btnReserveNone->setGroup(&_reserve);
 		_btnReserveSnap->setGroup(&_reserve);
@@ -862,12 +872,24 @@ void BattlescapeState::think()
 		if (_popups.empty())
 		{
 			State::think();
-			_battleGame->think();
+			if (_battleGame->isReplaying())
+			{
+				_battleGame->thinkReplay();
+			}
+			else
+			{
+				_battleGame->think();
+			}
 			_animTimer->think(this, 0);
 			_gameTimer->think(this, 0);
 			if (popped)
 			{
-				_battleGame->handleNonTargetAction();
+				// during playback, the recorded command does this
+				if (!_battleGame->isReplaying())
+				{
+					_battleGame->recordReplay(REPLAY_NON_TARGET);
+					_battleGame->handleNonTargetAction();
+				}
 				popped = false;
 			}
 		}
@@ -1064,6 +1086,10 @@ void BattlescapeState::mapClick(Action *action)
 	// right-click aborts walking state
 	if (_game->isRightClick(action))
 	{
+		if (!_battleGame->isBusy())
+		{
+			_battleGame->recordReplay(REPLAY_CANCEL);
+		}
 		if (_battleGame->cancelCurrentAction())
 		{
 			return;
@@ -1091,10 +1117,12 @@ void BattlescapeState::mapClick(Action *action)
 	{
 		if (_game->isRightClick(action, true) && playableUnitSelected())
 		{
+			_battleGame->recordReplay(REPLAY_SECONDARY, pos);
 			_battleGame->secondaryAction(pos);
 		}
 		else if (_game->isLeftClick(action, true))
 		{
+			_battleGame->recordReplay(REPLAY_PRIMARY, pos);
 			_battleGame->primaryAction(pos);
 		}
 		else if (_game->isMiddleClick(action, true))
@@ -1135,6 +1163,7 @@ void BattlescapeState::btnUnitUpClick(Action *)
 {
 	if (playableUnitSelected() && _save->getPathfinding()->validateUpDown(_save->getSelectedUnit(), _save->getSelectedUnit()->getPosition(), Pathfinding::DIR_UP))
 	{
+		_battleGame->recordReplay(REPLAY_MOVE_UP);
 		_battleGame->cancelAllActions();
 		_battleGame->moveUpDown(_save->getSelectedUnit(), Pathfinding::DIR_UP);
 	}
@@ -1148,6 +1177,7 @@ void BattlescapeState::btnUnitDownClick(Action *)
 {
 	if (playableUnitSelected() && _save->getPathfinding()->validateUpDown(_save->getSelectedUnit(), _save->getSelectedUnit()->getPosition(), Pathfinding::DIR_DOWN))
 	{
+		_battleGame->recordReplay(REPLAY_MOVE_DOWN);
 		_battleGame->cancelAllActions();
 		_battleGame->moveUpDown(_save->getSelectedUnit(), Pathfinding::DIR_DOWN);
 	}
@@ -1207,6 +1237,7 @@ void BattlescapeState::btnKneelClick(Action *)
 		BattleUnit *bu = _save->getSelectedUnit();
 		if (bu)
 		{
+			_battleGame->recordReplay(REPLAY_KNEEL);
 			_battleGame->kneel(bu);
 			toggleKneelButton(bu);
 
@@ -1242,6 +1273,7 @@ void BattlescapeState::btnInventoryClick(Action *)
 	if (playableUnitSelected()
 		&& (_save->getSelectedUnit()->hasInventory() || _save->getDebugMode()))
 	{
+		_battleGame->recordInventoryOpened();
 		_battleGame->cancelAllActions();
 		_game->pushState(new InventoryState(true, this, 0));
 	}
@@ -1412,6 +1444,7 @@ void BattlescapeState::btnEndTurnClick(Action *)
 		toggleTouchButtons(true, false);
 
 		_txtTooltip->setText("");
+		_battleGame->recordReplay(REPLAY_END_TURN);
 		_battleGame->requestEndTurn(false);
 	}
 }
@@ -1751,6 +1784,7 @@ void BattlescapeState::toggleTouchButtons(bool deactivate, bool tryToReactivate)
  */
 void BattlescapeState::btnLaunchClick(Action *action)
 {
+	_battleGame->recordReplay(REPLAY_LAUNCH);
 	_battleGame->launchAction();
 	action->getDetails()->type = SDL_NOEVENT; // consume the event
 }
@@ -1761,6 +1795,7 @@ void BattlescapeState::btnLaunchClick(Action *action)
  */
 void BattlescapeState::btnPsiClick(Action *action)
 {
+	_battleGame->recordReplay(REPLAY_PSI);
 	_battleGame->psiButtonAction();
 	action->getDetails()->type = SDL_NOEVENT; // consume the event
 }
@@ -2890,6 +2925,11 @@ inline void BattlescapeState::handle(Action *action)
 						_save->getBattleGame()->checkForCasualties(nullptr, BattleActionAttack{}, true, false);
 						_save->getBattleGame()->handleState();
 					}
+					// ctrl-f11 - benchmark
+					else if (key == SDLK_F11 && ctrlPressed)
+					{
+						runBenchmark();
+					}
 					// f11 - voxel map dump
 					else if (key == SDLK_F11)
 					{
@@ -3245,6 +3285,66 @@ void BattlescapeState::saveVoxelMap()
 	return;
 }
 
+/**
+ * Times the battlescape hot paths on the current map and logs
+ * the results next to the previous baseline.
+ * Ctrl-shift-f11 also saves them as the new baseline.
+ */
+void BattlescapeState::runBenchmark()
+{
+	debug("Running benchmark");
+	TileEngine *te = _save->getTileEngine();
+	Pathfinding *pf = _save->getPathfinding();
+	std::vector<BattleUnit*> units;
+	for (BattleUnit *unit : *_save->getUnits())
+	{
+		if (!unit->isOut() && unit->getTile())
+		{
+			units.push_back(unit);
+		}
+	}
+
+	Benchmark bench("battlescape");
+	bench.run("TileEngine::recalculateFOV", 20, [&]{ te->recalculateFOV(); });
+	bench.run("TileEngine::calculateLighting", 20, [&]{ te->calculateLighting(LL_AMBIENT, TileEngine::invalid, 0, true); });
+	bench.run("TileEngine::calculateLineVoxel", 20, [&]
+	{
+		std::vector<Position> trajectory;
+		for (BattleUnit *from : units)
+		{
+			for (BattleUnit *to : units)
+			{
+				if (from != to)
+				{
+					trajectory.clear();
+					te->calculateLineVoxel(from->getPosition().toVoxel() + Position(8, 8, 12), to->getPosition().toVoxel() + Position(8, 8, 12), true, &trajectory, from);
+				}
+			}
+		}
+	});
+	BattleUnit *walker = _save->getSelectedUnit();
+	if (walker && !walker->isOut())
+	{
+		bench.run("Pathfinding::calculate", 20, [&]
+		{
+			// the same fixed grid of destinations on the unit's level every time
+			for (int x = 2; x < _save->getMapSizeX(); x += _save->getMapSizeX() / 4 + 1)
+			{
+				for (int y = 2; y < _save->getMapSizeY(); y += _save->getMapSizeY() / 4 + 1)
+				{
+					pf->calculate(walker, Position(x, y, walker->getPosition().z), BAM_NORMAL);
+					pf->abortPath();
+				}
+			}
+		});
+	}
+	// draw() returns early unless the map was invalidated
+	bench.run("Map::draw", 50, [&]{ _map->invalidate(); _map->draw(); });
+
+	bench.report((SDL_GetModState() & KMOD_SHIFT) != 0);
+	debug("Benchmark done, see the log");
+}
+
 /**
  * Adds a new popup window to the queue
  * (this prevents popups from overlapping).
@@ -3265,6 +3365,8 @@ void BattlescapeState::finishBattle(bool abort, int inExitArea)
 {
 	bool isPreview = _save->isPreview();
 
+	_battleGame->finishReplay();
+
 	while (!_game->isState(this))
 	{
 		_game->popState();
@@ -257,6 +257,8 @@ public:
 	void saveAIMap();
 	/// Saves each layer of voxels on the bettlescape as a png.
 	void saveVoxelMap();
+	/// Times the battlescape hot paths and logs the results.
+	void runBenchmark();
 	/// Saves a first-person voxel view of the battlescape.
 	void saveVoxelView();
 	/// Handler for the mouse moving over the icons, disables the tile selection cube.
@@ -242,9 +242,8 @@ void ExplosionBState::init()
 				int Y = RNG::generate(-powerForAnimation / 2, powerForAnimation / 2);
 				Position p = _center;
 				p.x += X; p.y += Y;
-				Explosion *explosion = new Explosion(p, frame, frameDelay, true, false, frameCount);
 				// add the explosion on the map
-				_parent->getMap()->getExplosions()->push_back(explosion);
+				_parent->getMap()->getExplosions()->push_back(Explosion(p, frame, frameDelay, true, false, frameCount));
 				if (i > 0 && i % counter == 0)
 				{
 					frameDelay++;
@@ -371,8 +370,7 @@ void ExplosionBState::init()
 
 		if (anim != -1)
 		{
-			Explosion *explosion = new Explosion(_center, anim, 0, false, (_hit || _psi), animFrames); // Don't burn the tile
-			_parent->getMap()->getExplosions()->push_back(explosion);
+			_parent->getMap()->getExplosions()->push_back(Explosion(_center, anim, 0, false, (_hit || _psi), animFrames)); // Don't burn the tile
 		}
 		if (_parent->getMap()->getFollowProjectile())
 		{
@@ -407,11 +405,10 @@ void ExplosionBState::think()
 		if (_parent->getMap()->getExplosions()->empty())
 			explode();
 
-		for (std::list<Explosion*>::iterator i = _parent->getMap()->getExplosions()->begin(); i != _parent->getMap()->getExplosions()->end();)
+		for (std::vector<Explosion>::iterator i = _parent->getMap()->getExplosions()->begin(); i != _parent->getMap()->getExplosions()->end();)
 		{
-			if (!(*i)->animate())
+			if (!i->animate())
 			{
-				delete (*i);
 				i = _parent->getMap()->getExplosions()->erase(i);
 				if (_parent->getMap()->getExplosions()->empty())
 				{
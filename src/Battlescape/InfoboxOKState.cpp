@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "InfoboxOKState.h"
+#include "BattlescapeGame.h"
 #include "../Engine/Game.h"
 #include "../Interface/TextButton.h"
 #include "../Interface/Frame.h"
@@ -80,6 +81,20 @@ InfoboxOKState::~InfoboxOKState()
 
 }
 
+/**
+ * Clicks OK on its own while a recorded battle plays back,
+ * as there's nobody to do it.
+ */
+void InfoboxOKState::think()
+{
+	State::think();
+	BattlescapeGame *battleGame = _game->getSavedGame()->getSavedBattle()->getBattleGame();
+	if (battleGame && battleGame->isReplaying())
+	{
+		btnOkClick(0);
+	}
+}
+
 /**
  * Returns to the previous screen.
  * @param action Pointer to an action.
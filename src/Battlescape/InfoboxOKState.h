@@ -41,6 +41,8 @@ public:
 	InfoboxOKState(const std::string &msg);
 	/// Cleans up the InfoboxOKState.
 	~InfoboxOKState();
+	/// Closes the window during a replay.
+	void think() override;
 	/// Handler for clicking the OK button.
 	void btnOkClick(Action *action);
 };
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "InfoboxState.h"
+#include "BattlescapeGame.h"
 #include "../Engine/Game.h"
 #include "../Engine/Timer.h"
 #include "../Interface/Text.h"
@@ -67,6 +68,13 @@ InfoboxState::InfoboxState(const std::string &msg, int delay)
 		_text->setVisible(false);
 	}
 
+	BattlescapeGame *battleGame = _game->getSavedGame()->getSavedBattle()->getBattleGame();
+	if (battleGame && battleGame->isReplaying())
+	{
+		// nobody is watching the recorded battle play back
+		delay = 1;
+	}
+
 	_timer = new Timer(delay);
 	_timer->onTimer((StateHandler)&InfoboxState::close);
 	_timer->start();
@@ -335,6 +335,11 @@ InventoryState::~InventoryState()
 			_game->getScreen()->resetDisplay(false);
 		}
 
+		if (_tu)
+		{
+			_parent->getBattleGame()->recordInventoryClosed();
+		}
+
 		//fix case when scripts could kill unit before inventory is closed
 		if (BattleUnit* unit =_battleGame->getSelectedUnit())
 		{
@@ -53,6 +53,7 @@
 #include "../Interface/NumberText.h"
 #include "../Interface/Text.h"
 #include "../fmath.h"
+#include "../Engine/Profiler.h"
 
 
 /*
@@ -117,6 +118,7 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 
 	PathPreview previewSetting = Options::battleNewPreviewPath;
 	_smoothCamera = Options::battleSmoothCamera;
+	_unitSpriteCache = new UnitSpriteCache();
 	if (Options::traceAI)
 	{
 		// turn everything on because we want to see the markers.
@@ -208,8 +210,14 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 		}
 	}
 
-	_vaporParticlesInit.resize(_camera->getMapSizeY() * _camera->getMapSizeX());
-	_vaporParticles.resize(_camera->getMapSizeY() * _camera->getMapSizeX());
+	// big blasts add a few dozen sprites at once, firefights thousands of vapor particles
+	_explosions.reserve(64);
+	_maxVaporParticles = (size_t)std::max(0, Options::maxVaporParticles);
+	_vaporParticlesInit.reserve(_maxVaporParticles);
+	_vaporParticles.reserve(_maxVaporParticles);
+	_vaporTiles.reserve(_maxVaporParticles);
+	_vaporParticlesSpare.reserve(_maxVaporParticles);
+	_vaporTilesSpare.reserve(_maxVaporParticles);
 }
 
 /**
@@ -227,6 +235,7 @@ Map::~Map()
 	delete _message;
 	delete _camera;
 	delete _txtAccuracy;
+	delete _unitSpriteCache;
 }
 
 /**
@@ -328,6 +337,7 @@ void Map::think()
  */
 void Map::draw()
 {
+	ProfileScope profile(PROFILE_MAP_DRAW);
 	if (!_redraw)
 	{
 		return;
@@ -361,10 +371,10 @@ void Map::draw()
 	_explosionInFOV = _save->getDebugMode();
 	if (!_explosions.empty())
 	{
-		for (std::list<Explosion*>::iterator i = _explosions.begin(); i != _explosions.end(); ++i)
+		for (std::vector<Explosion>::const_iterator i = _explosions.begin(); i != _explosions.end(); ++i)
 		{
-			t = _save->getTile((*i)->getPosition().toTile());
-			if (t && ((*i)->isBig() || t->getVisible()))
+			t = _save->getTile(i->getPosition().toTile());
+			if (t && (i->isBig() || t->getVisible()))
 			{
 				_explosionInFOV = true;
 				break;
@@ -743,7 +753,7 @@ void Map::drawTerrain(Surface *surface)
 	int dummy;
 	BattleUnit *movingUnit = _save->getTileEngine()->getMovingUnit();
 	int tileShade, tileColor, obstacleShade;
-	UnitSprite unitSprite(surface, _game->getMod(), _save, _animFrame, _save->getDepth() != 0);
+	UnitSprite unitSprite(surface, _game->getMod(), _save, _animFrame, _save->getDepth() != 0, _unitSpriteCache);
 	ItemSprite itemSprite(surface, _game->getMod(), _save, _animFrame);
 
 	const int halfAnimFrame = (_animFrame / 2) % 4;
@@ -1791,25 +1801,25 @@ void Map::drawTerrain(Surface *surface)
 		}
 		else
 		{
-			for (std::list<Explosion*>::const_iterator i = _explosions.begin(); i != _explosions.end(); ++i)
+			for (std::vector<Explosion>::const_iterator i = _explosions.begin(); i != _explosions.end(); ++i)
 			{
-				_camera->convertVoxelToScreen((*i)->getPosition(), &bulletPositionScreen);
-				if ((*i)->isBig())
+				_camera->convertVoxelToScreen(i->getPosition(), &bulletPositionScreen);
+				if (i->isBig())
 				{
-					if ((*i)->getCurrentFrame() >= 0)
+					if (i->getCurrentFrame() >= 0)
 					{
-						tmpSurface = _game->getMod()->getSurfaceSet("X1.PCK")->getFrame((*i)->getCurrentFrame());
+						tmpSurface = _game->getMod()->getSurfaceSet("X1.PCK")->getFrame(i->getCurrentFrame());
 						Surface::blitRaw(surface, tmpSurface, bulletPositionScreen.x - (tmpSurface.getWidth() / 2), bulletPositionScreen.y - (tmpSurface.getHeight() / 2), 0, false, _nvColor);
 					}
 				}
-				else if ((*i)->isHit())
+				else if (i->isHit())
 				{
-					tmpSurface = _game->getMod()->getSurfaceSet("HIT.PCK")->getFrame((*i)->getCurrentFrame());
+					tmpSurface = _game->getMod()->getSurfaceSet("HIT.PCK")->getFrame(i->getCurrentFrame());
 					Surface::blitRaw(surface, tmpSurface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 25, 0, false, _nvColor);
 				}
 				else
 				{
-					tmpSurface = _game->getMod()->getSurfaceSet("SMOKE.PCK")->getFrame((*i)->getCurrentFrame());
+					tmpSurface = _game->getMod()->getSurfaceSet("SMOKE.PCK")->getFrame(i->getCurrentFrame());
 					Surface::blitRaw(surface, tmpSurface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 15, 0, false, _nvColor);
 				}
 			}
@@ -2020,51 +2030,57 @@ void Map::animate(bool redraw)
 		_save->getTile(i)->animate();
 	}
 
-	// init vapor vector
-	for (auto i : Collections::rangeValueLess(_vaporParticlesInit.size()))
+	// merge new vapor, all particles are kept sorted by tile and then height
+	if (!_vaporParticlesInit.empty())
 	{
-		auto& vi = _vaporParticlesInit[i];
-		auto& vDest = _vaporParticles[i];
-		if (vi.empty())
-		{
-			continue;
-		}
+		std::stable_sort(std::begin(_vaporParticlesInit), std::end(_vaporParticlesInit),
+			[](const std::pair<int, Particle>& a, const std::pair<int, Particle>& b)
+			{
+				return a.first < b.first || (a.first == b.first && a.second.getVoxelZ() < b.second.getVoxelZ());
+			}
+		);
 
-		if (vDest.empty())
+		// merge into the spare buffers and swap, so memory is only allocated once per battle
+		std::vector<Particle>& particles = _vaporParticlesSpare;
+		std::vector<int>& tiles = _vaporTilesSpare;
+		particles.clear();
+		tiles.clear();
+		size_t i = 0, j = 0;
+		while (i < _vaporParticles.size() || j < _vaporParticlesInit.size())
 		{
-			vi.swap(vDest);
-		}
-		else
-		{
-			vDest.insert(std::begin(vDest), std::begin(vi), std::end(vi));
+			// new particles go first among equals, like they used to
+			if (j < _vaporParticlesInit.size() && (i == _vaporParticles.size() || _vaporParticlesInit[j].first < _vaporTiles[i] ||
+				(_vaporParticlesInit[j].first == _vaporTiles[i] && _vaporParticlesInit[j].second.getVoxelZ() <= _vaporParticles[i].getVoxelZ())))
+			{
+				tiles.push_back(_vaporParticlesInit[j].first);
+				particles.push_back(_vaporParticlesInit[j].second);
+				++j;
+			}
+			else
+			{
+				tiles.push_back(_vaporTiles[i]);
+				particles.push_back(_vaporParticles[i]);
+				++i;
+			}
 		}
-
-		std::sort(std::begin(vDest), std::end(vDest), [](const Particle& a, const Particle& b){ return a.getVoxelZ() < b.getVoxelZ(); });
-
-		Collections::removeAll(vi);
+		_vaporParticles.swap(particles);
+		_vaporTiles.swap(tiles);
+		_vaporParticlesInit.clear();
 	}
 
-	// animate vapor
-	for (auto& tilePar : _vaporParticles)
+	// animate vapor in one pass, all particles rise at the same rate so the order stays the same
+	size_t left = 0;
+	for (size_t i = 0; i < _vaporParticles.size(); ++i)
 	{
-		if (tilePar.empty())
+		if (_vaporParticles[i].animate())
 		{
-			continue;
-		}
-
-		auto left = Collections::removeIf(
-			tilePar,
-			[](Particle& p)
-			{
-				return p.animate() == false;
-			}
-		);
-		if (!left)
-		{
-			//clean all allocated memory, after every particle expire.
-			Collections::removeAll(tilePar);
+			_vaporParticles[left] = _vaporParticles[i];
+			_vaporTiles[left] = _vaporTiles[i];
+			++left;
 		}
 	}
+	_vaporParticles.erase(_vaporParticles.begin() + left, _vaporParticles.end());
+	_vaporTiles.erase(_vaporTiles.begin() + left, _vaporTiles.end());
 
 	// animate certain units (large flying units have a propulsion animation)
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
@@ -2289,12 +2305,16 @@ Projectile *Map::getProjectile() const
 }
 
 /**
- * Add new vapor particle.
+ * Add new vapor particle. Once there are as many as the
+ * options allow, new ones are dropped until old ones fade out.
  */
 void Map::addVaporParticle(const Tile* tile, Particle particle)
 {
-	auto& v = _vaporParticlesInit[_camera->getMapSizeX() * tile->getPosition().y + tile->getPosition().x];
-	v.push_back(particle);
+	if (_vaporParticles.size() + _vaporParticlesInit.size() >= _maxVaporParticles)
+	{
+		return;
+	}
+	_vaporParticlesInit.push_back(std::make_pair(_camera->getMapSizeX() * tile->getPosition().y + tile->getPosition().x, particle));
 }
 
 /**
@@ -2306,11 +2326,13 @@ void Map::addVaporParticle(const Tile* tile, Particle particle)
 Collections::Range<const Particle*> Map::getVaporParticle(const Tile* tile, bool topLayer) const
 {
 	auto pos = tile->getPosition();
-	auto& v = _vaporParticles[_camera->getMapSizeX() * pos.y + pos.x];
+	auto t = std::equal_range(_vaporTiles.begin(), _vaporTiles.end(), _camera->getMapSizeX() * pos.y + pos.x);
+	auto v = _vaporParticles.data() + (t.first - _vaporTiles.begin());
+	auto vEnd = _vaporParticles.data() + (t.second - _vaporTiles.begin());
 	auto startZ = pos.z * Position::TileZ;
 	auto endZ = startZ + Position::TileZ;
-	auto s = std::partition_point(v.data(), v.data() + v.size(), [&](const Particle& a){ return a.getVoxelZ() < startZ; });
-	auto e = topLayer ? v.data() + v.size() : std::partition_point(s, v.data() + v.size(), [&](const Particle& a){ return a.getVoxelZ() < endZ; });
+	auto s = std::partition_point(v, vEnd, [&](const Particle& a){ return a.getVoxelZ() < startZ; });
+	auto e = topLayer ? vEnd : std::partition_point(s, vEnd, [&](const Particle& a){ return a.getVoxelZ() < endZ; });
 	return Collections::Range{ s, e };
 }
 
@@ -2318,7 +2340,7 @@ Collections::Range<const Particle*> Map::getVaporParticle(const Tile* tile, bool
  * Gets a list of explosion sprites on the map.
  * @return A list of explosion sprites.
  */
-std::list<Explosion*> *Map::getExplosions()
+std::vector<Explosion> *Map::getExplosions()
 {
 	return &_explosions;
 }
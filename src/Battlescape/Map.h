@@ -23,6 +23,7 @@
 #include "../Mod/MapData.h"
 #include "Position.h"
 #include "Particle.h"
+#include "Explosion.h"
 #include <vector>
 
 namespace OpenXcom
@@ -33,13 +34,13 @@ class Surface;
 class SurfaceSet;
 class BattleUnit;
 class Projectile;
-class Explosion;
 class BattlescapeMessage;
 class Camera;
 class Timer;
 class Text;
 class Tile;
 class UnitSprite;
+class UnitSpriteCache;
 
 enum CursorType { CT_NONE, CT_NORMAL, CT_AIM, CT_PSI, CT_WAYPOINT, CT_THROW, CT_HACK };
 enum TilePart : int;
@@ -89,9 +90,11 @@ private:
 	Projectile *_projectile;
 	bool _followProjectile;
 	bool _projectileInFOV;
-	std::list<Explosion *> _explosions;
-	std::vector<std::vector<Particle>> _vaporParticlesInit;
-	std::vector<std::vector<Particle>> _vaporParticles;
+	std::vector<Explosion> _explosions;
+	std::vector<std::pair<int, Particle>> _vaporParticlesInit;
+	std::vector<Particle> _vaporParticles, _vaporParticlesSpare;
+	std::vector<int> _vaporTiles, _vaporTilesSpare;
+	size_t _maxVaporParticles;
 	bool _explosionInFOV, _launch;
 	BattlescapeMessage *_message;
 	Camera *_camera;
@@ -102,6 +105,7 @@ private:
 	bool _previewSettingArrows, _previewSettingTu, _previewSettingEnergy;
 	Text *_txtAccuracy;
 	SurfaceSet *_projectileSet;
+	UnitSpriteCache *_unitSpriteCache;
 
 	void drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Position tileScreenPosition, bool topLayer, BattleUnit* movingUnit = nullptr);
 	void drawTerrain(Surface *surface);
@@ -161,7 +165,7 @@ public:
 	/// Get all vapor for tile.
 	Collections::Range<const Particle*> getVaporParticle(const Tile* tile, bool topLayer) const;
 	/// Gets explosion set.
-	std::list<Explosion*> *getExplosions();
+	std::vector<Explosion> *getExplosions();
 
 	/// Gets the pointer to the camera.
 	Camera *getCamera();
@@ -279,7 +279,13 @@ NextTurnState::NextTurnState(SavedBattleGame *battleGame, BattlescapeState *stat
 		}
 	}
 
-	if (Options::skipNextTurnScreen && message.empty() && messageReinforcements.empty())
+	if (_state->getBattleGame()->isReplaying())
+	{
+		_timer = new Timer(1);
+		_timer->onTimer((StateHandler)&NextTurnState::close);
+		_timer->start();
+	}
+	else if (Options::skipNextTurnScreen && message.empty() && messageReinforcements.empty())
 	{
 		_timer = new Timer(NEXT_TURN_DELAY);
 		_timer->onTimer((StateHandler)&NextTurnState::close);
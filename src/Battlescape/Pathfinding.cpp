@@ -27,6 +27,7 @@
 #include "../Engine/Options.h"
 #include "../fmath.h"
 #include "BattlescapeGame.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -82,6 +83,7 @@ PathfindingNode *Pathfinding::getNode(Position pos)
  */
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleActionMove bam, const BattleUnit *missileTarget, int maxTUCost)
 {
+	ProfileScope profile(PROFILE_PATHFINDING);
 	_totalTUCost = {};
 	_path.clear();
 	// i'm DONE with these out of bounds errors.
@@ -44,6 +44,7 @@
 #include "MeleeAttackBState.h"
 #include "../Savegame/BattleObject.h"
 #include "../fmath.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -591,6 +592,7 @@ void TileEngine::calculateUnitDirectionalLighting(MapSubset gs, BattleUnit *unit
 
 void TileEngine::calculateLighting(LightLayers layer, Position position, int eventRadius, bool terrianChanged)
 {
+	ProfileScope profile(PROFILE_LIGHTING);
 	auto gsDynamic = MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() };
 	auto gsStatic = gsDynamic;
 
@@ -1204,6 +1206,7 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 */
 bool TileEngine::calculateFOV(BattleUnit *unit, bool doTileRecalc, bool doUnitRecalc)
 {
+	ProfileScope profile(PROFILE_FOV);
 	//Force a full FOV recheck for this unit.
 	if (doTileRecalc) calculateTilesInFOV(unit);
 	return doUnitRecalc ? calculateUnitsInFOV(unit) : false;
@@ -1943,6 +1946,7 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
  */
 void TileEngine::calculateFOV(Position position, int eventRadius, const bool updateTiles, const bool appendToTileVisibility)
 {
+	ProfileScope profile(PROFILE_FOV);
 	int updateRadius;
 	if (eventRadius == -1)
 	{
@@ -27,18 +27,159 @@
 #include "../Mod/RuleInventory.h"
 #include "../Mod/Mod.h"
 #include "../Engine/Exception.h"
+#include "../Engine/Options.h"
 
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Mixes a value into an FNV-1a checksum.
+ */
+void hashValue(Uint32 &hash, Sint64 value)
+{
+	for (int i = 0; i < 8; ++i)
+	{
+		hash = (hash ^ (Uint8)(value >> (i * 8))) * 16777619u;
+	}
+}
+
+/**
+ * Mixes all the script tags of an object into an FNV-1a checksum.
+ */
+void hashValues(Uint32 &hash, const std::vector<int> &values)
+{
+	hashValue(hash, values.size());
+	for (int value : values)
+	{
+		hashValue(hash, value);
+	}
+}
+
+}
+
+/**
+ * Calculates a checksum of everything about a unit that its recolor
+ * script can read: its stats and state, its armor and its script tags.
+ * @param unit Pointer to the unit.
+ * @return Checksum.
+ */
+Uint32 UnitSpriteCache::hashUnit(const BattleUnit *unit)
+{
+	Uint32 hash = 2166136261u;
+	hashValue(hash, reinterpret_cast<intptr_t>(unit->getArmor()));
+	hashValue(hash, unit->getStatus());
+	hashValue(hash, unit->getFaction());
+	hashValue(hash, unit->getRankInt());
+	hashValue(hash, unit->getDirection());
+	hashValue(hash, unit->isKneeled());
+	hashValue(hash, unit->getHealth());
+	hashValue(hash, unit->getStunlevel());
+	hashValue(hash, unit->getFire());
+	hashValue(hash, unit->getTimeUnits());
+	hashValue(hash, unit->getEnergy());
+	hashValue(hash, unit->getMorale());
+	hashValue(hash, unit->getMana());
+	hashValues(hash, unit->getScriptValuesRaw().getValuesRaw());
+	return hash;
+}
+
+/**
+ * Calculates a checksum of everything about an item that its recolor
+ * script can read: its rules, ammo, fuse and script tags,
+ * and the state of the unit holding it.
+ * @param item Pointer to the item.
+ * @return Checksum.
+ */
+Uint32 UnitSpriteCache::hashItem(const BattleItem *item)
+{
+	Uint32 hash = 2166136261u;
+	hashValue(hash, reinterpret_cast<intptr_t>(item->getRules()));
+	hashValue(hash, reinterpret_cast<intptr_t>(item->getSlot()));
+	hashValue(hash, item->getAmmoQuantity());
+	hashValue(hash, item->getFuseTimer());
+	for (int slot = 0; slot < RuleItem::AmmoSlotMax; ++slot)
+	{
+		const BattleItem *ammo = item->getAmmoForSlot(slot);
+		hashValue(hash, ammo ? ammo->getId() : -1);
+		hashValue(hash, ammo ? ammo->getAmmoQuantity() : 0);
+	}
+	hashValues(hash, item->getScriptValuesRaw().getValuesRaw());
+	const BattleUnit *owner = item->getOwner();
+	hashValue(hash, owner ? owner->getId() : -1);
+	hashValue(hash, owner ? hashUnit(owner) : 0);
+	return hash;
+}
+
+/**
+ * Blits a sprite part through its recolor script. The first time a part
+ * is seen it's recolored twice, over an empty and a filled background:
+ * if the results match, the script doesn't care what's underneath and
+ * the result can be blitted as is from then on.
+ * @param work Script worker, already filled.
+ * @param key Everything that can change the result.
+ * @param src Sprite part.
+ * @param dest Destination surface.
+ * @param x X position on the destination.
+ * @param y Y position on the destination.
+ * @param shade Shade passed to the script.
+ * @param mask Area of the destination to draw on.
+ */
+void UnitSpriteCache::blit(ScriptWorkerBlit &work, const Key &key, const Surface *src, Surface *dest, int x, int y, int shade, GraphSubset mask)
+{
+	std::map<Key, Entry>::iterator i = _entries.find(key);
+	if (i == _entries.end())
+	{
+		if (_entries.size() >= MAX_ENTRIES)
+		{
+			_entries.clear();
+		}
+		const Uint8 background = 0xFF;
+		int width = src->getWidth(), height = src->getHeight();
+		Entry &entry = _entries[key];
+		entry.surface.reset(new Surface(width, height));
+		entry.direct = false;
+		Surface filled(width, height);
+		filled.drawRect(0, 0, width, height, background);
+		work.executeBlit(src, entry.surface.get(), 0, 0, shade);
+		work.executeBlit(src, &filled, 0, 0, shade);
+		for (int py = 0; py < height && !entry.direct; ++py)
+		{
+			for (int px = 0; px < width; ++px)
+			{
+				Uint8 pixel = entry.surface->getPixel(px, py), pixelFilled = filled.getPixel(px, py);
+				if (pixel != pixelFilled && (pixel != 0 || pixelFilled != background))
+				{
+					entry.direct = true;
+					break;
+				}
+			}
+		}
+		i = _entries.find(key);
+	}
+
+	if (i->second.direct)
+	{
+		work.executeBlit(src, dest, x, y, shade, mask);
+	}
+	else
+	{
+		i->second.surface->blitNShade(dest, x, y, 0, mask);
+	}
+}
+
 /**
  * Sets up a UnitSprite with the specified size and position.
- * @param width Width in pixels.
- * @param height Height in pixels.
- * @param x X position in pixels.
- * @param y Y position in pixels.
+ * @param dest Surface to draw on.
+ * @param mod Pointer to the mod.
+ * @param save Pointer to the battle.
+ * @param frame Current animation frame.
+ * @param helmet Draw units with their underwater sprites.
+ * @param cache Cache for parts recolored by scripts, if any.
  */
-UnitSprite::UnitSprite(Surface* dest, const Mod* mod, const SavedBattleGame* save, int frame, bool helmet) :
+UnitSprite::UnitSprite(Surface* dest, const Mod* mod, const SavedBattleGame* save, int frame, bool helmet, UnitSpriteCache *cache) :
 	_unit(0), _itemR(0), _itemL(0),
 	_unitSurface(0),
 	_itemSurface(const_cast<Mod*>(mod)->getSurfaceSet("HANDOB.PCK")),
@@ -46,7 +187,7 @@ UnitSprite::UnitSprite(Surface* dest, const Mod* mod, const SavedBattleGame* sav
 	_breathSurface(const_cast<Mod*>(mod)->getSurfaceSet("BREATH-1.PCK", false)),
 	_facingArrowSurface(const_cast<Mod*>(mod)->getSurfaceSet("DETBLOB.DAT")),
 	_warnIndicator(const_cast<Mod*>(mod)->getSurface("UnitWarnedIndicator", false)),
-	_dest(dest), _save(save), _mod(mod),
+	_dest(dest), _cache(cache), _save(save), _mod(mod),
 	_part(0), _animationFrame(frame), _drawingRoutine(0),
 	_helmet(helmet),
 	_x(0), _y(0), _shade(0), _burn(0),
@@ -145,11 +286,20 @@ void UnitSprite::blitItem(Part& item)
 		return;
 	}
 	ScriptWorkerBlit work;
-	BattleItem::ScriptFill(&work, (item.bodyPart == BODYPART_ITEM_RIGHTHAND ? _itemR : _itemL), _save, item.bodyPart, _animationFrame, _shade);
+	const BattleItem *owner = (item.bodyPart == BODYPART_ITEM_RIGHTHAND ? _itemR : _itemL);
+	BattleItem::ScriptFill(&work, owner, _save, item.bodyPart, _animationFrame, _shade);
 
 	_dest->lock();
 
-	work.executeBlit(item.src, _dest,  _x + item.offX, _y + item.offY, _shade, _mask);
+	if (_cache && owner && work.hasScript() && Options::unitSpriteCache)
+	{
+		UnitSpriteCache::Key key(true, owner->getId(), item.src, item.bodyPart, _animationFrame, _shade, 0, _save->getTurn(), UnitSpriteCache::hashItem(owner));
+		_cache->blit(work, key, item.src, _dest, _x + item.offX, _y + item.offY, _shade, _mask);
+	}
+	else
+	{
+		work.executeBlit(item.src, _dest,  _x + item.offX, _y + item.offY, _shade, _mask);
+	}
 
 	_dest->unlock();
 }
@@ -169,7 +319,15 @@ void UnitSprite::blitBody(Part& body)
 
 	_dest->lock();
 
-	work.executeBlit(body.src, _dest,  _x + body.offX, _y + body.offY, _shade, _mask);
+	if (_cache && work.hasScript() && Options::unitSpriteCache)
+	{
+		UnitSpriteCache::Key key(false, _unit->getId(), body.src, body.bodyPart, _animationFrame, _shade, _burn, _save->getTurn(), UnitSpriteCache::hashUnit(_unit));
+		_cache->blit(work, key, body.src, _dest, _x + body.offX, _y + body.offY, _shade, _mask);
+	}
+	else
+	{
+		work.executeBlit(body.src, _dest,  _x + body.offX, _y + body.offY, _shade, _mask);
+	}
 
 	_dest->unlock();
 }
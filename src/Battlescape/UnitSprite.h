@@ -17,6 +17,9 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <map>
+#include <memory>
+#include <tuple>
 #include "../Engine/Surface.h"
 #include "../Engine/Script.h"
 
@@ -29,6 +32,36 @@ class SavedBattleGame;
 class SurfaceSet;
 class Mod;
 
+/**
+ * Keeps the sprite parts recolored by mod scripts, so units that
+ * didn't change since the last frame don't run the script on every pixel.
+ * Parts whose script blends with the background are always drawn directly.
+ */
+class UnitSpriteCache
+{
+public:
+	/// Item or unit, owner id, frame, body part, animation frame, shade, burn, turn, and a checksum of the owner's script inputs.
+	typedef std::tuple<bool, int, const Surface*, int, int, int, int, int, Uint32> Key;
+	/// Maximum number of parts kept.
+	static const size_t MAX_ENTRIES = 2048;
+private:
+	struct Entry
+	{
+		std::unique_ptr<Surface> surface;
+		bool direct;
+	};
+	std::map<Key, Entry> _entries;
+public:
+	/// Blits a part with its recolor script, reusing the last result when possible.
+	void blit(ScriptWorkerBlit &work, const Key &key, const Surface *src, Surface *dest, int x, int y, int shade, GraphSubset mask);
+	/// Calculates a checksum of the unit state a recolor script can read.
+	static Uint32 hashUnit(const BattleUnit *unit);
+	/// Calculates a checksum of the item state a recolor script can read.
+	static Uint32 hashItem(const BattleItem *item);
+	/// Forgets all the parts.
+	void clear() { _entries.clear(); }
+};
+
 /**
  * A class that renders a specific unit, given its render rules
  * combining the right frames from the surfaceset.
@@ -53,6 +86,7 @@ private:
 	const BattleItem *_itemR, *_itemL;
 	const SurfaceSet *_unitSurface, *_itemSurface, *_fireSurface, *_breathSurface, *_facingArrowSurface;
 	Surface* _warnIndicator, *_dest;
+	UnitSpriteCache *_cache;
 	const SavedBattleGame *_save;
 	const Mod *_mod;
 	int _part, _animationFrame, _drawingRoutine;
@@ -108,7 +142,7 @@ private:
 	void blitBody(Part& body);
 public:
 	/// Creates a new UnitSprite at the specified position and size.
-	UnitSprite(Surface* dest, const Mod* mod, const SavedBattleGame* save, int frame, bool helmet);
+	UnitSprite(Surface* dest, const Mod* mod, const SavedBattleGame* save, int frame, bool helmet, UnitSpriteCache *cache = 0);
 	/// Cleans up the UnitSprite.
 	~UnitSprite();
 	/// Draws the unit.
@@ -104,6 +104,9 @@ static int opl_dbg_maxchip,opl_dbg_chip;
 
 #define VIB_RATE 256
 
+/* samples rendered per channel at once */
+#define OPL_BLOCK 256
+
 /* -------------------- local defines , macros --------------------- */
 
 /* register number to channel number , slot offset */
@@ -499,6 +502,17 @@ INLINE void OPL_CALC_CH( OPL_CH *CH )
 	}
 }
 
+/* ---------- check for a channel that can't make any sound ---------- */
+/* both slots are off and stay off until key on, and no feedback is left */
+INLINE int OPL_CH_SILENT( OPL_CH *CH )
+{
+	OPL_SLOT *SLOT1P = &CH->SLOT[SLOT1];
+	OPL_SLOT *SLOT2P = &CH->SLOT[SLOT2];
+	return SLOT1P->evc == EG_OFF && SLOT1P->evs == 0 && SLOT1P->eve > EG_OFF &&
+		SLOT2P->evc == EG_OFF && SLOT2P->evs == 0 && SLOT2P->eve > EG_OFF &&
+		CH->op1_out[0] == 0 && CH->op1_out[1] == 0;
+}
+
 /* ---------- calcrate rythm block ---------- */
 #define WHITE_NOISE_db 6.0
 INLINE void OPL_CALC_RH( OPL_CH *CH )
@@ -1043,9 +1057,15 @@ static void OPL_UnLockTable(void)
 /*******************************************************************************/
 
 /* ---------- update one of chip ----------- */
-void YM3812UpdateOne(FM_OPL *OPL, INT16 *buffer, int length, int stripe, float volume)
+void YM3812UpdateOne(FM_OPL *OPL, INT16 *buffer, int length, int stripe, float volume, INT16 *full)
 {
-    int i;
+	/* samples are rendered one channel at a time over a block, */
+	/* skipping silent channels; the sums are the same as rendering */
+	/* every channel for one sample at a time */
+	INT32 mix[OPL_BLOCK];
+	INT32 amsBlock[OPL_BLOCK];
+	INT32 vibBlock[OPL_BLOCK];
+	int i, j, count;
 	int data;
 	OPLSAMPLE *buf = buffer;
 	UINT32 amsCnt  = OPL->amsCnt;
@@ -1070,24 +1090,59 @@ void YM3812UpdateOne(FM_OPL *OPL, INT16 *buffer, int length, int stripe, float v
 		vib_table = OPL->vib_table;
 	}
 	R_CH = rythm ? &S_CH[6] : E_CH;
-    for( i=0; i < length ; i+=stripe )
+	for( i=0; i < length ; i+=stripe*OPL_BLOCK )
 	{
-		/*            channel A         channel B         channel C      */
+		count = (length - i + stripe - 1) / stripe;
+		if( count > OPL_BLOCK ) count = OPL_BLOCK;
 		/* LFO */
-		ams = ams_table[(amsCnt+=amsIncr)>>AMS_SHIFT];
-		vib = vib_table[(vibCnt+=vibIncr)>>VIB_SHIFT];
-		outd[0] = 0;
+		for( j=0; j < count; j++ )
+		{
+			amsBlock[j] = ams_table[(amsCnt+=amsIncr)>>AMS_SHIFT];
+			vibBlock[j] = vib_table[(vibCnt+=vibIncr)>>VIB_SHIFT];
+			mix[j] = 0;
+		}
 		/* FM part */
 		for(CH=S_CH ; CH < R_CH ; CH++)
-			OPL_CALC_CH(CH);
+		{
+			if( OPL_CH_SILENT(CH) ) continue;
+			for( j=0; j < count; j++ )
+			{
+				ams = amsBlock[j];
+				vib = vibBlock[j];
+				outd[0] = 0;
+				OPL_CALC_CH(CH);
+				mix[j] += outd[0];
+			}
+		}
 		/* Rythm part */
 		if(rythm)
-			OPL_CALC_RH(S_CH);
-		outd[0] *= volume;
-		/* limit check */
-		data = Limit( outd[0] , OPL_MAXOUT, OPL_MINOUT );
-		/* store to sound buffer */
-		buf[i] = data >> OPL_OUTSB;
+		{
+			for( j=0; j < count; j++ )
+			{
+				ams = amsBlock[j];
+				vib = vibBlock[j];
+				outd[0] = 0;
+				OPL_CALC_RH(S_CH);
+				mix[j] += outd[0];
+			}
+		}
+		for( j=0; j < count; j++ )
+		{
+			if( full )
+			{
+				/* rounded through float the same as at volume 1.0 */
+				outd[0] = mix[j];
+				outd[0] *= 1.0f;
+				data = Limit( outd[0] , OPL_MAXOUT, OPL_MINOUT );
+				full[i + j*stripe] = data >> OPL_OUTSB;
+			}
+			outd[0] = mix[j];
+			outd[0] *= volume;
+			/* limit check */
+			data = Limit( outd[0] , OPL_MAXOUT, OPL_MINOUT );
+			/* store to sound buffer */
+			buf[i + j*stripe] = data >> OPL_OUTSB;
+		}
 	}
 
 	OPL->amsCnt = amsCnt;
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/**
+ * Test for the block renderer of the OPL emulator, built as opl_compare.
+ *
+ * Three chips get the same random register writes. One renders with
+ * YM3812UpdateOne, one with the per-sample loop it replaced, and one with
+ * that loop at full volume; the outputs must be identical to the bit.
+ * fmopl.cpp is included to reach the static channel state the old loop uses.
+ */
+#include "fmopl.cpp"
+
+namespace OpenXcom
+{
+namespace RNG
+{
+
+/// Noise of the rythm part, reset before every render so all chips see the same values.
+static std::mt19937 noise;
+
+int seedless(int min, int max)
+{
+	return std::uniform_int_distribution<int>(min, max)(noise);
+}
+
+}
+}
+
+namespace
+{
+
+/**
+ * YM3812UpdateOne as it was before channels were rendered in blocks.
+ */
+void YM3812UpdateOneReference(FM_OPL *OPL, INT16 *buffer, int length, int stripe, float volume)
+{
+	int i;
+	int data;
+	OPLSAMPLE *buf = buffer;
+	UINT32 amsCnt  = OPL->amsCnt;
+	UINT32 vibCnt  = OPL->vibCnt;
+	UINT8 rythm = OPL->rythm&0x20;
+	OPL_CH *CH,*R_CH;
+
+	if( (void *)OPL != cur_chip ){
+		cur_chip = (void *)OPL;
+		/* channel pointers */
+		S_CH = OPL->P_CH;
+		E_CH = &S_CH[9];
+		/* rythm slot */
+		SLOT7_1 = &S_CH[7].SLOT[SLOT1];
+		SLOT7_2 = &S_CH[7].SLOT[SLOT2];
+		SLOT8_1 = &S_CH[8].SLOT[SLOT1];
+		SLOT8_2 = &S_CH[8].SLOT[SLOT2];
+		/* LFO state */
+		amsIncr = OPL->amsIncr;
+		vibIncr = OPL->vibIncr;
+		ams_table = OPL->ams_table;
+		vib_table = OPL->vib_table;
+	}
+	R_CH = rythm ? &S_CH[6] : E_CH;
+	for( i=0; i < length ; i+=stripe )
+	{
+		/* channel A */
+		ams = ams_table[(amsCnt+=amsIncr)>>AMS_SHIFT];
+		vib = vib_table[(vibCnt+=vibIncr)>>VIB_SHIFT];
+		outd[0] = 0;
+		/* FM part */
+		for(CH=S_CH ; CH < R_CH ; CH++)
+			OPL_CALC_CH(CH);
+		/* Rythn part */
+		if(rythm)
+			OPL_CALC_RH(S_CH);
+		outd[0] *= volume;
+		/* limit check */
+		data = Limit( outd[0] , OPL_MAXOUT, OPL_MINOUT );
+		/* store to sound buffer */
+		buf[i] = data >> OPL_OUTSB;
+	}
+
+	OPL->amsCnt = amsCnt;
+	OPL->vibCnt = vibCnt;
+}
+
+/**
+ * Picks a register that makes sound, the timers are left alone.
+ * @param rng Random generator.
+ * @return Register address.
+ */
+int randomRegister(std::mt19937 &rng)
+{
+	static const int ranges[][2] = {
+		{ 0x01, 0x01 }, { 0x08, 0x08 }, { 0x20, 0x35 }, { 0x40, 0x55 }, { 0x60, 0x75 }, { 0x80, 0x95 },
+		{ 0xA0, 0xA8 }, { 0xB0, 0xB8 }, { 0xBD, 0xBD }, { 0xC0, 0xC8 }, { 0xE0, 0xF5 },
+	};
+	const int *range = ranges[std::uniform_int_distribution<int>(0, sizeof(ranges) / sizeof(ranges[0]) - 1)(rng)];
+	return std::uniform_int_distribution<int>(range[0], range[1])(rng);
+}
+
+/**
+ * Compares two rendered buffers.
+ * @param what Name of the output, for the error.
+ * @param round Round of the test, for the error.
+ * @return True if they are the same.
+ */
+bool same(const char *what, int round, const std::vector<INT16> &expected, const std::vector<INT16> &actual)
+{
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		if (expected[i] != actual[i])
+		{
+			printf("%s differs in round %d at sample %d: %d instead of %d\n", what, round, (int)i, actual[i], expected[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+int main()
+{
+	const int rounds = 2000;
+	const float volumes[] = { 1.0f, 0.5f, 0.123f, 0.0f };
+	std::mt19937 rng(1234);
+	FM_OPL *reference = OPLCreate(OPL_TYPE_YM3812, 3579545, 44100);
+	FM_OPL *block = OPLCreate(OPL_TYPE_YM3812, 3579545, 44100);
+	FM_OPL *full = OPLCreate(OPL_TYPE_YM3812, 3579545, 44100);
+	FM_OPL *chips[] = { reference, block, full };
+	int result = 0;
+
+	for (int round = 0; round < rounds && result == 0; ++round)
+	{
+		int writes = std::uniform_int_distribution<int>(0, 12)(rng);
+		for (int w = 0; w < writes; ++w)
+		{
+			int r = randomRegister(rng);
+			int v = std::uniform_int_distribution<int>(0, 255)(rng);
+			// keep some channels playing long enough to hear them
+			if (r >= 0xB0 && r <= 0xB8 && std::uniform_int_distribution<int>(0, 2)(rng))
+				v |= 0x20;
+			for (FM_OPL *chip : chips)
+			{
+				OPLWrite(chip, 0, r);
+				OPLWrite(chip, 1, v);
+			}
+		}
+
+		int stripe = std::uniform_int_distribution<int>(1, 2)(rng);
+		int length = std::uniform_int_distribution<int>(1, 3 * OPL_BLOCK * stripe)(rng);
+		float volume = volumes[std::uniform_int_distribution<int>(0, 3)(rng)];
+		std::vector<INT16> expected(length + 2, 0x5A5A), actual(length + 2, 0x5A5A);
+		std::vector<INT16> expectedFull(length + 2, 0x5A5A), actualFull(length + 2, 0x5A5A);
+		unsigned seed = rng();
+
+		OpenXcom::RNG::noise.seed(seed);
+		YM3812UpdateOneReference(reference, expected.data(), length, stripe, volume);
+		OpenXcom::RNG::noise.seed(seed);
+		YM3812UpdateOne(block, actual.data(), length, stripe, volume, actualFull.data());
+		OpenXcom::RNG::noise.seed(seed);
+		YM3812UpdateOneReference(full, expectedFull.data(), length, stripe, 1.0f);
+
+		if (!same("output", round, expected, actual) || !same("full volume output", round, expectedFull, actualFull))
+		{
+			result = 1;
+		}
+	}
+
+	for (FM_OPL *chip : chips)
+	{
+		OPLDestroy(chip);
+	}
+	if (result == 0)
+	{
+		printf("%d rounds identical\n", rounds);
+	}
+	return result;
+}
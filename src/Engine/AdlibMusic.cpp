@@ -18,6 +18,10 @@
  */
 #include "AdlibMusic.h"
 #include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "CrossPlatform.h"
+#include "Exception.h"
 #include "Options.h"
 #include "Logger.h"
 #include "Game.h"
@@ -34,12 +38,96 @@ namespace OpenXcom
 int AdlibMusic::delay = 0;
 int AdlibMusic::rate = 0;
 std::map<int, int> AdlibMusic::delayRates;
+std::vector<Sint16> AdlibMusic::recorded;
+std::string AdlibMusic::recordFile;
+bool AdlibMusic::recording = false;
+bool AdlibMusic::recordDone = false;
+int AdlibMusic::recordLoops = 0;
+
+namespace
+{
+
+/// Longest track that is recorded for the PCM cache, in seconds.
+const int MAX_RECORDING = 300;
+
+/**
+ * Appends a little-endian integer to a file buffer.
+ */
+void writeLE(std::vector<unsigned char> &data, Uint32 value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		data.push_back((value >> (i * 8)) & 0xFF);
+	}
+}
+
+/**
+ * A finished recording handed to the writing thread.
+ */
+struct Recording
+{
+	std::string file;
+	int rate;
+	std::vector<Sint16> samples;
+};
+
+/// Thread writing the last finished recording, if any.
+SDL_Thread *recordWriter = 0;
+
+/**
+ * Writes a finished recording to its PCM cache file as a WAV.
+ * @param data The recording, deleted when done.
+ * @return Always 0.
+ */
+int writeRecording(void *data)
+{
+	Recording *recording = (Recording*)data;
+	Uint32 size = recording->samples.size() * sizeof(Sint16);
+	std::vector<unsigned char> wav;
+	wav.reserve(44 + size);
+	wav.insert(wav.end(), { 'R', 'I', 'F', 'F' });
+	writeLE(wav, size + 36, 4);
+	wav.insert(wav.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+	writeLE(wav, 16, 4);
+	writeLE(wav, 1, 2); // PCM
+	writeLE(wav, 2, 2); // stereo
+	writeLE(wav, recording->rate, 4);
+	writeLE(wav, recording->rate * 4, 4);
+	writeLE(wav, 4, 2);
+	writeLE(wav, 16, 2);
+	wav.insert(wav.end(), { 'd', 'a', 't', 'a' });
+	writeLE(wav, size, 4);
+	for (Sint16 sample : recording->samples)
+	{
+		writeLE(wav, (Uint16)sample, 2);
+	}
+	if (CrossPlatform::writeFile(recording->file, wav))
+	{
+		Log(LOG_INFO) << "Adlib track saved to " << recording->file;
+	}
+	delete recording;
+	return 0;
+}
+
+/**
+ * Waits for the last finished recording to be written.
+ */
+void waitRecordWriter()
+{
+	if (recordWriter)
+	{
+		SDL_WaitThread(recordWriter, 0);
+		recordWriter = 0;
+	}
+}
+
+}
 
 /**
  * Initializes a new music track.
  * @param volume Music volume modifier (1.0 = 100%).
  */
-AdlibMusic::AdlibMusic(float volume) : Music(), _data(0), _size(0), _volume(volume)
+AdlibMusic::AdlibMusic(float volume) : Music(), _data(0), _size(0), _volume(volume), _pcm(0)
 {
 	rate = Options::audioSampleRate;
 	if (!opl[0])
@@ -68,9 +156,12 @@ AdlibMusic::AdlibMusic(float volume) : Music(), _data(0), _size(0), _volume(volu
  */
 AdlibMusic::~AdlibMusic()
 {
+	delete _pcm;
 	if (opl[0])
 	{
 		stop();
+		saveRecording();
+		waitRecordWriter();
 		OPLDestroy(opl[0]);
 		opl[0] = 0;
 	}
@@ -104,22 +195,114 @@ void AdlibMusic::load(SDL_RWops *rwops)
 }
 
 /**
- * Plays the contained music track.
+ * Gets the file the track is pre-rendered to, named
+ * after a hash of its data, volume and sample rate.
+ * @return Full path of the PCM cache file.
+ */
+std::string AdlibMusic::getCacheFile() const
+{
+	Uint32 hash = 2166136261u;
+	for (size_t i = 0; i < _size; ++i)
+	{
+		hash = (hash ^ (Uint8)_data[i]) * 16777619u;
+	}
+	std::ostringstream ss;
+	ss << Options::getMasterUserFolder() << "adlib/" << std::hex << std::setfill('0') << std::setw(8) << hash << "_" << std::dec << (int)(_volume * 100) << "_" << rate << ".wav";
+	return ss.str();
+}
+
+/**
+ * Plays the contained music track. With the PCM cache, the
+ * first time the track is played its output is recorded,
+ * and from then on it plays from the recording.
  * @param loop Amount of times to loop the track. -1 = infinite
  */
-void AdlibMusic::play(int) const
+void AdlibMusic::play(int loop) const
 {
 #ifndef __NO_MUSIC
 	if (!Options::mute)
 	{
 		stop();
-		func_setup_music((unsigned char*)_data, _size);
-		func_set_music_volume(127 * _volume);
-		Mix_HookMusic(player, (void*)this);
+		saveRecording();
+		if (Options::adlibPcmCache)
+		{
+			std::string file = getCacheFile();
+			if (!_pcm && CrossPlatform::fileExists(file))
+			{
+				try
+				{
+					_pcm = new Music();
+					_pcm->load(SDL_RWFromFile(file.c_str(), "rb"));
+				}
+				catch (Exception &e)
+				{
+					Log(LOG_WARNING) << file << ": " << e.what();
+					delete _pcm;
+					_pcm = 0;
+				}
+			}
+			if (_pcm)
+			{
+				_pcm->play(loop);
+				return;
+			}
+			// the player runs on the audio thread and must not allocate,
+			// so the longest recording is reserved up front
+			recorded.clear();
+			recorded.reserve((size_t)rate * 2 * MAX_RECORDING);
+			recordFile = file;
+			recordDone = false;
+			recording = true;
+		}
+		start();
 	}
 #endif
 }
 
+/**
+ * Starts the track from the beginning on the Adlib player.
+ */
+void AdlibMusic::start() const
+{
+#ifndef __NO_MUSIC
+	func_setup_music((unsigned char*)_data, _size);
+	func_set_music_volume(127 * _volume);
+	recordLoops = func_get_music_loops();
+	Mix_HookMusic(player, (void*)this);
+#endif
+}
+
+/**
+ * Hands the recorded track to a thread that writes it to
+ * its PCM cache file, if it was played through once.
+ * Must only be called with the player unhooked from the audio.
+ */
+void AdlibMusic::saveRecording()
+{
+	if (recording && recordDone && !recorded.empty())
+	{
+		std::string folder = Options::getMasterUserFolder() + "adlib/";
+		if (!CrossPlatform::folderExists(folder))
+		{
+			CrossPlatform::createFolder(folder);
+		}
+		Recording *finished = new Recording;
+		finished->file = recordFile;
+		finished->rate = rate;
+		finished->samples.swap(recorded);
+		// a track plays through at least once in between, so this rarely waits
+		waitRecordWriter();
+		recordWriter = SDL_CreateThread(writeRecording, (void*)finished);
+		if (recordWriter == 0)
+		{
+			writeRecording(finished);
+		}
+	}
+	recording = false;
+	recordDone = false;
+	std::vector<Sint16>().swap(recorded);
+}
+
 /**
  * Custom audio player.
  * @param udata User data to send to the player.
@@ -135,7 +318,7 @@ void AdlibMusic::player(void *udata, Uint8 *stream, int len)
 	if (Options::musicAlwaysLoop && !func_is_music_playing())
 	{
 		AdlibMusic *music = (AdlibMusic*)udata;
-		music->play();
+		music->start();
 		return;
 	}
 	while (len != 0)
@@ -146,8 +329,22 @@ void AdlibMusic::player(void *udata, Uint8 *stream, int len)
 		if (i)
 		{
 			float volume = Game::volumeExponent(Options::musicVolume);
-			YM3812UpdateOne(opl[0], (INT16*)stream, i / 2, 2, volume);
-			YM3812UpdateOne(opl[1], ((INT16*)stream) + 1, i / 2, 2, volume);
+			INT16 *full = NULL;
+			if (recording && !recordDone)
+			{
+				if (recorded.size() + i / 2 > recorded.capacity())
+				{
+					recording = false;
+				}
+				else
+				{
+					// record the same render at full volume, the cached track gets the music volume when played
+					recorded.resize(recorded.size() + i / 2);
+					full = (INT16*)&recorded[recorded.size() - i / 2];
+				}
+			}
+			YM3812UpdateOne(opl[0], (INT16*)stream, i / 2, 2, volume, full);
+			YM3812UpdateOne(opl[1], ((INT16*)stream) + 1, i / 2, 2, volume, full ? full + 1 : NULL);
 			stream += i;
 			delay -= i;
 			len -= i;
@@ -155,6 +352,11 @@ void AdlibMusic::player(void *udata, Uint8 *stream, int len)
 		if (!len)
 			return;
 		func_play_tick();
+		if (recording && (!func_is_music_playing() || func_get_music_loops() != recordLoops))
+		{
+			// played through once
+			recordDone = true;
+		}
 
 		delay = delayRates[rate];
 	}
@@ -20,6 +20,7 @@
 #include "Music.h"
 #include <map>
 #include <string>
+#include <vector>
 
 namespace OpenXcom
 {
@@ -34,8 +35,20 @@ private:
 	char *_data;
 	size_t _size;
 	float _volume;
+	mutable Music *_pcm;
 	static int delay, rate;
 	static std::map<int, int> delayRates;
+	static std::vector<Sint16> recorded;
+	static std::string recordFile;
+	static bool recording, recordDone;
+	static int recordLoops;
+
+	/// Gets the PCM cache file of the track.
+	std::string getCacheFile() const;
+	/// Starts the track on the Adlib player.
+	void start() const;
+	/// Saves the finished recording of a track.
+	static void saveRecording();
 public:
 	/// Creates a blank music track.
 	AdlibMusic(float volume = 1.0f);
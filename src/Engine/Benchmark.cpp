@@ -0,0 +1,130 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+#include "CrossPlatform.h"
+#include "Exception.h"
+#include "Logger.h"
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a benchmark suite. The suite name is used
+ * for the baseline file, benchmark_<suite>.yml.
+ * @param suite Suite name.
+ */
+Benchmark::Benchmark(const std::string &suite) : _suite(suite)
+{
+}
+
+/**
+ * Runs a piece of code once to warm up the caches, then the given
+ * number of times, timing every run on its own.
+ * @param name Name of the test.
+ * @param iterations Number of timed runs.
+ * @param code Code to time.
+ */
+void Benchmark::run(const std::string &name, int iterations, const std::function<void()> &code)
+{
+	iterations = std::max(1, iterations);
+	code();
+
+	std::vector<double> samples;
+	samples.reserve(iterations);
+	for (int i = 0; i < iterations; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		code();
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		samples.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+	}
+	std::sort(samples.begin(), samples.end());
+
+	Result result;
+	result.name = name;
+	result.iterations = iterations;
+	result.median = samples[samples.size() / 2];
+	result.p90 = samples[std::min(samples.size() - 1, samples.size() * 90 / 100)];
+	result.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+	_results.push_back(result);
+}
+
+/**
+ * Writes the results to the log, next to the medians of the baseline
+ * if there is one. Without a baseline, or if asked to, the results
+ * become the new baseline.
+ * @param saveBaseline Replace the baseline with these results.
+ * @return Summary of the results.
+ */
+std::string Benchmark::report(bool saveBaseline) const
+{
+	std::string filename = Options::getMasterUserFolder() + "benchmark_" + _suite + ".yml";
+	YAML::Node baseline;
+	if (CrossPlatform::fileExists(filename))
+	{
+		try
+		{
+			baseline = YAML::Load(*CrossPlatform::readFile(filename));
+		}
+		catch (Exception &e)
+		{
+			Log(LOG_WARNING) << filename << ": " << e.what();
+		}
+		catch (YAML::Exception &e)
+		{
+			Log(LOG_WARNING) << filename << ": " << e.what();
+		}
+	}
+	saveBaseline = saveBaseline || !baseline.IsMap();
+
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(0);
+	YAML::Node save;
+	for (const Result &r : _results)
+	{
+		ss << r.name << ": " << r.median << " us (p90 " << r.p90 << ", p99 " << r.p99 << ", " << r.iterations << " runs)";
+		double before = baseline.IsMap() ? baseline[r.name].as<double>(0.0) : 0.0;
+		if (before > 0.0)
+		{
+			ss << ", baseline " << before << " us (" << std::showpos << (r.median - before) * 100.0 / before << std::noshowpos << "%)";
+		}
+		ss << "\n";
+		save[r.name] = r.median;
+	}
+	Log(LOG_INFO) << "Benchmark " << _suite << ":\n" << ss.str();
+
+	if (saveBaseline)
+	{
+		YAML::Emitter out;
+		out << save;
+		if (CrossPlatform::writeFile(filename, out.c_str()))
+		{
+			Log(LOG_INFO) << "Benchmark baseline saved to " << filename;
+		}
+	}
+	return ss.str();
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace OpenXcom
+{
+
+/**
+ * Runs a set of named pieces of code repeatedly, keeps
+ * the median and percentile timings of each one, and compares
+ * them with a baseline stored in the user folder.
+ */
+class Benchmark
+{
+private:
+	struct Result
+	{
+		std::string name;
+		int iterations;
+		double median, p90, p99;
+	};
+	std::string _suite;
+	std::vector<Result> _results;
+public:
+	/// Creates an empty benchmark suite.
+	Benchmark(const std::string &suite);
+	/// Times a piece of code over a number of iterations.
+	void run(const std::string &name, int iterations, const std::function<void()> &code);
+	/// Logs the results, compared with the baseline.
+	std::string report(bool saveBaseline) const;
+};
+
+}
@@ -882,6 +882,34 @@ time_t getDateModified(const std::string &path)
 #endif
 }
 
+/**
+ * Gets the size of a file.
+ * @param path Full path to file.
+ * @return The size in bytes, or 0 if it can't be read.
+ */
+uint64_t getFileSize(const std::string &path)
+{
+#ifdef _WIN32
+	auto pathW = pathToWindows(path);
+	WIN32_FILE_ATTRIBUTE_DATA fad;
+	if (!GetFileAttributesExW(pathW.c_str(), GetFileExInfoStandard, &fad))
+	{
+		return 0;
+	}
+	return ((uint64_t)fad.nFileSizeHigh << 32) | fad.nFileSizeLow;
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) == 0)
+	{
+		return info.st_size;
+	}
+	else
+	{
+		return 0;
+	}
+#endif
+}
+
 /**
  * Converts a date/time into a human-readable string
  * using the ISO 8601 standard.
@@ -1514,6 +1542,14 @@ void log(int level, const std::ostringstream& baremsgstream) {
 			  << baremsgstream.str() << std::endl;
 	auto msg = msgstream.str();
 
+	// messages can come from worker threads too
+	static SDL_mutex *logMutex = SDL_CreateMutex();
+	struct LogLock
+	{
+		LogLock() { SDL_LockMutex(logMutex); }
+		~LogLock() { SDL_UnlockMutex(logMutex); }
+	} lock;
+
 	int effectiveLevel = Logger::reportingLevel();
 	if (effectiveLevel >= LOG_DEBUG) {
 		fwrite(msg.c_str(), msg.size(), 1, stderr);
@@ -23,6 +23,7 @@
 #include <vector>
 #include <array>
 #include <memory>
+#include <stdint.h>
 
 namespace OpenXcom
 {
@@ -83,6 +84,8 @@ namespace CrossPlatform
 	bool isQuitShortcut(const SDL_Event &ev);
 	/// Gets the modified date of a file.
 	time_t getDateModified(const std::string &path);
+	/// Gets the size of a file.
+	uint64_t getFileSize(const std::string &path);
 	/// Converts a timestamp to a string.
 	std::pair<std::string, std::string> timeToString(time_t time);
 	/// Move/rename a file between paths.
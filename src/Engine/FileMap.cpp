@@ -41,6 +41,7 @@
 #include <istream>
 #include <unordered_map>
 #include <unordered_set>
+#include <SDL_thread.h>
 
 #include "FileMap.h"
 #include "Unicode.h"
@@ -52,6 +53,28 @@
 #define MINIZ_NO_STDIO
 #include "../../libs/miniz/miniz.h"
 
+namespace
+{
+
+/**
+ * Zip archives are shared by every file in a mod, and miniz
+ * keeps per-archive decompression state, so only one thread
+ * at a time may extract from them.
+ */
+SDL_mutex *zipMutex()
+{
+	static SDL_mutex *mutex = SDL_CreateMutex();
+	return mutex;
+}
+
+struct ZipLock
+{
+	ZipLock() { SDL_LockMutex(zipMutex()); }
+	~ZipLock() { SDL_UnlockMutex(zipMutex()); }
+};
+
+}
+
 extern "C"
 {
 
@@ -66,6 +89,7 @@ int mzops_close(struct SDL_RWops *context) {
 }
 SDL_RWops *SDL_RWFromMZ(mz_zip_archive *zip, mz_uint file_index) {
 	size_t size;
+	ZipLock lock;
 	void *data = mz_zip_reader_extract_to_heap(zip, file_index, &size, 0);
 	if (data == NULL) {
 		SDL_SetError("miniz extract: %s", mz_zip_get_error_string(mz_zip_get_last_error(zip)));
@@ -266,6 +290,7 @@ std::unique_ptr<std::istream> FileRecord::getIStream() const
 {
 	if (zip != NULL) {
 		size_t size;
+		ZipLock lock;
 		void *data = mz_zip_reader_extract_to_heap((mz_zip_archive *)zip, findex, &size, 0);
 		if (data == NULL) {
 			auto err = "FileRecord::getIStream(): failed to decompress " + fullpath + ": ";
@@ -79,7 +79,11 @@ enum PlayingState
 	SKIPPED
 };
 
-FlcPlayer::FlcPlayer() : _fileBuf(0), _mainScreen(0), _realScreen(0), _game(0)
+std::string FlcPlayer::_cachedName;
+std::vector<FlcPlayer::Frame> FlcPlayer::_cachedFrames;
+
+FlcPlayer::FlcPlayer() : _fileBuf(0), _decodingFrame(0), _decoder(0), _freeFrames(0), _readyFrames(0), _stopDecoding(false), _nextShown(0),
+	_playingCache(false), _recording(false), _recordingSize(0), _mainScreen(0), _realScreen(0), _game(0)
 {
 	_volume = Game::volumeExponent(std::max(Options::musicVolume, Options::soundVolume));
 }
@@ -113,6 +117,7 @@ bool FlcPlayer::init(const char *filename, void(*frameCallBack)(), bool customCu
 	_customCutscene = customCutscene;
 	_dx = dx;
 	_dy = dy;
+	_fileName = filename;
 
 	_fileSize = 0;
 	_frameCount = 0;
@@ -142,6 +147,8 @@ bool FlcPlayer::init(const char *filename, void(*frameCallBack)(), bool customCu
 		_screenDepth = 8;
 
 		Log(LOG_INFO) << "Playing flx, " << _screenWidth << "x" << _screenHeight << ", " << _headerFrames << " frames";
+		// frames are decoded in here and then copied to the screen, so it can happen ahead of time
+		_canvas.assign(_screenWidth * _screenHeight, 0);
 	}
 	else
 	{
@@ -205,6 +212,8 @@ void FlcPlayer::play(bool skipLastFrame)
 	_videoFrameData = _fileBuf + 128;
 	_audioFrameData = _videoFrameData;
 
+	startDecoding();
+
 	while (!shouldQuit())
 	{
 		if (_frameCallBack)
@@ -219,6 +228,154 @@ void FlcPlayer::play(bool skipLastFrame)
 			SDLPolling();
 	}
 
+	stopDecoding();
+}
+
+/**
+ * Entry point of the thread decoding frames ahead of playback.
+ * @param data Pointer to the player.
+ * @return Always 0.
+ */
+int FlcPlayer::decodeThread(void *data)
+{
+	FlcPlayer *player = (FlcPlayer*)data;
+	for (int i = 0; ; i = (i + 1) % FRAME_BUFFERS)
+	{
+		SDL_SemWait(player->_freeFrames);
+		if (player->_stopDecoding)
+		{
+			break;
+		}
+		Frame &frame = player->_frames[i];
+		player->decodeFrame(frame);
+		SDL_SemPost(player->_readyFrames);
+		if (frame.end || frame.last)
+		{
+			break;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Starts decoding frames on a separate thread, so the main loop only has
+ * to copy them to the screen. If the same video was just played in full
+ * and kept in the cache, it's played from there instead.
+ * Without threads, frames are decoded as they're needed.
+ */
+void FlcPlayer::startDecoding()
+{
+	_nextShown = 0;
+	_playingCache = !_cachedFrames.empty() && _cachedName == _fileName;
+	_recording = !_playingCache && Options::cutsceneCacheSize > 0;
+	_recordingSize = 0;
+	_recordedFrames.clear();
+	if (_playingCache)
+	{
+		return;
+	}
+
+	_stopDecoding = false;
+	_freeFrames = SDL_CreateSemaphore(FRAME_BUFFERS);
+	_readyFrames = SDL_CreateSemaphore(0);
+	if (_freeFrames && _readyFrames)
+	{
+		_decoder = SDL_CreateThread(decodeThread, (void*)this);
+	}
+	if (_decoder == 0)
+	{
+		Log(LOG_WARNING) << "Couldn't start the video decoding thread, decoding on the fly";
+	}
+}
+
+/**
+ * Stops the decoding thread and keeps the video in the cache
+ * if it was played to the end and fits.
+ */
+void FlcPlayer::stopDecoding()
+{
+	if (_decoder)
+	{
+		_stopDecoding = true;
+		SDL_SemPost(_freeFrames);
+		SDL_WaitThread(_decoder, 0);
+		_decoder = 0;
+	}
+	if (_freeFrames)
+	{
+		SDL_DestroySemaphore(_freeFrames);
+		_freeFrames = 0;
+	}
+	if (_readyFrames)
+	{
+		SDL_DestroySemaphore(_readyFrames);
+		_readyFrames = 0;
+	}
+
+	if (_recording && !_recordedFrames.empty() && (_recordedFrames.back().last || _recordedFrames.back().end))
+	{
+		_cachedName = _fileName;
+		_cachedFrames.swap(_recordedFrames);
+		Log(LOG_INFO) << "Keeping " << _fileName << " decoded in memory (" << _recordingSize / 1024 << " KB)";
+	}
+	_recordedFrames.clear();
+	_recording = false;
+}
+
+/**
+ * Gets the next decoded frame, waiting for it if needed.
+ * @return Frame to show.
+ */
+const FlcPlayer::Frame &FlcPlayer::nextFrame()
+{
+	if (_playingCache)
+	{
+		return _cachedFrames[std::min<size_t>(_nextShown, _cachedFrames.size() - 1)];
+	}
+	if (_decoder)
+	{
+		SDL_SemWait(_readyFrames);
+		return _frames[_nextShown];
+	}
+	decodeFrame(_frames[0]);
+	return _frames[0];
+}
+
+/**
+ * Hands the current frame back to the decoder.
+ */
+void FlcPlayer::releaseFrame()
+{
+	if (_playingCache)
+	{
+		++_nextShown;
+	}
+	else if (_decoder)
+	{
+		_nextShown = (_nextShown + 1) % FRAME_BUFFERS;
+		SDL_SemPost(_freeFrames);
+	}
+}
+
+/**
+ * Keeps a copy of a frame for the cache, until the video
+ * turns out to be bigger than the cache allows.
+ * @param frame Decoded frame.
+ */
+void FlcPlayer::recordFrame(const Frame &frame)
+{
+	if (!_recording)
+	{
+		return;
+	}
+	_recordingSize += frame.pixels.size() + frame.colors.size() * sizeof(SDL_Color);
+	if (_recordingSize > (size_t)Options::cutsceneCacheSize * 1024 * 1024)
+	{
+		_recording = false;
+		_recordedFrames.clear();
+		return;
+	}
+	_recordedFrames.push_back(frame);
 }
 
 void FlcPlayer::delay(Uint32 milliseconds)
@@ -312,7 +469,7 @@ void FlcPlayer::decodeAudio(int frames)
 
 				readU16(sampleRate, _audioFrameData + 8);
 
-				_chunkData = _audioFrameData + 16;
+				_audioChunkData = _audioFrameData + 16;
 
 				playAudioFrame(sampleRate);
 
@@ -327,54 +484,118 @@ void FlcPlayer::decodeAudio(int frames)
 
 void FlcPlayer::decodeVideo(bool skipLastFrame)
 {
-	bool videoFrameFound = false;
+	const Frame &frame = nextFrame();
+	recordFrame(frame);
+
+	if (frame.end)
+	{
+		_playingState = FINISHED;
+		releaseFrame();
+		return;
+	}
 
-	while (!videoFrameFound)
+	Uint32 delay;
+
+	if (_headerType == FLI_TYPE)
+	{
+		delay = frame.delayOverride > 0 ? frame.delayOverride : _headerSpeed * (1000.0 / 70.0);
+	}
+	else if (_useInternalAudio && !_frameCallBack) // this means TFTD videos are playing
+	{
+		delay = _videoDelay;
+	}
+	else
+	{
+		delay = _headerSpeed;
+	}
+
+	waitForNextFrame(delay);
+
+	// If this frame is the last one, don't play it
+	if (frame.last)
+		_playingState = FINISHED;
+
+	if (!shouldQuit() || !skipLastFrame)
+		playVideoFrame(frame);
+
+	releaseFrame();
+}
+
+/**
+ * Decodes the next video frame of the file into the canvas and copies
+ * it into a frame buffer. Runs on the decoding thread when there is one.
+ * @param frame Frame buffer to fill.
+ */
+void FlcPlayer::decodeFrame(Frame &frame)
+{
+	frame.colors.clear();
+	frame.palette.clear();
+	frame.delayOverride = 0;
+	frame.last = false;
+	frame.end = false;
+
+	while (true)
 	{
 		if (!isValidFrame(_videoFrameData, _videoFrameSize, _videoFrameType))
 		{
-			_playingState = FINISHED;
-			break;
+			frame.end = true;
+			return;
 		}
 
 		switch (_videoFrameType)
 		{
 		case FRAME_TYPE:
-
-			Uint32 delay;
-
 			readU16(_frameChunks, _videoFrameData + 6);
-			readU16(_delayOverride, _videoFrameData + 8);
-
-			if (_headerType == FLI_TYPE)
-			{
-				delay = _delayOverride > 0 ? _delayOverride : _headerSpeed * (1000.0 / 70.0);
-			}
-			else if (_useInternalAudio && !_frameCallBack) // this means TFTD videos are playing
-			{
-				delay = _videoDelay;
-			}
-			else
-			{
-				delay = _headerSpeed;
-			}
-
-			waitForNextFrame(delay);
+			readU16(frame.delayOverride, _videoFrameData + 8);
 
 			// Skip the frame header, we are not interested in the rest
 			_chunkData = _videoFrameData + 16;
 
 			_videoFrameData += _videoFrameSize;
-			// If this frame is the last one, don't play it
-			if(isEndOfFile(_videoFrameData))
-				_playingState = FINISHED;
+			frame.last = isEndOfFile(_videoFrameData);
 
-			if(!shouldQuit() || !skipLastFrame)
-				playVideoFrame();
+			_decodingFrame = &frame;
+			for (int i = 0; i < _frameChunks; ++i)
+			{
+				readU32(_chunkSize, _chunkData);
+				readU16(_chunkType, _chunkData + 4);
 
-			videoFrameFound = true;
+				switch (_chunkType)
+				{
+					case COLOR_256:
+						color256();
+						break;
+					case FLI_SS2:
+						fliSS2();
+						break;
+					case COLOR_64:
+						color64();
+						break;
+					case FLI_LC:
+						fliLC();
+						break;
+					case BLACK:
+						black();
+						break;
+					case FLI_BRUN:
+						fliBRun();
+						break;
+					case FLI_COPY:
+						fliCopy();
+						break;
+					case 18:
+						break;
+					default:
+						Log(LOG_WARNING) << "Ieek an non implemented chunk type:" << _chunkType;
+						break;
+				}
 
-			break;
+				_chunkData += _chunkSize;
+			}
+			_decodingFrame = 0;
+
+			frame.pixels = _canvas;
+			return;
 		case AUDIO_CHUNK:
 			_videoFrameData += _videoFrameSize + 16;
 			break;
@@ -387,49 +608,43 @@ void FlcPlayer::decodeVideo(bool skipLastFrame)
 	}
 }
 
-void FlcPlayer::playVideoFrame()
+/**
+ * Keeps the colors just read by a palette chunk for
+ * when the frame being decoded is shown.
+ * @param firstColor First color to replace.
+ * @param numColors Number of colors, read into _colors.
+ */
+void FlcPlayer::addPalette(int firstColor, int numColors)
+{
+	_decodingFrame->colors.insert(_decodingFrame->colors.end(), _colors, _colors + numColors);
+	_decodingFrame->palette.push_back(std::make_pair(firstColor, numColors));
+}
+
+/**
+ * Copies a decoded frame to the screen, along with its palette changes.
+ * @param frame Decoded frame.
+ */
+void FlcPlayer::playVideoFrame(const Frame &frame)
 {
 	++_frameCount;
-	if (SDL_LockSurface(_mainScreen) < 0)
-		return;
-	int chunkCount = _frameChunks;
 
-	for (int i = 0; i < chunkCount; ++i)
+	SDL_Color *colors = const_cast<SDL_Color*>(frame.colors.data());
+	for (std::vector<std::pair<int, int> >::const_iterator i = frame.palette.begin(); i != frame.palette.end(); ++i)
 	{
-		readU32(_chunkSize, _chunkData);
-		readU16(_chunkType, _chunkData + 4);
+		if (_mainScreen != _realScreen->getSurface())
+			SDL_SetColors(_mainScreen, colors, i->first, i->second);
+		_realScreen->setPalette(colors, i->first, i->second, true);
+		colors += i->second;
+	}
 
-		switch (_chunkType)
-		{
-			case COLOR_256:
-				color256();
-				break;
-			case FLI_SS2:
-				fliSS2();
-				break;
-			case COLOR_64:
-				color64();
-				break;
-			case FLI_LC:
-				fliLC();
-				break;
-			case BLACK:
-				black();
-				break;
-			case FLI_BRUN:
-				fliBRun();
-				break;
-			case FLI_COPY:
-				fliCopy();
-				break;
-			case 18:
-				break;
-			default:
-				Log(LOG_WARNING) << "Ieek an non implemented chunk type:" << _chunkType;
-				break;
-		}
+	if (SDL_LockSurface(_mainScreen) < 0)
+		return;
 
-		_chunkData += _chunkSize;
+	int lines = std::min(_screenHeight, _mainScreen->h - _dy);
+	int width = std::min(_screenWidth, _mainScreen->w - _dx);
+	for (int y = 0; y < lines && width > 0; ++y)
+	{
+		memcpy((Uint8*)_mainScreen->pixels + _offset + y * _mainScreen->pitch, &frame.pixels[y * _screenWidth], width);
 	}
 
 	SDL_UnlockSurface(_mainScreen);
@@ -480,7 +695,7 @@ void FlcPlayer::playAudioFrame(Uint16 sampleRate)
 
 		for (unsigned int i = 0; i < _audioFrameSize; i++)
 		{
-			loadingBuff->samples[loadingBuff->sampleCount + i] = (float)((_chunkData[i]) -128) * 240 * _volume;
+			loadingBuff->samples[loadingBuff->sampleCount + i] = (float)((_audioChunkData[i]) -128) * 240 * _volume;
 		}
 		loadingBuff->sampleCount += _audioFrameSize;
 
@@ -519,9 +734,7 @@ void FlcPlayer::color256()
 			_colors[i].b = *(pSrc++);
 		}
 
-		if (_mainScreen != _realScreen->getSurface())
-			SDL_SetColors(_mainScreen, _colors, numColorsSkip, numColors);
-		_realScreen->setPalette(_colors, numColorsSkip, numColors, true);
+		addPalette(numColorsSkip, numColors);
 
 		if (numColorPackets >= 1)
 		{
@@ -541,7 +754,7 @@ void FlcPlayer::fliSS2()
 	Uint8 lastByte = 0;
 
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas.data();
 	readU16(lines, pSrc);
 
 	pSrc += 2;
@@ -553,7 +766,7 @@ void FlcPlayer::fliSS2()
 
 		if ((count & MASK) == SKIP_LINES)
 		{
-			pDst += (-count)*_mainScreen->pitch;
+			pDst += (-count)*_screenWidth;
 			++lines;
 			continue;
 		}
@@ -602,9 +815,9 @@ void FlcPlayer::fliSS2()
 			if (setLastByte)
 			{
 				setLastByte = false;
-				*(pDst + _mainScreen->pitch - 1) = lastByte;
+				*(pDst + _screenWidth - 1) = lastByte;
 			}
-			pDst += _mainScreen->pitch;
+			pDst += _screenWidth;
 		}
 	}
 }
@@ -617,7 +830,7 @@ void FlcPlayer::fliBRun()
 
 	heightCount = _headerHeight;
 	pSrc = _chunkData + 6; // Skip chunk header
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas.data();
 
 	while (heightCount--)
 	{
@@ -649,7 +862,7 @@ void FlcPlayer::fliBRun()
 				}
 			}
 		}
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -664,11 +877,11 @@ void FlcPlayer::fliLC()
 	int packetsCount;
 
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas.data();
 
 	readU16(tmp, pSrc);
 	pSrc += 2;
-	pDst += tmp*_mainScreen->pitch;
+	pDst += tmp*_screenWidth;
 	readU16(lines, pSrc);
 	pSrc += 2;
 
@@ -703,7 +916,7 @@ void FlcPlayer::fliLC()
 				}
 			}
 		}
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -734,9 +947,7 @@ void FlcPlayer::color64()
 			_colors[i].b = *(pSrc++) << 2;
 		}
 
-		if (_mainScreen != _realScreen->getSurface())
-			SDL_SetColors(_mainScreen, _colors, NumColorsSkip, NumColors);
-		_realScreen->setPalette(_colors, NumColorsSkip, NumColors, true);
+		addPalette(NumColorsSkip, NumColors);
 	}
 }
 
@@ -745,13 +956,13 @@ void FlcPlayer::fliCopy()
 	Uint8 *pSrc, *pDst;
 	int Lines = _screenHeight;
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas.data();
 
 	while (Lines--)
 	{
 		memcpy(pDst, pSrc, _screenWidth);
 		pSrc += _screenWidth;
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -759,12 +970,12 @@ void FlcPlayer::black()
 {
 	Uint8 *pDst;
 	int Lines = _screenHeight;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas.data();
 
 	while (Lines-- > 0)
 	{
 		memset(pDst, 0, _screenHeight);
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -23,6 +23,10 @@
  * Based on http://www.libsdl.org/projects/flxplay/
  */
 #include <SDL.h>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace OpenXcom
 {
@@ -33,12 +37,25 @@ class Game;
 class FlcPlayer
 {
 private:
+	/// Number of frames decoded ahead of the one on screen.
+	static const int FRAME_BUFFERS = 4;
+
+	/// A decoded video frame, with the palette changes that come with it.
+	struct Frame
+	{
+		std::vector<Uint8> pixels;
+		std::vector<SDL_Color> colors;
+		std::vector<std::pair<int, int> > palette;
+		Uint16 delayOverride;
+		bool last, end;
+	};
 
 	Uint8 *_fileBuf;
 	Uint32 _fileSize;
 	Uint8 *_videoFrameData;
 	Uint8 *_chunkData;
 	Uint8 *_audioFrameData;
+	Uint8 *_audioChunkData;
 	Uint16 _frameCount;    /* Frame Counter */
 	Uint32 _headerSize;    /* Fli file size */
 	Uint16 _headerType;    /* Fli header check */
@@ -58,6 +75,21 @@ private:
 
 	void (*_frameCallBack)();
 
+	std::string _fileName;
+	std::vector<Uint8> _canvas;
+	Frame _frames[FRAME_BUFFERS];
+	Frame *_decodingFrame;
+	SDL_Thread *_decoder;
+	SDL_sem *_freeFrames, *_readyFrames;
+	std::atomic<bool> _stopDecoding;
+	int _nextShown;
+	bool _playingCache, _recording;
+	size_t _recordingSize;
+	std::vector<Frame> _recordedFrames;
+
+	static std::string _cachedName;
+	static std::vector<Frame> _cachedFrames;
+
 	SDL_Surface *_mainScreen;
 	Screen *_realScreen;
 	SDL_Color _colors[256];
@@ -101,12 +133,20 @@ private:
 
 	bool isValidFrame(Uint8 *frameHeader, Uint32 &frameSize, Uint16 &frameType);
 	void decodeVideo(bool skipLastFrame);
+	void decodeFrame(Frame &frame);
+	static int decodeThread(void *data);
+	void startDecoding();
+	void stopDecoding();
+	const Frame &nextFrame();
+	void releaseFrame();
+	void recordFrame(const Frame &frame);
+	void addPalette(int firstColor, int numColors);
 	void decodeAudio(int frames);
 	void waitForNextFrame(Uint32 delay);
 	void SDLPolling();
 	bool shouldQuit();
 
-	void playVideoFrame();
+	void playVideoFrame(const Frame &frame);
 	void color256();
 	void fliBRun();
 	void fliCopy();
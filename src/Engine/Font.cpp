@@ -30,7 +30,7 @@ const SDL_Color Font::TerminalColors[2] = {{0, 0, 0, 0}, {185, 185, 185, 255}};
 /**
  * Initializes the font with a blank surface.
  */
-Font::Font() : _monospace(false)
+Font::Font() : _denseChars(DENSE_CHARS, 0), _fallbackChar(0), _monospace(false)
 {
 }
 
@@ -163,6 +163,41 @@ void Font::init(size_t index, const UString &str)
 		}
 	}
 	surface->unlock();
+
+	// Map elements never move, so the common characters can point straight at them
+	for (size_t i = 0; i < str.length(); ++i)
+	{
+		if (str[i] < DENSE_CHARS)
+		{
+			_denseChars[str[i]] = &_chars[str[i]];
+		}
+	}
+	auto f = _chars.find('?');
+	if (f != _chars.end())
+	{
+		_fallbackChar = &f->second;
+	}
+	_runs.clear();
+}
+
+/**
+ * Looks up a character in the font, skipping the hash
+ * lookup for the ranges most languages use.
+ * @param c Character to look up.
+ * @return Surface index and position of the character,
+ * or of the placeholder if the font doesn't have it.
+ */
+const std::pair<size_t, SDL_Rect> *Font::findChar(UCode c) const
+{
+	if (c < DENSE_CHARS)
+	{
+		const std::pair<size_t, SDL_Rect> *ch = _denseChars[c];
+		return ch ? ch : _fallbackChar;
+	}
+	auto f = _chars.find(c);
+	if (f == _chars.end())
+		return _fallbackChar;
+	return &f->second;
 }
 
 /**
@@ -173,11 +208,9 @@ void Font::init(size_t index, const UString &str)
  */
 SurfaceCrop Font::getChar(UCode c) const
 {
-	auto f = _chars.find(c);
-	if (f == _chars.end())
-		f = _chars.find('?');
-	auto surfaceCrop = _images[f->second.first].surface->getCrop();
-	*surfaceCrop.getCrop() = f->second.second;
+	const std::pair<size_t, SDL_Rect> *f = findChar(c);
+	auto surfaceCrop = _images[f->first].surface->getCrop();
+	*surfaceCrop.getCrop() = f->second;
 	return surfaceCrop;
 }
 
@@ -220,13 +253,10 @@ SDL_Rect Font::getCharSize(UCode c) const
 	SDL_Rect size = { 0, 0, 0, 0 };
 	if (Unicode::isPrintable(c))
 	{
-		auto f = _chars.find(c);
-		if (f == _chars.end())
-			f = _chars.find('?');
-
-		const FontImage *image = &_images[f->second.first];
-		size.w = f->second.second.w + image->spacing;
-		size.h = f->second.second.h + image->spacing;
+		const std::pair<size_t, SDL_Rect> *f = findChar(c);
+		const FontImage *image = &_images[f->first];
+		size.w = f->second.w + image->spacing;
+		size.h = f->second.h + image->spacing;
 	}
 	else
 	{
@@ -246,4 +276,33 @@ SDL_Rect Font::getCharSize(UCode c) const
 	return size;
 }
 
+/**
+ * Returns a previously laid out string, so texts showing
+ * the same thing don't have to measure and wrap it again.
+ * @param key Text and layout settings, as built by Text.
+ * @return Layout, or null if it isn't cached.
+ */
+std::shared_ptr<const TextRun> Font::getRun(const std::string &key) const
+{
+	auto f = _runs.find(key);
+	if (f == _runs.end())
+		return nullptr;
+	return f->second;
+}
+
+/**
+ * Stores a laid out string for reuse. Once the cache is full
+ * it simply starts over, texts keep their own copy anyway.
+ * @param key Text and layout settings, as built by Text.
+ * @param run Layout.
+ */
+void Font::addRun(const std::string &key, std::shared_ptr<const TextRun> run)
+{
+	if (_runs.size() >= MAX_RUNS)
+	{
+		_runs.clear();
+	}
+	_runs[key] = run;
+}
+
 }
@@ -20,6 +20,8 @@
 #include <unordered_map>
 #include <vector>
 #include <utility>
+#include <memory>
+#include <string>
 #include <SDL.h>
 #include <yaml-cpp/yaml.h>
 #include "Unicode.h"
@@ -38,6 +40,25 @@ struct FontImage
 	Surface *surface;
 };
 
+/// A character of a TextRun, ready to be drawn.
+struct TextGlyph
+{
+	SurfaceCrop chr;
+	int offset, width, line;
+	bool secondary;
+};
+
+/**
+ * Line breaks and character positions of a string laid out
+ * in a font, shared by every Text showing the same string.
+ */
+struct TextRun
+{
+	UString text;
+	std::vector<int> lineWidth, lineHeight;
+	std::vector<TextGlyph> glyphs;
+};
+
 /**
  * Takes care of loading and storing each character in a sprite font.
  * Sprite fonts consist of a set of characters split in fixed-size regions.
@@ -49,10 +70,19 @@ class Font
 private:
 	std::vector<FontImage> _images;
 	std::unordered_map< UCode, std::pair<size_t, SDL_Rect> > _chars;
+	std::vector<const std::pair<size_t, SDL_Rect>*> _denseChars;
+	const std::pair<size_t, SDL_Rect> *_fallbackChar;
+	std::unordered_map< std::string, std::shared_ptr<const TextRun> > _runs;
 	bool _monospace;
 	/// Determines the size and position of each character in the font.
 	void init(size_t index, const UString &str);
+	/// Finds a character, or the placeholder if it's missing.
+	const std::pair<size_t, SDL_Rect> *findChar(UCode c) const;
 public:
+	/// Characters looked up directly instead of hashed, covering Latin and Cyrillic.
+	static const UCode DENSE_CHARS = 0x500;
+	/// Maximum number of text layouts kept per font.
+	static const size_t MAX_RUNS = 4096;
 
 	/// Default palette for terminal text.
 	static const SDL_Color TerminalColors[2];
@@ -75,6 +105,10 @@ public:
 	int getSpacing() const;
 	/// Gets the size of a particular character;
 	SDL_Rect getCharSize(UCode c) const;
+	/// Gets a cached text layout.
+	std::shared_ptr<const TextRun> getRun(const std::string &key) const;
+	/// Stores a text layout in the cache.
+	void addRun(const std::string &key, std::shared_ptr<const TextRun> run);
 };
 
 }
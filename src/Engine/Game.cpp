@@ -30,6 +30,7 @@
 #include "Logger.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/FpsCounter.h"
+#include "../Interface/ProfilerOverlay.h"
 #include "../Mod/Mod.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
@@ -37,6 +38,7 @@
 #include "Action.h"
 #include "Exception.h"
 #include "Options.h"
+#include "Profiler.h"
 #include "CrossPlatform.h"
 #include "FileMap.h"
 #include "Unicode.h"
@@ -101,6 +103,10 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
 	// Create fps counter
 	_fpsCounter = new FpsCounter(15, 5, 0, 0);
 
+	// Create profiler overlay, its text is set up when it's first shown
+	_profilerOverlay = new ProfilerOverlay(160, 8 * PROFILE_ZONES, 0, 8);
+	_profilerOverlay->setVisible(false);
+
 	// Create blank language
 	_lang = new Language();
 
@@ -131,6 +137,7 @@ Game::~Game()
 	delete _mod;
 	delete _screen;
 	delete _fpsCounter;
+	delete _profilerOverlay;
 
 	Mix_CloseAudio();
 
@@ -153,6 +160,12 @@ void Game::run()
 	Sint16 xrel = 0;
 	Sint16 yrel = 0;
 
+	if (Options::profiler)
+	{
+		Options::profiler = false;
+		toggleProfiler();
+	}
+
 	while (!_quit)
 	{
 		// Clean up states
@@ -185,6 +198,7 @@ void Game::run()
 		// Process events
 		while (SDL_PollEvent(&_event))
 		{
+			ProfileScope scope(PROFILE_HANDLE);
 			if (CrossPlatform::isQuitShortcut(_event))
 				_event.type = SDL_QUIT;
 			switch (_event.type)
@@ -279,6 +293,12 @@ void Game::run()
 					Action action = Action(&_event, _screen->getXScale(), _screen->getYScale(), _screen->getCursorTopBlackBand(), _screen->getCursorLeftBlackBand());
 					_screen->handle(&action);
 					_cursor->handle(&action);
+					// "ctrl-<fps key>" profiler overlay
+					if (action.getDetails()->type == SDL_KEYDOWN && action.getDetails()->key.keysym.sym == Options::keyFps && isCtrlPressed())
+					{
+						toggleProfiler();
+						continue;
+					}
 					_fpsCounter->handle(&action);
 					if (action.getDetails()->type == SDL_KEYDOWN)
 					{
@@ -335,8 +355,12 @@ void Game::run()
 		if (runningState != PAUSED)
 		{
 			// Process logic
-			_states.back()->think();
+			{
+				ProfileScope scope(PROFILE_THINK);
+				_states.back()->think();
+			}
 			_fpsCounter->think();
+			_profilerOverlay->think();
 			if (Options::FPS > 0 && !(Options::useOpenGL && Options::vSyncForOpenGL))
 			{
 				// Update our FPS delay time based on the time of the last draw.
@@ -362,13 +386,21 @@ void Game::run()
 				}
 				while (i != _states.begin() && !(*i)->isScreen());
 
-				for (; i != _states.end(); ++i)
 				{
-					(*i)->blit();
+					ProfileScope scope(PROFILE_BLIT);
+					for (; i != _states.end(); ++i)
+					{
+						(*i)->blit();
+					}
 				}
 				_fpsCounter->blit(_screen->getSurface());
+				_profilerOverlay->blit(_screen->getSurface());
 				_cursor->blit(_screen->getSurface());
-				_screen->flip();
+				{
+					ProfileScope scope(PROFILE_FLIP);
+					_screen->flip();
+				}
+				Profiler::endFrame();
 			}
 		}
 
@@ -386,6 +418,34 @@ void Game::run()
 	Options::save();
 }
 
+/**
+ * Turns the profiler on or off. Turning it off writes the
+ * recorded frames to profile.csv in the user folder.
+ */
+void Game::toggleProfiler()
+{
+	if (Profiler::isEnabled())
+	{
+		std::string filename = Options::getMasterUserFolder() + "profile.csv";
+		if (Profiler::dumpCsv(filename))
+		{
+			Log(LOG_INFO) << "Profiler data saved to " << filename;
+		}
+		Profiler::setEnabled(false);
+		_profilerOverlay->setVisible(false);
+	}
+	else
+	{
+		if (_mod)
+		{
+			_profilerOverlay->initText(_mod->getFont("FONT_BIG"), _mod->getFont("FONT_SMALL"), _lang);
+		}
+		Profiler::setEnabled(true);
+		_profilerOverlay->setVisible(true);
+	}
+	Options::profiler = Profiler::isEnabled();
+}
+
 /**
  * Stops the state machine and the game is shut down.
  */
@@ -659,6 +719,7 @@ void Game::loadLanguages()
 	_lang->loadRule(_mod->getExtraStrings(), defaultLang);
 	if (twoLangs)
 		_lang->loadRule(_mod->getExtraStrings(), currentLang);
+	_lang->compile();
 }
 
 /**
@@ -33,6 +33,7 @@ class Mod;
 class MasterMind;
 class ModInfo;
 class FpsCounter;
+class ProfilerOverlay;
 class Action;
 
 /**
@@ -54,6 +55,7 @@ private:
 	MasterMind *_mind;
 	bool _quit, _init, _update;
 	FpsCounter *_fpsCounter;
+	ProfilerOverlay *_profilerOverlay;
 	bool _mouseActive;
 	unsigned int _timeOfLastFrame;
 	int _timeUntilNextFrame;
@@ -79,6 +81,10 @@ public:
 	Cursor *getCursor() const { return _cursor; }
 	/// Gets the FpsCounter.
 	FpsCounter *getFpsCounter() const { return _fpsCounter; }
+	/// Gets the profiler overlay.
+	ProfilerOverlay *getProfilerOverlay() const { return _profilerOverlay; }
+	/// Turns the profiler and its overlay on or off.
+	void toggleProfiler();
 	/// Resets the state stack to a new state.
 	void setState(State *state);
 	/// Pushes a new state into the state stack.
@@ -206,7 +206,7 @@ void Language::loadFile(const FileMap::FileRecord *frec)
 			if (!value.empty())
 			{
 				std::string key = i->first.as<std::string>();
-				_strings[key] = loadString(value);
+				_loading[key] = loadString(value);
 			}
 		}
 		// Strings with plurality
@@ -218,7 +218,7 @@ void Language::loadFile(const FileMap::FileRecord *frec)
 				if (!value.empty())
 				{
 					std::string key = i->first.as<std::string>() + "_" + j->first.as<std::string>();
-					_strings[key] = loadString(value);
+					_loading[key] = loadString(value);
 				}
 			}
 		}
@@ -238,11 +238,123 @@ void Language::loadRule(const std::map<std::string, ExtraStrings*> &extraStrings
 		ExtraStrings *extras = it->second;
 		for (std::map<std::string, std::string>::const_iterator i = extras->getStrings()->begin(); i != extras->getStrings()->end(); ++i)
 		{
-			_strings[i->first] = loadString(i->second);
+			_loading[i->first] = loadString(i->second);
 		}
 	}
 }
 
+/**
+ * Packs all the loaded strings and their IDs into a single block
+ * of memory, indexed by an open-addressed hash table, so lookups
+ * don't have to walk a tree of separately allocated strings.
+ * Strings loaded afterwards need another call to show up.
+ */
+void Language::compile()
+{
+	// Keep what was compiled before, unless it was overridden since
+	for (std::vector<Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		_loading.insert(std::make_pair(_arena.substr(i->key, i->keyLength), _arena.substr(i->value, i->valueLength)));
+	}
+
+	size_t mapSize = 0, size = 0;
+	for (std::map<std::string, std::string>::const_iterator i = _loading.begin(); i != _loading.end(); ++i)
+	{
+		// Rough size of a tree node with two strings, plus their text when it doesn't fit inline
+		mapSize += 4 * sizeof(void*) + sizeof(std::string) + sizeof(LocalizedText);
+		mapSize += (i->first.size() > 15 ? i->first.size() + 1 : 0) + (i->second.size() > 15 ? i->second.size() + 1 : 0);
+		size += i->first.size() + i->second.size();
+	}
+
+	size_t indexSize = 1;
+	while (indexSize < _loading.size() * 2)
+	{
+		indexSize *= 2;
+	}
+	std::string arena;
+	arena.reserve(size);
+	std::vector<Entry> entries;
+	entries.reserve(_loading.size());
+	std::vector<uint32_t> index(indexSize, 0);
+	for (std::map<std::string, std::string>::const_iterator i = _loading.begin(); i != _loading.end(); ++i)
+	{
+		Entry entry;
+		entry.hash = hashId(i->first);
+		entry.key = arena.size();
+		entry.keyLength = i->first.size();
+		arena += i->first;
+		entry.value = arena.size();
+		entry.valueLength = i->second.size();
+		arena += i->second;
+		entries.push_back(entry);
+
+		size_t slot = entry.hash & (indexSize - 1);
+		while (index[slot] != 0)
+		{
+			slot = (slot + 1) & (indexSize - 1);
+		}
+		// 0 marks an empty slot
+		index[slot] = entries.size();
+	}
+	_arena.swap(arena);
+	_entries.swap(entries);
+	_index.swap(index);
+	_loading.clear();
+
+	size_t packedSize = _arena.capacity() + _entries.capacity() * sizeof(Entry) + _index.capacity() * sizeof(uint32_t);
+	Log(LOG_INFO) << "Language " << Options::language << ": " << _entries.size() << " strings in " << packedSize / 1024 << " KB (about " << mapSize / 1024 << " KB as a map)";
+}
+
+/**
+ * Hashes a string ID for the lookup table, with FNV-1a.
+ * @param id ID of the string.
+ * @return Hash.
+ */
+uint32_t Language::hashId(const std::string &id)
+{
+	uint32_t hash = 2166136261u;
+	for (std::string::const_iterator i = id.begin(); i != id.end(); ++i)
+	{
+		hash = (hash ^ (uint8_t)*i) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Looks up a string by ID, in the compiled strings
+ * or the ones still waiting to be compiled.
+ * @param id ID of the string.
+ * @param text Returns the string, if found.
+ * @return True if the string was found.
+ */
+bool Language::findString(const std::string &id, std::string &text) const
+{
+	if (!_loading.empty())
+	{
+		std::map<std::string, std::string>::const_iterator i = _loading.find(id);
+		if (i != _loading.end())
+		{
+			text = i->second;
+			return true;
+		}
+	}
+	if (_index.empty())
+	{
+		return false;
+	}
+	uint32_t hash = hashId(id);
+	for (size_t slot = hash & (_index.size() - 1); _index[slot] != 0; slot = (slot + 1) & (_index.size() - 1))
+	{
+		const Entry &entry = _entries[_index[slot] - 1];
+		if (entry.hash == hash && entry.keyLength == id.size() && _arena.compare(entry.key, entry.keyLength, id) == 0)
+		{
+			text.assign(_arena, entry.value, entry.valueLength);
+			return true;
+		}
+	}
+	return false;
+}
+
 /**
  * Replaces all special string markers with the appropriate characters.
  * @param string Original string.
@@ -269,15 +381,15 @@ LocalizedText Language::getString(const std::string &id) const
 	{
 		return id;
 	}
-	std::map<std::string, LocalizedText>::const_iterator s = _strings.find(id);
+	std::string text;
 	// Check if translation strings recently learned pluralization.
-	if (s == _strings.end())
+	if (!findString(id, text))
 	{
 		return getString(id, UINT_MAX);
 	}
 	else
 	{
-		return s->second;
+		return text;
 	}
 }
 
@@ -293,24 +405,25 @@ LocalizedText Language::getString(const std::string &id, unsigned n) const
 {
 	assert(!id.empty());
 	static std::set<std::string> notFoundIds;
-	std::map<std::string, LocalizedText>::const_iterator s = _strings.end();
+	std::string text;
+	bool found = false;
 	// Try specialized form.
 	if (n == 0)
 	{
-		s = _strings.find(id + "_zero");
+		found = findString(id + "_zero", text);
 	}
 	// Try proper form by language
-	if (s == _strings.end())
+	if (!found)
 	{
-		s = _strings.find(id + _handler->getSuffix(n));
+		found = findString(id + _handler->getSuffix(n), text);
 	}
 	// Try default form
-	if (s == _strings.end())
+	if (!found)
 	{
-		s = _strings.find(id + "_other");
+		found = findString(id + "_other", text);
 	}
 	// Give up
-	if (s == _strings.end())
+	if (!found)
 	{
 		if (notFoundIds.end() == notFoundIds.find(id))
 		{
@@ -327,15 +440,15 @@ LocalizedText Language::getString(const std::string &id, unsigned n) const
 			Log(LOG_WARNING) << id << " has plural format in ``" << Options::language << "``. Code assumes singular format.";
 //		Hint: Change ``getstring(ID).arg(value)`` to ``getString(ID, value)`` in appropriate files.
 		}
-		return s->second;
+		return text;
 	}
 	else
 	{
 		std::ostringstream ss;
 		ss << n;
-		std::string marker("{N}"), val(ss.str()), txt(s->second);
-		Unicode::replace(txt, marker, val);
-		return txt;
+		std::string marker("{N}"), val(ss.str());
+		Unicode::replace(text, marker, val);
+		return text;
 	}
 
 }
@@ -371,10 +484,10 @@ void Language::toHtml(const std::string &filename) const
 	std::stringstream htmlFile;
 	htmlFile << "<table border=\"1\" width=\"100%\">" << std::endl;
 	htmlFile << "<tr><th>ID String</th><th>English String</th></tr>" << std::endl;
-	for (std::map<std::string, LocalizedText>::const_iterator i = _strings.begin(); i != _strings.end(); ++i)
+	for (std::vector<Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i)
 	{
-		htmlFile << "<tr><td>" << i->first << "</td><td>";
-		std::string s = i->second;
+		htmlFile << "<tr><td>" << _arena.substr(i->key, i->keyLength) << "</td><td>";
+		std::string s = _arena.substr(i->value, i->valueLength);
 		for (std::string::const_iterator j = s.begin(); j != s.end(); ++j)
 		{
 			if (*j == Unicode::TOK_NL_SMALL || *j == '\n')
@@ -20,6 +20,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <stdint.h>
 #include "LocalizedText.h"
 #include "FileMap.h"
 
@@ -41,7 +42,15 @@ enum SoldierGender : char;
 class Language
 {
 private:
-	std::map<std::string, LocalizedText> _strings;
+	/// Location of a string and its ID in the arena.
+	struct Entry
+	{
+		uint32_t hash, key, keyLength, value, valueLength;
+	};
+	std::map<std::string, std::string> _loading;
+	std::string _arena;
+	std::vector<Entry> _entries;
+	std::vector<uint32_t> _index;
 	LanguagePlurality *_handler;
 	TextDirection _direction;
 	TextWrapping _wrap;
@@ -51,6 +60,10 @@ private:
 
 	/// Parses a text string loaded from an external file.
 	std::string loadString(const std::string &s) const;
+	/// Hashes a string ID.
+	static uint32_t hashId(const std::string &id);
+	/// Finds a string by ID.
+	bool findString(const std::string &id, std::string &text) const;
 public:
 	/// Creates a blank language.
 	Language();
@@ -64,6 +77,8 @@ public:
 	void loadFile(const FileMap::FileRecord *frec);
 	/// Loads the language from a ruleset file.
 	void loadRule(const std::map<std::string, ExtraStrings*> &extraStrings, const std::string &id);
+	/// Packs the loaded strings for lookup.
+	void compile();
 	/// Outputs the language to a HTML file.
 	void toHtml(const std::string &filename) const;
 	/// Get a localized text.
@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Music.h"
+#include <algorithm>
+#include <cstring>
 #include "Exception.h"
 #include "Options.h"
 #include "Logger.h"
@@ -29,10 +31,36 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Checks if a file starts like one of the formats SDL_mixer streams:
+ * FLAC, Ogg Vorbis or MP3 (with an ID3 tag or a bare frame).
+ * @param header First four bytes of the file.
+ * @return True if it's one of them.
+ */
+bool isStreamedMusic(const Uint8 *header)
+{
+	return memcmp(header, "fLaC", 4) == 0
+		|| memcmp(header, "OggS", 4) == 0
+		|| memcmp(header, "ID3", 3) == 0
+		|| (header[0] == 0xFF && (header[1] & 0xE0) == 0xE0);
+}
+
+}
+
+SDL_Thread *Music::_loader = 0;
+SDL_mutex *Music::_loaderMutex = 0;
+SDL_sem *Music::_loaderQueued = 0;
+std::deque<const Music*> Music::_loaderQueue;
+const Music *Music::_loaderCurrent = 0;
+bool Music::_loaderStop = false;
+
 /**
  * Initializes a new music track.
  */
-Music::Music() : _music(0), _rwops(0)
+Music::Music() : _music(0), _rwops(0), _deferred(false)
 {
 }
 
@@ -42,6 +70,10 @@ Music::Music() : _music(0), _rwops(0)
 Music::~Music()
 {
 #ifndef __NO_MUSIC
+	if (isDeferred())
+	{
+		dequeue();
+	}
 	stop();
 	if (_music)	Mix_FreeMusic(_music);
 	if (_rwops) SDL_RWclose(_rwops);
@@ -77,6 +109,198 @@ void Music::load(SDL_RWops *rwops)
 #endif
 }
 
+/**
+ * Sets up the music to be opened from a file by a background
+ * thread, so the game doesn't wait on every track at startup.
+ * Only for FLAC, Ogg Vorbis and MP3: SDL_mixer streams them as they
+ * play, so opening one only reads its headers, and their decoders
+ * don't share any state with the music that's playing.
+ * The file header is checked right away, so a bad file still
+ * throws and the next music format can be tried instead.
+ * @param filename Filename of the music file.
+ */
+void Music::defer(const std::string &filename)
+{
+#ifndef __NO_MUSIC
+	SDL_RWops *rwops = FileMap::getRWops(filename);
+	Uint8 header[4] = {};
+	if (rwops == 0 || SDL_RWread(rwops, header, 1, 4) != 4 || !isStreamedMusic(header))
+	{
+		if (rwops) SDL_RWclose(rwops);
+		throw Exception(filename + ": not a FLAC, Ogg Vorbis or MP3 file");
+	}
+	SDL_RWseek(rwops, 0, RW_SEEK_SET);
+	_rwops = rwops;
+	_filename = filename;
+	_deferred = true;
+	if (_loaderMutex == 0)
+	{
+		_loaderMutex = SDL_CreateMutex();
+		_loaderQueued = SDL_CreateSemaphore(0);
+		_loaderStop = false;
+		_loader = SDL_CreateThread(loaderThread, 0);
+		if (_loader == 0)
+		{
+			Log(LOG_WARNING) << "Couldn't start the music loading thread, music will be opened when played";
+		}
+	}
+	SDL_LockMutex(_loaderMutex);
+	_loaderQueue.push_back(this);
+	SDL_UnlockMutex(_loaderMutex);
+	SDL_SemPost(_loaderQueued);
+#endif
+}
+
+/**
+ * Moves the music to the front of the background queue,
+ * for tracks that are likely to be played next.
+ */
+void Music::prefetch() const
+{
+#ifndef __NO_MUSIC
+	if (_loaderMutex)
+	{
+		SDL_LockMutex(_loaderMutex);
+		std::deque<const Music*>::iterator i = std::find(_loaderQueue.begin(), _loaderQueue.end(), this);
+		if (i != _loaderQueue.end())
+		{
+			_loaderQueue.erase(i);
+			_loaderQueue.push_front(this);
+		}
+		SDL_UnlockMutex(_loaderMutex);
+	}
+#endif
+}
+
+/**
+ * Checks if the music is still waiting to be opened. The loading
+ * thread clears the flag when it's done, so it's read under the lock.
+ * @return True if the music isn't open yet.
+ */
+bool Music::isDeferred() const
+{
+	if (_loaderMutex == 0)
+	{
+		return _deferred;
+	}
+	SDL_LockMutex(_loaderMutex);
+	bool deferred = _deferred;
+	SDL_UnlockMutex(_loaderMutex);
+	return deferred;
+}
+
+/**
+ * Opens the music file set up by defer().
+ * Runs on the loading thread, or on the main thread
+ * if the track is needed before it got to it.
+ */
+void Music::open() const
+{
+#ifndef __NO_MUSIC
+	SDL_RWops *rwops = _rwops;
+	Mix_Music *music = Mix_LoadMUS_RW(rwops);
+	if (music == 0)
+	{
+		Log(LOG_WARNING) << "Music::open('" << _filename << "'): " << Mix_GetError();
+		SDL_RWclose(rwops);
+		rwops = 0;
+	}
+	if (_loaderMutex) SDL_LockMutex(_loaderMutex);
+	_music = music;
+	_rwops = rwops;
+	_deferred = false;
+	if (_loaderMutex) SDL_UnlockMutex(_loaderMutex);
+	Log(LOG_VERBOSE) << "Music::open('" << _filename << "')";
+#endif
+}
+
+/**
+ * Takes the music off the background queue, waiting
+ * for the loading thread if it's opening it right now.
+ * Afterwards only the calling thread touches the music.
+ */
+void Music::dequeue() const
+{
+#ifndef __NO_MUSIC
+	if (_loaderMutex == 0)
+	{
+		return;
+	}
+	SDL_LockMutex(_loaderMutex);
+	while (_loaderCurrent == this)
+	{
+		SDL_UnlockMutex(_loaderMutex);
+		SDL_Delay(1);
+		SDL_LockMutex(_loaderMutex);
+	}
+	_loaderQueue.erase(std::remove(_loaderQueue.begin(), _loaderQueue.end(), this), _loaderQueue.end());
+	SDL_UnlockMutex(_loaderMutex);
+#endif
+}
+
+/**
+ * Opens queued music files one by one until told to stop.
+ * @param data Unused.
+ * @return Always 0.
+ */
+int Music::loaderThread(void *)
+{
+	while (true)
+	{
+		SDL_SemWait(_loaderQueued);
+		SDL_LockMutex(_loaderMutex);
+		if (_loaderStop)
+		{
+			SDL_UnlockMutex(_loaderMutex);
+			break;
+		}
+		if (_loaderQueue.empty())
+		{
+			SDL_UnlockMutex(_loaderMutex);
+			continue;
+		}
+		const Music *music = _loaderQueue.front();
+		_loaderQueue.pop_front();
+		_loaderCurrent = music;
+		SDL_UnlockMutex(_loaderMutex);
+
+		music->open();
+
+		SDL_LockMutex(_loaderMutex);
+		_loaderCurrent = 0;
+		SDL_UnlockMutex(_loaderMutex);
+	}
+	return 0;
+}
+
+/**
+ * Stops the loading thread. Tracks still queued
+ * are opened when they're played instead.
+ */
+void Music::stopLoading()
+{
+#ifndef __NO_MUSIC
+	if (_loaderMutex == 0)
+	{
+		return;
+	}
+	if (_loader)
+	{
+		SDL_LockMutex(_loaderMutex);
+		_loaderStop = true;
+		SDL_UnlockMutex(_loaderMutex);
+		SDL_SemPost(_loaderQueued);
+		SDL_WaitThread(_loader, 0);
+		_loader = 0;
+	}
+	_loaderQueue.clear();
+	SDL_DestroySemaphore(_loaderQueued);
+	_loaderQueued = 0;
+	SDL_DestroyMutex(_loaderMutex);
+	_loaderMutex = 0;
+#endif
+}
+
 /**
  * Plays the contained music track.
  * @param loop Amount of times to loop the track. -1 = infinite
@@ -86,6 +310,12 @@ void Music::play(int loop) const
 #ifndef __NO_MUSIC
 	if (!Options::mute)
 	{
+		if (isDeferred())
+		{
+			dequeue();
+			if (isDeferred())
+				open();
+		}
 		if (_music != 0)
 		{
 			stop();
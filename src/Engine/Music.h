@@ -18,7 +18,9 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <string>
+#include <deque>
 #include <SDL_mixer.h>
+#include <SDL_thread.h>
 
 namespace OpenXcom
 {
@@ -30,8 +32,26 @@ namespace OpenXcom
 class Music
 {
 private:
-	Mix_Music *_music;
-	SDL_RWops *_rwops;
+	mutable Mix_Music *_music;
+	mutable SDL_RWops *_rwops;
+	std::string _filename;
+	mutable bool _deferred;
+
+	static SDL_Thread *_loader;
+	static SDL_mutex *_loaderMutex;
+	static SDL_sem *_loaderQueued;
+	static std::deque<const Music*> _loaderQueue;
+	static const Music *_loaderCurrent;
+	static bool _loaderStop;
+
+	/// Checks if the music is still waiting to be opened.
+	bool isDeferred() const;
+	/// Opens the deferred music file.
+	void open() const;
+	/// Takes the music off the background queue.
+	void dequeue() const;
+	/// Opens queued music files in the background.
+	static int loaderThread(void *data);
 public:
 	/// Creates a blank music track.
 	Music();
@@ -41,6 +61,12 @@ public:
 	virtual void load(const std::string &filename);
 	/// Loads music from the specified rwops.
 	virtual void load(SDL_RWops *rwops);
+	/// Opens music from the specified file in the background.
+	void defer(const std::string &filename);
+	/// Opens the music ahead of the other queued tracks.
+	void prefetch() const;
+	/// Stops opening music in the background.
+	static void stopLoading();
 	/// Plays the music.
 	virtual void play(int loop = -1) const;
 	/// Stops all music.
@@ -252,6 +252,18 @@ void create()
 	_info.push_back(OptionInfo("oxceListVFSContents", &oxceListVFSContents, false));
 	_info.push_back(OptionInfo("oxceRawScreenShots", &oxceRawScreenShots, false));
 	_info.push_back(OptionInfo("oxceThumbButtons", &oxceThumbButtons, true));
+	_info.push_back(OptionInfo("binaryBattleSaves", &binaryBattleSaves, false));
+	_info.push_back(OptionInfo("checkBaseCapacities", &checkBaseCapacities, false));
+	_info.push_back(OptionInfo("profiler", &profiler, false));
+	_info.push_back(OptionInfo("recordBattleReplay", &recordBattleReplay, false));
+	_info.push_back(OptionInfo("replayBattle", &replayBattle, ""));
+	_info.push_back(OptionInfo("replayBattleNoRender", &replayBattleNoRender, false));
+	_info.push_back(OptionInfo("mapDataCacheSize", &mapDataCacheSize, 64));
+	_info.push_back(OptionInfo("unitSpriteCache", &unitSpriteCache, false));
+	_info.push_back(OptionInfo("maxVaporParticles", &maxVaporParticles, 8192));
+	_info.push_back(OptionInfo("cutsceneCacheSize", &cutsceneCacheSize, 0));
+	_info.push_back(OptionInfo("soundCacheSize", &soundCacheSize, 32));
+	_info.push_back(OptionInfo("adlibPcmCache", &adlibPcmCache, false));
 
 	_info.push_back(OptionInfo("oxceRecommendedOptionsWereSet", &oxceRecommendedOptionsWereSet, false));
 	_info.push_back(OptionInfo("password", &password, "secret"));
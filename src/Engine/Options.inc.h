@@ -103,6 +103,68 @@ OPT bool oxceEmbeddedOnly;
 OPT bool oxceListVFSContents;
 OPT bool oxceRawScreenShots;
 OPT bool oxceThumbButtons;
+/**
+ * Saves battle units, items and nodes as binary blobs instead of YAML lists.
+ * Both formats are always loaded.
+ */
+OPT bool binaryBattleSaves;
+/**
+ * Recalculates the cached base capacities and item storage sizes on every use
+ * and logs an error when they don't match, to catch a missing invalidation.
+ */
+OPT bool checkBaseCapacities;
+/**
+ * Times the game loop and engine hot paths, showing them in an overlay.
+ * Toggled in game with Ctrl and the FPS counter key, which also writes profile.csv.
+ */
+OPT bool profiler;
+/**
+ * Records the player's commands in every battle, together with a save of its start,
+ * to replay.sav and replay.replay in the user folder.
+ */
+OPT bool recordBattleReplay;
+/**
+ * Name of a recorded battle to load and play back at startup, usually given
+ * on the command line. Cleared once the playback starts.
+ */
+OPT std::string replayBattle;
+/**
+ * Plays replayBattle back without stopping to draw frames, and quits
+ * once it's done. Combine with SDL_VIDEODRIVER=dummy to run without a display.
+ */
+OPT bool replayBattleNoRender;
+/**
+ * Memory in MB for keeping terrain data loaded between battles,
+ * so missions on the same terrains don't load it again. 0 disables it.
+ */
+OPT int mapDataCacheSize;
+/**
+ * Reuse unit sprite parts recolored by mod scripts while the unit
+ * doesn't change, instead of running the script on every frame.
+ * Off by default: a script can read battle state the cache doesn't track.
+ */
+OPT bool unitSpriteCache;
+/**
+ * Maximum number of vapor particles (smoke trails of projectiles)
+ * on the battlescape at once. New ones are skipped past this.
+ */
+OPT int maxVaporParticles;
+/**
+ * Memory in MB for keeping the last cutscene played in full
+ * decoded, so watching it again doesn't decode it again. 0 disables it.
+ */
+OPT int cutsceneCacheSize;
+/**
+ * Memory in MB for decoded sound effects. Sounds are kept as loaded
+ * and decoded when played, dropping the least recently played ones
+ * past this. 0 decodes them all up front.
+ */
+OPT int soundCacheSize;
+/**
+ * Records Adlib tracks to WAV files in the user folder the first
+ * time they play through, and plays them from there afterwards.
+ */
+OPT bool adlibPcmCache;
 
 OPT bool oxceRecommendedOptionsWereSet;
 OPT std::string password;
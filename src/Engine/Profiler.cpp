@@ -0,0 +1,162 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+#include <sstream>
+#include <algorithm>
+#include "CrossPlatform.h"
+
+namespace OpenXcom
+{
+
+bool Profiler::_enabled = false;
+uint32_t Profiler::_current[PROFILE_ZONES] = {};
+uint32_t Profiler::_history[HISTORY][PROFILE_ZONES] = {};
+int Profiler::_frame = 0;
+int Profiler::_frames = 0;
+std::chrono::steady_clock::time_point Profiler::_frameStart;
+
+namespace
+{
+
+const char *ZoneNames[PROFILE_ZONES] =
+{
+	"Frame",
+	"Game::handle",
+	"State::think",
+	"State::blit",
+	"Screen::flip",
+	"Map::draw",
+	"Globe::draw",
+	"TileEngine::FOV",
+	"TileEngine::lighting",
+	"Pathfinding",
+	"AIModule::think",
+	"Zoom",
+};
+
+}
+
+/**
+ * Starts or stops collecting timings. Either way
+ * the previously recorded frames are discarded.
+ * @param enabled True to collect timings.
+ */
+void Profiler::setEnabled(bool enabled)
+{
+	_enabled = enabled;
+	_frame = 0;
+	_frames = 0;
+	std::fill(&_current[0], &_current[0] + PROFILE_ZONES, 0);
+	_frameStart = std::chrono::steady_clock::now();
+}
+
+/**
+ * Gets the name of a zone, as shown in the overlay and the CSV header.
+ * @param zone Profiler zone.
+ * @return Zone name.
+ */
+const char *Profiler::getName(ProfileZone zone)
+{
+	return ZoneNames[zone];
+}
+
+/**
+ * Stores the times collected since the last call as one frame
+ * of the history, overwriting the oldest one when it's full.
+ */
+void Profiler::endFrame()
+{
+	if (!_enabled)
+	{
+		return;
+	}
+	auto now = std::chrono::steady_clock::now();
+	_current[PROFILE_FRAME] = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(now - _frameStart).count();
+	_frameStart = now;
+
+	std::copy(&_current[0], &_current[0] + PROFILE_ZONES, &_history[_frame][0]);
+	std::fill(&_current[0], &_current[0] + PROFILE_ZONES, 0);
+	_frame = (_frame + 1) % HISTORY;
+	_frames = std::min(_frames + 1, HISTORY);
+}
+
+/**
+ * Gets the average time spent per frame in a zone.
+ * @param zone Profiler zone.
+ * @return Time in microseconds.
+ */
+double Profiler::getAverage(ProfileZone zone)
+{
+	if (_frames == 0)
+	{
+		return 0.0;
+	}
+	uint64_t total = 0;
+	for (int i = 0; i < _frames; ++i)
+	{
+		total += _history[i][zone];
+	}
+	return (double)total / _frames;
+}
+
+/**
+ * Gets the longest time spent in a zone in a single frame.
+ * @param zone Profiler zone.
+ * @return Time in microseconds.
+ */
+uint32_t Profiler::getMaximum(ProfileZone zone)
+{
+	uint32_t max = 0;
+	for (int i = 0; i < _frames; ++i)
+	{
+		max = std::max(max, _history[i][zone]);
+	}
+	return max;
+}
+
+/**
+ * Writes the recorded frames, oldest first, as one CSV row
+ * per frame with the time of each zone in microseconds.
+ * @param filename Full path of the file to write.
+ * @return True if it was written.
+ */
+bool Profiler::dumpCsv(const std::string &filename)
+{
+	std::ostringstream ss;
+	ss << "frame";
+	for (int z = 0; z < PROFILE_ZONES; ++z)
+	{
+		ss << "," << ZoneNames[z];
+	}
+	ss << "\n";
+	int first = (_frames < HISTORY) ? 0 : _frame;
+	for (int i = 0; i < _frames; ++i)
+	{
+		const uint32_t *row = _history[(first + i) % HISTORY];
+		ss << i;
+		for (int z = 0; z < PROFILE_ZONES; ++z)
+		{
+			ss << "," << row[z];
+		}
+		ss << "\n";
+	}
+	return CrossPlatform::writeFile(filename, ss.str());
+}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <chrono>
+#include <stdint.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Sections of the game loop and engine timed by the profiler.
+ */
+enum ProfileZone : int
+{
+	PROFILE_FRAME,
+	PROFILE_HANDLE,
+	PROFILE_THINK,
+	PROFILE_BLIT,
+	PROFILE_FLIP,
+	PROFILE_MAP_DRAW,
+	PROFILE_GLOBE_DRAW,
+	PROFILE_FOV,
+	PROFILE_LIGHTING,
+	PROFILE_PATHFINDING,
+	PROFILE_AI_THINK,
+	PROFILE_ZOOM,
+	PROFILE_ZONES
+};
+
+/**
+ * Collects how long each zone took per frame, keeping
+ * the last frames in a ring buffer for display and export.
+ * Everything is static and only meant for the main thread.
+ */
+class Profiler
+{
+public:
+	/// Number of frames kept in the ring buffer.
+	static const int HISTORY = 600;
+private:
+	static bool _enabled;
+	static uint32_t _current[PROFILE_ZONES];
+	static uint32_t _history[HISTORY][PROFILE_ZONES];
+	static int _frame, _frames;
+	static std::chrono::steady_clock::time_point _frameStart;
+public:
+	/// Checks if the profiler is collecting timings.
+	static bool isEnabled() { return _enabled; }
+	/// Starts or stops collecting timings, clearing the history.
+	static void setEnabled(bool enabled);
+	/// Gets the name of a zone.
+	static const char *getName(ProfileZone zone);
+	/// Adds time spent in a zone to the current frame.
+	static void add(ProfileZone zone, uint32_t microseconds) { _current[zone] += microseconds; }
+	/// Closes the current frame and stores it in the history.
+	static void endFrame();
+	/// Gets the average time of a zone over the recorded frames.
+	static double getAverage(ProfileZone zone);
+	/// Gets the longest time of a zone over the recorded frames.
+	static uint32_t getMaximum(ProfileZone zone);
+	/// Writes the recorded frames to a CSV file.
+	static bool dumpCsv(const std::string &filename);
+};
+
+/**
+ * Times its own lifetime and adds it to a profiler zone.
+ * Costs one flag check when the profiler is disabled.
+ */
+class ProfileScope
+{
+private:
+	ProfileZone _zone;
+	bool _active;
+	std::chrono::steady_clock::time_point _start;
+public:
+	/// Starts timing a zone.
+	ProfileScope(ProfileZone zone) : _zone(zone), _active(Profiler::isEnabled())
+	{
+		if (_active)
+		{
+			_start = std::chrono::steady_clock::now();
+		}
+	}
+	/// Stops timing the zone.
+	~ProfileScope()
+	{
+		if (_active)
+		{
+			auto elapsed = std::chrono::steady_clock::now() - _start;
+			Profiler::add(_zone, (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+		}
+	}
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope &operator=(const ProfileScope&) = delete;
+};
+
+}
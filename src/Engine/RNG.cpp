@@ -104,6 +104,36 @@ RandomState x;
  */
 RandomState x_seedless;
 
+/**
+ * State the game random numbers of the current thread come from instead of the global one, if any.
+ */
+thread_local RandomState *x_local = nullptr;
+
+/**
+ * Gets the state the game random numbers of the current thread come from.
+ */
+static RandomState &gameState()
+{
+	return x_local ? *x_local : x;
+}
+
+/**
+ * Redirects the game random numbers of the calling thread to the given state.
+ * @param state Random state to use.
+ */
+ScopedState::ScopedState(RandomState &state) : _previous(x_local)
+{
+	x_local = &state;
+}
+
+/**
+ * Restores the state the calling thread used before.
+ */
+ScopedState::~ScopedState()
+{
+	x_local = _previous;
+}
+
 
 
 
@@ -141,7 +171,7 @@ RandomState& globalRandomState()
  */
 int generate(int min, int max)
 {
-	return x.generate(min, max);
+	return gameState().generate(min, max);
 }
 
 /**
@@ -152,7 +182,7 @@ int generate(int min, int max)
  */
 double generate(double min, double max)
 {
-	double num = x.next();
+	double num = gameState().next();
 	return (num / ((double)UINT64_MAX / (max - min)) + min);
 }
 
@@ -176,7 +206,7 @@ int seedless(int min, int max)
  */
 bool percent(int value)
 {
-	return x.percent(value);
+	return gameState().percent(value);
 }
 
 /**
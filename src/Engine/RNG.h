@@ -62,6 +62,24 @@ namespace RNG
 		}
 	};
 
+	/**
+	 * Redirects the game random numbers of the calling thread
+	 * to another state for as long as it exists, so work done in
+	 * parallel can have its own deterministic sequence.
+	 */
+	class ScopedState
+	{
+		RandomState *_previous;
+
+	public:
+		/// Redirects the calling thread to the given state.
+		explicit ScopedState(RandomState &state);
+		/// Restores the previous state of the calling thread.
+		~ScopedState();
+		ScopedState(const ScopedState&) = delete;
+		ScopedState &operator=(const ScopedState&) = delete;
+	};
+
 	/// Gets the seed in use.
 	uint64_t getSeed();
 	/// Sets the seed in use.
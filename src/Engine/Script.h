@@ -842,6 +842,8 @@ public:
 		}
 	}
 
+	/// Is there a script to run?
+	bool hasScript() const { return _proc != nullptr; }
 	/// Programmable blitting using script.
 	void executeBlit(const Surface* src, Surface* dest, int x, int y, int shade);
 	/// Programmable blitting using script.
@@ -21,10 +21,21 @@
 #include "Logger.h"
 #include "Unicode.h"
 #include "FileMap.h"
+#include "SDL2Helpers.h"
 
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Decoded sounds, most recently played first.
+std::list<const Sound*> cacheOrder;
+/// Memory used by the decoded sounds in the cache.
+size_t cacheSize = 0;
+
+}
+
 /**
  * Deletes the loaded sound content.
  */
@@ -38,12 +49,62 @@ Sound::UniqueSoundPtr Sound::NewSound(Mix_Chunk* sound)
 	return Sound::UniqueSoundPtr(sound);
 }
 
+/**
+ * Deletes the loaded sound content.
+ */
+Sound::~Sound()
+{
+	uncache();
+}
+
+/**
+ * Moves a sound, keeping the decoded sound cache pointing to the right place.
+ * @param other Sound to move.
+ */
+Sound::Sound(Sound&& other)
+{
+	*this = std::move(other);
+}
+
+/**
+ * Moves a sound, keeping the decoded sound cache pointing to the right place.
+ * @param other Sound to move.
+ * @return This sound.
+ */
+Sound& Sound::operator=(Sound&& other)
+{
+	if (this != &other)
+	{
+		uncache();
+		other.uncache();
+		_data = std::move(other._data);
+		_sound = std::move(other._sound);
+	}
+	return *this;
+}
+
 /**
  * Loads a sound file from a specified filename.
  * @param filename Filename of the sound file.
  */
 void Sound::load(const std::string &filename) {
 	auto rw = FileMap::getRWops(filename);
+	if (Options::soundCacheSize > 0)
+	{
+		uncache();
+		_sound.reset();
+		_data.clear();
+		size_t size = 0;
+		Uint8 *data = rw ? (Uint8 *)SDL_LoadFile_RW(rw, &size, SDL_TRUE) : 0;
+		if (!data)
+		{
+			Log(LOG_ERROR) << "Sound::load(" << filename << "): " << SDL_GetError();
+			return;
+		}
+		_data.assign(data, data + size);
+		SDL_free(data);
+		return;
+	}
 	auto s = NewSound(Mix_LoadWAV_RW(rw, SDL_TRUE));
 	if (!s)
 	{
@@ -59,6 +120,20 @@ void Sound::load(const std::string &filename) {
  * @param rw SDL_RWops of the sound data.
  */
 void Sound::load(SDL_RWops *rw) {
+	if (Options::soundCacheSize > 0)
+	{
+		uncache();
+		_sound.reset();
+		_data.clear();
+		size_t size = 0;
+		Uint8 *data = (Uint8 *)SDL_LoadFile_RW(rw, &size, SDL_TRUE);
+		if (data)
+		{
+			_data.assign(data, data + size);
+			SDL_free(data);
+		}
+		return;
+	}
 	auto s = NewSound(Mix_LoadWAV_RW(rw, SDL_TRUE));
 	if (!s)
 	{
@@ -69,15 +144,93 @@ void Sound::load(SDL_RWops *rw) {
 	_sound = std::move(s);
 }
 
+/**
+ * Gets the decoded sound. With a sound cache, the file is only
+ * kept as it was loaded and decoded the first time it's played.
+ * The sounds played least recently are dropped when the cache
+ * goes over budget, except those still playing.
+ * @return Decoded sound, or null if there's none.
+ */
+Mix_Chunk *Sound::getChunk() const
+{
+	if (_sound)
+	{
+		if (_inCache)
+		{
+			cacheOrder.splice(cacheOrder.begin(), cacheOrder, _cached);
+		}
+		else if (!_data.empty())
+		{
+			// moved here from another sound
+			_cached = cacheOrder.insert(cacheOrder.begin(), this);
+			_inCache = true;
+			cacheSize += _sound->alen;
+		}
+		return _sound.get();
+	}
+	if (_data.empty())
+	{
+		return nullptr;
+	}
+
+	_sound = NewSound(Mix_LoadWAV_RW(SDL_RWFromConstMem(_data.data(), _data.size()), SDL_TRUE));
+	if (!_sound)
+	{
+		Log(LOG_ERROR) << "Sound::getChunk(): mix error=" << Mix_GetError();
+		const_cast<Sound*>(this)->_data.clear();
+		return nullptr;
+	}
+	_cached = cacheOrder.insert(cacheOrder.begin(), this);
+	_inCache = true;
+	cacheSize += _sound->alen;
+
+	size_t budget = (size_t)Options::soundCacheSize * 1024 * 1024;
+	int channels = Mix_AllocateChannels(-1);
+	std::list<const Sound*>::iterator i = cacheOrder.end();
+	while (cacheSize > budget && i != cacheOrder.begin())
+	{
+		--i;
+		const Sound *old = *i;
+		bool playing = (old == this);
+		for (int c = 0; c < channels && !playing; ++c)
+		{
+			playing = Mix_Playing(c) && Mix_GetChunk(c) == old->_sound.get();
+		}
+		if (!playing)
+		{
+			i = cacheOrder.erase(i);
+			old->_inCache = false;
+			cacheSize -= old->_sound->alen;
+			old->_sound.reset();
+		}
+	}
+	return _sound.get();
+}
+
+/**
+ * Removes the sound from the decoded sound cache,
+ * so it can be moved or deleted.
+ */
+void Sound::uncache() const
+{
+	if (_inCache)
+	{
+		cacheOrder.erase(_cached);
+		cacheSize -= _sound->alen;
+		_inCache = false;
+	}
+}
+
 /**
  * Plays the contained sound effect.
  * @param channel Use specified channel, -1 to use any channel
  */
 void Sound::play(int channel, int angle, int distance) const
  {
-	if (!Options::mute && _sound)
+	Mix_Chunk *sound = Options::mute ? nullptr : getChunk();
+	if (sound)
  	{
-		int chan = Mix_PlayChannel(channel, _sound.get(), 0);
+		int chan = Mix_PlayChannel(channel, sound, 0);
 		if (chan == -1)
 		{
 			Log(LOG_WARNING) << Mix_GetError();
@@ -108,9 +261,10 @@ void Sound::stop()
  */
 void Sound::loop()
 {
-	if (!Options::mute && _sound && Mix_Playing(3) == 0)
+	Mix_Chunk *sound = Options::mute ? nullptr : getChunk();
+	if (sound && Mix_Playing(3) == 0)
 	{
-		int chan = Mix_PlayChannel(3, _sound.get(), -1);
+		int chan = Mix_PlayChannel(3, sound, -1);
 		if (chan == -1)
 		{
 			Log(LOG_WARNING) << Mix_GetError();
@@ -21,6 +21,8 @@
 #include <SDL_mixer.h>
 #include <string>
 #include <memory>
+#include <vector>
+#include <list>
 
 namespace OpenXcom
 {
@@ -43,17 +45,25 @@ public:
 	static UniqueSoundPtr NewSound(Mix_Chunk* sound);
 
 private:
-	UniqueSoundPtr _sound;
+	std::vector<Uint8> _data;
+	mutable UniqueSoundPtr _sound;
+	mutable std::list<const Sound*>::iterator _cached;
+	mutable bool _inCache = false;
+
+	/// Gets the decoded sound, decoding it if needed.
+	Mix_Chunk *getChunk() const;
+	/// Removes the sound from the decoded sound cache.
+	void uncache() const;
 
 public:
 	/// Creates a blank sound effect.
 	Sound() = default;
 	/// Cleans up the sound effect.
-	~Sound() = default;
+	~Sound();
 	/// Move sound to another place.
-	Sound(Sound&& other) = default;
+	Sound(Sound&& other);
 	/// Move assignment
-	Sound& operator=(Sound&& other) = default;
+	Sound& operator=(Sound&& other);
 
 	/// Loads sound from the specified file.
 	void load(const std::string &filename);
@@ -35,6 +35,7 @@
 #include "../Interface/ComboBox.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/FpsCounter.h"
+#include "../Interface/ProfilerOverlay.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Mod/RuleInterface.h"
 
@@ -263,6 +264,9 @@ void State::init()
 	_game->getFpsCounter()->setPalette(_palette);
 	_game->getFpsCounter()->setColor(_cursorColor);
 	_game->getFpsCounter()->draw();
+	_game->getProfilerOverlay()->setPalette(_palette);
+	_game->getProfilerOverlay()->setColor(_cursorColor);
+	_game->getProfilerOverlay()->draw();
 
 	// Highest priority: custom sound set explicitly in the code
 	// Medium priority: sound defined by the interface ruleset
@@ -541,6 +545,8 @@ void State::setModPalette()
 		_game->getCursor()->draw();
 		_game->getFpsCounter()->setPalette(_palette);
 		_game->getFpsCounter()->draw();
+		_game->getProfilerOverlay()->setPalette(_palette);
+		_game->getProfilerOverlay()->draw();
 	}
 }
 
@@ -23,6 +23,7 @@
 #include "Logger.h"
 #include "Options.h"
 #include "Screen.h"
+#include "Profiler.h"
 
 #include "OpenGL.h"
 
@@ -667,6 +668,7 @@ bool Zoom::haveSSE2()
  */
 void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut)
 {
+	ProfileScope profile(PROFILE_ZOOM);
 	int dstWidth = dst->w - leftBlackBand - rightBlackBand;
 	int dstHeight = dst->h - topBlackBand - bottomBlackBand;
 	if (Screen::useOpenGL())
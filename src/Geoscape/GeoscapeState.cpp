@@ -57,6 +57,7 @@
 #include "../Savegame/CovertOperation.h"
 #include "../Savegame/Waypoint.h"
 #include "../Savegame/Transfer.h"
+#include "../Savegame/EventScheduler.h"
 #include "../Savegame/Soldier.h"
 #include "../Savegame/SoldierDiary.h"
 #include "../Menu/PauseState.h"
@@ -2167,19 +2168,7 @@ void GeoscapeState::time1Hour()
 	}
 
 	// Handle transfers
-	bool window = false;
-	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
-	{
-		for (std::vector<Transfer*>::iterator j = (*i)->getTransfers()->begin(); j != (*i)->getTransfers()->end(); ++j)
-		{
-			(*j)->advance(*i);
-			if (!window && (*j)->getHours() <= 0)
-			{
-				window = true;
-			}
-		}
-	}
-	if (window)
+	if (_game->getSavedGame()->deliverTransfers())
 	{
 		popup(new ItemsArrivingState(this));
 	}
@@ -2685,13 +2674,19 @@ void GeoscapeState::time1Day()
 	//Handle daily Faction logic
 	int day = saveGame->getTime()->getDay();
 	ThinkPeriod step = TIMESTEP_DAILY;
+	if (day == 10 || day == 20 || _game->getSavedGame()->getTime()->isLastDayOfMonth())
+	{
+		step = TIMESTEP_10_DAYS;
+	}
 	for (auto faction : saveGame->getDiplomacyFactions())
 	{
-		if (day == 10 || day == 20 || _game->getSavedGame()->getTime()->isLastDayOfMonth())
-		{
-			step = TIMESTEP_10_DAYS;
-		}
-		faction->think(*_game, step);
+		faction->beginThink(*_game, step);
+	}
+	// each faction's own management is independent from the others
+	DiplomacyFaction::manageAll(saveGame->getDiplomacyFactions(), *saveGame, *mod, step);
+	for (auto faction : saveGame->getDiplomacyFactions())
+	{
+		faction->endThink(*_game, step);
 		if (!faction->getAvalibleMissionScripts().empty())
 		{
 			for (auto missionScript : faction->getAvalibleMissionScripts())
@@ -3099,6 +3094,7 @@ void GeoscapeState::btnDebugClick(Action *)
 	if (_game->getSavedGame()->getDebugMode())
 	{
 		_txtDebug->setText("DEBUG MODE");
+		_game->getSavedGame()->getEventScheduler()->dump(*_game->getSavedGame()->getBases());
 	}
 	else
 	{
@@ -53,6 +53,7 @@
 #include "../Mod/Texture.h"
 #include "../Interface/Cursor.h"
 #include "../Engine/Screen.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -941,6 +942,7 @@ void Globe::rotate()
  */
 void Globe::draw()
 {
+	ProfileScope profile(PROFILE_GLOBE_DRAW);
 	if (_redraw)
 	{
 		cachePolygons();
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ProfilerOverlay.h"
+#include <sstream>
+#include <iomanip>
+#include "../Engine/Profiler.h"
+#include "../Engine/Timer.h"
+#include "Text.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a profiler overlay of the specified size.
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ * @param x X position in pixels.
+ * @param y Y position in pixels.
+ */
+ProfilerOverlay::ProfilerOverlay(int width, int height, int x, int y) : Surface(width, height, x, y)
+{
+	_timer = new Timer(1000);
+	_timer->onTimer((SurfaceHandler)&ProfilerOverlay::update);
+	_timer->start();
+
+	_text = new Text(width, height, 0, 0);
+}
+
+/**
+ * Deletes profiler overlay content.
+ */
+ProfilerOverlay::~ProfilerOverlay()
+{
+	delete _text;
+	delete _timer;
+}
+
+/**
+ * Passes the fonts on to the overlay's text.
+ * @param big Pointer to large-size font.
+ * @param small Pointer to small-size font.
+ * @param lang Pointer to current language.
+ */
+void ProfilerOverlay::initText(Font *big, Font *small, Language *lang)
+{
+	_text->initText(big, small, lang);
+	_text->setSmall();
+}
+
+/**
+ * Replaces a certain amount of colors in the overlay palette.
+ * @param colors Pointer to the set of colors.
+ * @param firstcolor Offset of the first color to replace.
+ * @param ncolors Amount of colors to replace.
+ */
+void ProfilerOverlay::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
+{
+	Surface::setPalette(colors, firstcolor, ncolors);
+	_text->setPalette(colors, firstcolor, ncolors);
+}
+
+/**
+ * Sets the text color of the overlay.
+ * @param color The color to set.
+ */
+void ProfilerOverlay::setColor(Uint8 color)
+{
+	_text->setColor(color);
+}
+
+/**
+ * Advances the refresh timer.
+ */
+void ProfilerOverlay::think()
+{
+	_timer->think(0, this);
+}
+
+/**
+ * Lists every zone with its average and worst time
+ * per frame over the recorded history, in milliseconds.
+ */
+void ProfilerOverlay::update()
+{
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	for (int z = 0; z < PROFILE_ZONES; ++z)
+	{
+		ProfileZone zone = (ProfileZone)z;
+		ss << Profiler::getName(zone) << "  " << Profiler::getAverage(zone) / 1000.0 << " / " << Profiler::getMaximum(zone) / 1000.0 << "\n";
+	}
+	_text->setText(ss.str());
+	_redraw = true;
+}
+
+/**
+ * Draws the profiler overlay.
+ */
+void ProfilerOverlay::draw()
+{
+	Surface::draw();
+	_text->blit(this->getSurface());
+}
+
+}
@@ -29,6 +29,19 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Adds a layout setting to a text cache key.
+ */
+void appendKey(std::string &key, intptr_t value)
+{
+	key.append((const char*)&value, sizeof(value));
+}
+
+}
+
 /**
  * Sets up a blank text with the specified size and position.
  * @param width Width in pixels.
@@ -254,7 +267,11 @@ Uint8 Text::getSecondaryColor() const
 
 int Text::getNumLines() const
 {
-	return _wrap ? _lineHeight.size() : 1;
+	if (!_wrap)
+	{
+		return 1;
+	}
+	return _run ? _run->lineHeight.size() : 0;
 }
 
 /**
@@ -264,10 +281,14 @@ int Text::getNumLines() const
  */
 int Text::getTextHeight(int line) const
 {
+	if (!_run)
+	{
+		return 0;
+	}
 	if (line == -1)
 	{
 		int height = 0;
-		for (std::vector<int>::const_iterator i = _lineHeight.begin(); i != _lineHeight.end(); ++i)
+		for (std::vector<int>::const_iterator i = _run->lineHeight.begin(); i != _run->lineHeight.end(); ++i)
 		{
 			height += *i;
 		}
@@ -275,7 +296,7 @@ int Text::getTextHeight(int line) const
 	}
 	else
 	{
-		return _lineHeight[line];
+		return _run->lineHeight[line];
 	}
 }
 
@@ -286,10 +307,14 @@ int Text::getTextHeight(int line) const
  */
 int Text::getTextWidth(int line) const
 {
+	if (!_run)
+	{
+		return 0;
+	}
 	if (line == -1)
 	{
 		int width = 0;
-		for (std::vector<int>::const_iterator i = _lineWidth.begin(); i != _lineWidth.end(); ++i)
+		for (std::vector<int>::const_iterator i = _run->lineWidth.begin(); i != _run->lineWidth.end(); ++i)
 		{
 			if (*i > width)
 			{
@@ -300,7 +325,7 @@ int Text::getTextWidth(int line) const
 	}
 	else
 	{
-		return _lineWidth[line];
+		return _run->lineWidth[line];
 	}
 }
 
@@ -308,6 +333,9 @@ int Text::getTextWidth(int line) const
  * Takes care of any text post-processing like converting
  * encoded text to individual codepoints and calculating
  * line metrics for alignment and wordwrapping.
+ * The results are kept by the font, so texts with the same
+ * string and settings (like all the numbers on a screen
+ * being redrawn) only get laid out once.
  */
 void Text::processText()
 {
@@ -316,16 +344,31 @@ void Text::processText()
 		return;
 	}
 
-	_processedText = Unicode::convUtf8ToUtf32(_text);
-	_lineWidth.clear();
-	_lineHeight.clear();
 	_scrollY = 0;
+	_redraw = true;
+
+	// Alignment and colors are applied when drawing, so they don't need to be part of the key
+	std::string key;
+	appendKey(key, (intptr_t)_small);
+	appendKey(key, _wrap ? getWidth() : -1);
+	appendKey(key, (_wrap ? 1 : 0) | (_indent ? 2 : 0) | (_ignoreSeparators ? 4 : 0));
+	appendKey(key, _lang->getTextWrapping());
+	key += _text;
+	_run = _font->getRun(key);
+	if (_run)
+	{
+		return;
+	}
+
+	std::shared_ptr<TextRun> run = std::make_shared<TextRun>();
+	run->text = Unicode::convUtf8ToUtf32(_text);
+	std::vector<int> &lineWidth = run->lineWidth, &lineHeight = run->lineHeight;
 
 	int width = 0, word = 0;
 	size_t space = 0, textIndentation = 0;
 	bool start = true;
 	Font *font = _font;
-	UString &str = _processedText;
+	UString &str = run->text;
 
 	// Go through the text character by character
 	for (size_t c = 0; c <= str.size(); ++c)
@@ -334,8 +377,8 @@ void Text::processText()
 		if (c == str.size() || Unicode::isLinebreak(str[c]))
 		{
 			// Add line measurements for alignment later
-			_lineWidth.push_back(width);
-			_lineHeight.push_back(font->getCharSize('\n').h);
+			lineWidth.push_back(width);
+			lineHeight.push_back(font->getCharSize('\n').h);
 			width = 0;
 			word = 0;
 			start = true;
@@ -406,8 +449,8 @@ void Text::processText()
 					width += font->getCharSize('\t').w;
 				}
 
-				_lineWidth.push_back(width);
-				_lineHeight.push_back(font->getCharSize('\n').h);
+				lineWidth.push_back(width);
+				lineHeight.push_back(font->getCharSize('\n').h);
 				if (_lang->getTextWrapping() == WRAP_WORDS)
 				{
 					width = word;
@@ -421,9 +464,47 @@ void Text::processText()
 		}
 	}
 
-	_redraw = true;
+	// Work out where each character goes relative to the start of its line
+	int offset = 0, line = 0;
+	bool secondary = false;
+	font = _font;
+	for (UString::const_iterator c = str.begin(); c != str.end(); ++c)
+	{
+		if (Unicode::isSpace(*c) || *c == '\t')
+		{
+			offset += font->getCharSize(*c).w;
+		}
+		else if (Unicode::isLinebreak(*c))
+		{
+			line++;
+			offset = 0;
+			if (*c == Unicode::TOK_NL_SMALL)
+			{
+				font = _small;
+			}
+		}
+		else if (*c == Unicode::TOK_COLOR_FLIP)
+		{
+			secondary = !secondary;
+		}
+		else
+		{
+			TextGlyph glyph;
+			glyph.chr = font->getChar(*c);
+			glyph.offset = offset;
+			glyph.width = font->getCharSize(*c).w;
+			glyph.line = line;
+			glyph.secondary = secondary;
+			run->glyphs.push_back(glyph);
+			offset += glyph.width;
+		}
+	}
+
+	_font->addRun(key, run);
+	_run = run;
 }
 
+
 namespace
 {
 
@@ -457,10 +538,10 @@ int Text::getLineX(int line) const
 		case ALIGN_LEFT:
 			break;
 		case ALIGN_CENTER:
-			x = (int)ceil((getWidth() + _font->getSpacing() - _lineWidth[line]) / 2.0);
+			x = (int)ceil((getWidth() + _font->getSpacing() - _run->lineWidth[line]) / 2.0);
 			break;
 		case ALIGN_RIGHT:
-			x = getWidth() - 1 - _lineWidth[line];
+			x = getWidth() - 1 - _run->lineWidth[line];
 			break;
 		}
 		break;
@@ -471,10 +552,10 @@ int Text::getLineX(int line) const
 			x = getWidth() - 1;
 			break;
 		case ALIGN_CENTER:
-			x = getWidth() - (int)ceil((getWidth() + _font->getSpacing() - _lineWidth[line]) / 2.0);
+			x = getWidth() - (int)ceil((getWidth() + _font->getSpacing() - _run->lineWidth[line]) / 2.0);
 			break;
 		case ALIGN_RIGHT:
-			x = _lineWidth[line];
+			x = _run->lineWidth[line];
 			break;
 		}
 		break;
@@ -489,7 +570,7 @@ int Text::getLineX(int line) const
 void Text::draw()
 {
 	Surface::draw();
-	if (_text.empty() || _font == 0)
+	if (_text.empty() || _font == 0 || !_run)
 	{
 		return;
 	}
@@ -510,10 +591,7 @@ void Text::draw()
 		this->drawRect(&r, 0);
 	}
 
-	int x = 0, y = 0, line = 0, height = 0;
-	Font *font = _font;
-	int color = _color;
-	const UString &s = _processedText;
+	int y = 0, height = 0;
 
 	height = getTextHeight();
 
@@ -537,8 +615,6 @@ void Text::draw()
 		}
 	}
 
-	x = getLineX(line);
-
 	// Set up text color
 	int mul = 1;
 	if (_contrast)
@@ -547,47 +623,28 @@ void Text::draw()
 	}
 
 	// Set up text direction
-	int dir = 1;
-	if (_lang->getTextDirection() == DIRECTION_RTL)
-	{
-		dir = -1;
-	}
+	bool rtl = (_lang->getTextDirection() == DIRECTION_RTL);
 
 	// Invert text by inverting the font palette on index 3 (font palettes use indices 1-5)
 	int mid = _invert ? 3 : 0;
 
+	// Line positions only depend on the alignment, the rest was worked out with the layout
+	std::vector<int> lineX(_run->lineWidth.size()), lineY(_run->lineHeight.size());
+	for (size_t line = 0; line < lineX.size(); ++line)
+	{
+		lineX[line] = getLineX(line);
+		lineY[line] = y;
+		y += _run->lineHeight[line];
+	}
+
 	// Draw each letter one by one
-	for (UString::const_iterator c = s.begin(); c != s.end(); ++c)
+	auto dest = ShaderSurface(this, 0, 0);
+	for (std::vector<TextGlyph>::const_iterator g = _run->glyphs.begin(); g != _run->glyphs.end(); ++g)
 	{
-		if (Unicode::isSpace(*c) || *c == '\t')
-		{
-			x += dir * font->getCharSize(*c).w;
-		}
-		else if (Unicode::isLinebreak(*c))
-		{
-			line++;
-			y += font->getCharSize(*c).h;
-			x = getLineX(line);
-			if (*c == Unicode::TOK_NL_SMALL)
-			{
-				font = _small;
-			}
-		}
-		else if (*c == Unicode::TOK_COLOR_FLIP)
-		{
-			color = (color == _color ? _color2 : _color);
-		}
-		else
-		{
-			if (dir < 0)
-				x += dir * font->getCharSize(*c).w;
-			auto chr = font->getChar(*c);
-			chr.setX(x);
-			chr.setY(y);
-			ShaderDraw<PaletteShift>(ShaderSurface(this, 0, 0), ShaderCrop(chr), ShaderScalar(color), ShaderScalar(mul), ShaderScalar(mid));
-			if (dir > 0)
-				x += dir * font->getCharSize(*c).w;
-		}
+		auto chr = g->chr;
+		chr.setX(rtl ? lineX[g->line] - g->offset - g->width : lineX[g->line] + g->offset);
+		chr.setY(lineY[g->line]);
+		ShaderDraw<PaletteShift>(dest, ShaderCrop(chr), ShaderScalar(g->secondary ? _color2 : _color), ShaderScalar(mul), ShaderScalar(mid));
 	}
 }
 
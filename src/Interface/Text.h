@@ -20,6 +20,7 @@
 #include "../Engine/InteractiveSurface.h"
 #include <vector>
 #include <string>
+#include <memory>
 #include "../Engine/Unicode.h"
 
 namespace OpenXcom
@@ -27,6 +28,7 @@ namespace OpenXcom
 
 class Font;
 class Language;
+struct TextRun;
 
 enum TextHAlign { ALIGN_LEFT, ALIGN_CENTER, ALIGN_RIGHT };
 enum TextVAlign { ALIGN_TOP, ALIGN_MIDDLE, ALIGN_BOTTOM };
@@ -43,8 +45,7 @@ private:
 	Font *_big, *_small, *_font, *_fontOrig;
 	Language *_lang;
 	std::string _text;
-	UString _processedText;
-	std::vector<int> _lineWidth, _lineHeight;
+	std::shared_ptr<const TextRun> _run;
 	bool _wrap, _invert, _contrast, _indent, _scroll, _ignoreSeparators;
 	TextHAlign _align;
 	TextVAlign _valign;
@@ -32,6 +32,14 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Marks a visible row slot that doesn't show any row yet.
+const size_t NO_ROW = (size_t)-1;
+
+}
+
 /**
  * Sets up a blank list with the specified size and position.
  * @param width Width in pixels.
@@ -63,13 +71,17 @@ TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(wid
  */
 TextList::~TextList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector< std::vector<Text*> >::iterator u = _visibleTexts.begin(); u < _visibleTexts.end(); ++u)
 	{
 		for (std::vector<Text*>::iterator v = (*u).begin(); v < (*u).end(); ++v)
 		{
 			delete *v;
 		}
 	}
+	for (std::map<int, Text*>::iterator i = _measureTexts.begin(); i != _measureTexts.end(); ++i)
+	{
+		delete i->second;
+	}
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
 	{
 		delete *i;
@@ -155,7 +167,9 @@ void TextList::unpress(State *state)
  */
 void TextList::setCellColor(size_t row, size_t column, Uint8 color)
 {
-	_texts[row][column]->setColor(color);
+	_texts[row].cells[column].color = color;
+	_texts[row].cells[column].color2 = color;
+	invalidateVisible(row);
 	_redraw = true;
 }
 
@@ -166,10 +180,12 @@ void TextList::setCellColor(size_t row, size_t column, Uint8 color)
  */
 void TextList::setRowColor(size_t row, Uint8 color)
 {
-	for (std::vector<Text*>::iterator i = _texts[row].begin(); i < _texts[row].end(); ++i)
+	for (std::vector<Cell>::iterator i = _texts[row].cells.begin(); i < _texts[row].cells.end(); ++i)
 	{
-		(*i)->setColor(color);
+		i->color = color;
+		i->color2 = color;
 	}
+	invalidateVisible(row);
 	_redraw = true;
 }
 
@@ -181,7 +197,7 @@ void TextList::setRowColor(size_t row, Uint8 color)
  */
 std::string TextList::getCellText(size_t row, size_t column) const
 {
-	return _texts[row][column]->getText();
+	return _texts[row].cells[column].text;
 }
 
 /**
@@ -192,7 +208,8 @@ std::string TextList::getCellText(size_t row, size_t column) const
  */
 void TextList::setCellText(size_t row, size_t column, const std::string &text)
 {
-	_texts[row][column]->setText(text);
+	_texts[row].cells[column].text = text;
+	invalidateVisible(row);
 	_redraw = true;
 }
 
@@ -203,7 +220,7 @@ void TextList::setCellText(size_t row, size_t column, const std::string &text)
  */
 int TextList::getColumnX(size_t column) const
 {
-	return getX() + _texts[0][column]->getX();
+	return getX() + _texts[0].cells[column].x;
 }
 
 /**
@@ -213,7 +230,7 @@ int TextList::getColumnX(size_t column) const
  */
 int TextList::getRowY(size_t row) const
 {
-	return getY() + _texts[row][0]->getY();
+	return getY() + _texts[row].y;
 }
 
 /**
@@ -223,7 +240,10 @@ int TextList::getRowY(size_t row) const
  */
 int TextList::getTextHeight(size_t row) const
 {
-	return _texts[row].front()->getTextHeight();
+	const Cell &cell = _texts[row].cells.front();
+	Text *text = const_cast<TextList*>(this)->getMeasureText(cell.width);
+	layoutCell(text, _texts[row], cell);
+	return text->getTextHeight();
 }
 
 /**
@@ -233,7 +253,10 @@ int TextList::getTextHeight(size_t row) const
  */
 int TextList::getNumTextLines(size_t row) const
 {
-	return _texts[row].front()->getNumLines();
+	const Cell &cell = _texts[row].cells.front();
+	Text *text = const_cast<TextList*>(this)->getMeasureText(cell.width);
+	layoutCell(text, _texts[row], cell);
+	return text->getNumLines();
 }
 
 /**
@@ -273,8 +296,9 @@ size_t TextList::getVisibleRows() const
 }
 
 /**
- * Adds a new row of text to the list, automatically creating
- * the required Text objects lined up where they need to be.
+ * Adds a new row of text to the list, automatically working out
+ * where each cell needs to be lined up. Only the contents are kept,
+ * the Text objects are only created for the rows on screen.
  * @param cols Number of columns.
  * @param ... Text for each cell in the new row.
  */
@@ -292,52 +316,45 @@ void TextList::addRow(int cols, ...)
 		ncols = 1;
 	}
 
-	std::vector<Text*> temp;
+	Row row;
+	row.big = (_font == _big);
 	// Positions are relative to list surface.
-	int rowX = 0, rowY = 0, rows = 1, rowHeight = 0;
+	int rowX = 0, rows = 1, rowHeight = 0;
+	row.y = 0;
 	if (!_texts.empty())
 	{
-		rowY = _texts.back().front()->getY() + _texts.back().front()->getHeight() + _font->getSpacing();
+		row.y = _texts.back().y + _texts.back().height + _font->getSpacing();
 	}
 
 	for (int i = 0; i < ncols; ++i)
 	{
-		int width;
+		Cell cell;
 		// Place text
 		if (_flooding)
 		{
-			width = 340;
-		}
-		else
-		{
-			width = _columns[i];
-		}
-		Text* txt = new Text(width, _font->getHeight(), _margin + rowX, rowY);
-		txt->setPalette(this->getPalette());
-		txt->initText(_big, _small, _lang);
-		txt->setColor(_color);
-		txt->setSecondaryColor(_color2);
-		if (_align[i])
-		{
-			txt->setAlign(_align[i]);
-		}
-		txt->setHighContrast(_contrast);
-		if (_font == _big)
-		{
-			txt->setBig();
+			cell.width = 340;
 		}
 		else
 		{
-			txt->setSmall();
+			cell.width = _columns[i];
 		}
+		cell.x = _margin + rowX;
+		cell.color = _color;
+		cell.color2 = _color2;
+		cell.align = _align[i];
+		cell.wrap = false;
 		if (cols > 0)
-			txt->setText(va_arg(args, char*));
+			cell.text = va_arg(args, char*);
+
+		Text *txt = getMeasureText(cell.width);
+		layoutCell(txt, row, cell);
 		// grab this before we enable word wrapping so we can use it to calculate
 		// the total row height below
 		int vmargin = _font->getHeight() - txt->getTextHeight();
 		// Wordwrap text if necessary
 		if (_wrap && txt->getTextWidth() > txt->getWidth())
 		{
+			cell.wrap = true;
 			txt->setWordWrap(true, true, _ignoreSeparators);
 			rows = std::max(rows, txt->getNumLines());
 		}
@@ -362,9 +379,10 @@ void TextList::addRow(int cols, ...)
 				}
 			}
 			txt->setText(buf);
+			cell.text = buf;
 		}
 
-		temp.push_back(txt);
+		row.cells.push_back(cell);
 		if (_condensed)
 		{
 			rowX += txt->getTextWidth();
@@ -376,50 +394,14 @@ void TextList::addRow(int cols, ...)
 	}
 
 	// ensure all elements in this row are the same height
-	for (int i = 0; i < cols; ++i)
-	{
-		temp[i]->setHeight(rowHeight);
-	}
+	row.height = cols > 0 ? rowHeight : _font->getHeight();
 
-	_texts.push_back(temp);
+	_texts.push_back(row);
 	for (int i = 0; i < rows; ++i)
 	{
 		_rows.push_back(_texts.size() - 1);
 	}
 
-	// Place arrow buttons
-	// Position defined w.r.t. main window, NOT TextList.
-	if (_arrowPos != -1)
-	{
-		ArrowShape shape1, shape2;
-		if (_arrowType == ARROW_VERTICAL)
-		{
-			shape1 = ARROW_SMALL_UP;
-			shape2 = ARROW_SMALL_DOWN;
-		}
-		else
-		{
-			shape1 = ARROW_SMALL_LEFT;
-			shape2 = ARROW_SMALL_RIGHT;
-		}
-		ArrowButton *a1 = new ArrowButton(shape1, 11, 8, getX() + _arrowPos, getY());
-		a1->setListButton();
-		a1->setPalette(this->getPalette());
-		a1->setColor(_up->getColor());
-		a1->onMouseClick(_leftClick, 0);
-		a1->onMousePress(_leftPress);
-		a1->onMouseRelease(_leftRelease);
-		_arrowLeft.push_back(a1);
-		ArrowButton *a2 = new ArrowButton(shape2, 11, 8, getX() + _arrowPos + 12, getY());
-		a2->setListButton();
-		a2->setPalette(this->getPalette());
-		a2->setColor(_up->getColor());
-		a2->onMouseClick(_rightClick, 0);
-		a2->onMousePress(_rightPress);
-		a2->onMouseRelease(_rightRelease);
-		_arrowRight.push_back(a2);
-	}
-
 	_redraw = true;
 	va_end(args);
 	updateArrows();
@@ -432,6 +414,7 @@ void TextList::removeLastRow()
 {
 	if (!_texts.empty())
 	{
+		invalidateVisible(_texts.size() - 1);
 		_texts.pop_back();
 	}
 	if (!_rows.empty())
@@ -442,17 +425,6 @@ void TextList::removeLastRow()
 			_rows.pop_back();
 		}
 	}
-	if (_arrowPos != -1)
-	{
-		if (!_arrowLeft.empty())
-		{
-			_arrowLeft.pop_back();
-		}
-		if (!_arrowRight.empty())
-		{
-			_arrowRight.pop_back();
-		}
-	}
 	_redraw = true;
 	updateArrows();
 }
@@ -488,7 +460,7 @@ void TextList::setColumns(int cols, ...)
 void TextList::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector< std::vector<Text*> >::iterator u = _visibleTexts.begin(); u < _visibleTexts.end(); ++u)
 	{
 		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
 		{
@@ -531,6 +503,19 @@ void TextList::initText(Font *big, Font *small, Language *lang)
 	_selector->setPalette(getPalette());
 	_selector->setVisible(false);
 
+	for (std::vector< std::vector<Text*> >::iterator u = _visibleTexts.begin(); u < _visibleTexts.end(); ++u)
+	{
+		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		{
+			(*v)->initText(big, small, lang);
+		}
+	}
+	for (std::map<int, Text*>::iterator i = _measureTexts.begin(); i != _measureTexts.end(); ++i)
+	{
+		i->second->initText(big, small, lang);
+	}
+	invalidateVisible();
+
 	updateVisible();
 
 }
@@ -559,13 +544,15 @@ void TextList::setColor(Uint8 color)
 	_up->setColor(color);
 	_down->setColor(color);
 	_scrollbar->setColor(color);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<Row>::iterator u = _texts.begin(); u < _texts.end(); ++u)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		for (std::vector<Cell>::iterator v = u->cells.begin(); v < u->cells.end(); ++v)
 		{
-			(*v)->setColor(color);
+			v->color = color;
+			v->color2 = color;
 		}
 	}
+	invalidateVisible();
 }
 
 /**
@@ -614,13 +601,7 @@ void TextList::setWordWrap(bool wrap)
 void TextList::setHighContrast(bool contrast)
 {
 	_contrast = contrast;
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
-	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			(*v)->setHighContrast(contrast);
-		}
-	}
+	invalidateVisible();
 	_scrollbar->setHighContrast(contrast);
 }
 
@@ -883,17 +864,10 @@ void TextList::onRightArrowRelease(ActionHandler handler)
  */
 void TextList::clearList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
-	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			delete (*v);
-		}
-		u->clear();
-	}
 	scrollUp(true, false);
 	_texts.clear();
 	_rows.clear();
+	invalidateVisible();
 	_redraw = true;
 }
 
@@ -1014,21 +988,17 @@ void TextList::draw()
 		{
 			y -= _font->getHeight() + _font->getSpacing();
 		}
-		for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
+		size_t slot = 0;
+		for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i, ++slot)
 		{
-			for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
+			_texts[i].y = y;
+			const std::vector<Text*> &texts = getVisibleTexts(slot, i);
+			for (std::vector<Text*>::const_iterator j = texts.begin(); j < texts.end(); ++j)
 			{
 				(*j)->setY(y);
 				(*j)->blit(this->getSurface());
 			}
-			if (!_texts[i].empty())
-			{
-				y += _texts[i].front()->getHeight() + _font->getSpacing();
-			}
-			else
-			{
-				y += _font->getHeight() + _font->getSpacing();
-			}
+			y += _texts[i].height + _font->getSpacing();
 		}
 	}
 }
@@ -1054,26 +1024,21 @@ void TextList::blit(SDL_Surface *surface)
 				y -= _font->getHeight() + _font->getSpacing();
 			}
 			int maxY = getY() + getHeight();
-			for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows && y < maxY; ++i)
+			size_t slot = 0;
+			for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows && y < maxY; ++i, ++slot)
 			{
-				_arrowLeft[i]->setY(y);
-				_arrowRight[i]->setY(y);
+				addArrows(slot + 1);
+				_arrowLeft[slot]->setY(y);
+				_arrowRight[slot]->setY(y);
 
 				if (y >= getY())
 				{
 					// only blit arrows that belong to texts that have their first row on-screen
-					_arrowLeft[i]->blit(surface);
-					_arrowRight[i]->blit(surface);
+					_arrowLeft[slot]->blit(surface);
+					_arrowRight[slot]->blit(surface);
 				}
 
-				if (!_texts[i].empty())
-				{
-					y += _texts[i].front()->getHeight() + _font->getSpacing();
-				}
-				else
-				{
-					y += _font->getHeight() + _font->getSpacing();
-				}
+				y += _texts[i].height + _font->getSpacing();
 			}
 		}
 		_up->blit(surface);
@@ -1110,10 +1075,12 @@ void TextList::handle(Action *action, State *state)
 				++endArrowIdx;
 			}
 		}
+		// the arrows are shared by whichever rows are on screen
+		addArrows(endArrowIdx - _rows[_scroll]);
 		for (size_t i = startArrowIdx; i < endArrowIdx; ++i)
 		{
-			_arrowLeft[i]->handle(action, state);
-			_arrowRight[i]->handle(action, state);
+			_arrowLeft[i - _rows[_scroll]]->handle(action, state);
+			_arrowRight[i - _rows[_scroll]]->handle(action, state);
 		}
 	}
 }
@@ -1229,9 +1196,9 @@ void TextList::mouseOver(Action *action, State *state)
 		_selRow = std::max(0, (int)(_scroll + (int)floor(action->getRelativeYMouse() / (rowHeight * action->getYScale()))));
 		if (_selRow < _rows.size())
 		{
-			Text *selText = _texts[_rows[_selRow]].front();
-			int y = getY() + selText->getY();
-			int actualHeight = selText->getHeight() + _font->getSpacing(); //current line height
+			const Row &selText = _texts[_rows[_selRow]];
+			int y = getY() + selText.y;
+			int actualHeight = selText.height + _font->getSpacing(); //current line height
 			if (y < getY() || y + actualHeight > getY() + getHeight())
 			{
 				actualHeight /= 2;
@@ -1309,6 +1276,171 @@ void TextList::scrollTo(size_t scroll)
 	updateArrows();
 }
 
+/**
+ * Gets a text used to work out the layout of cells
+ * of a given width, without drawing them.
+ * @param width Width of the cell in pixels.
+ * @return Text of that width.
+ */
+Text *TextList::getMeasureText(int width)
+{
+	Text *&text = _measureTexts[width];
+	if (text == 0)
+	{
+		text = new Text(width, _font->getHeight());
+		text->initText(_big, _small, _lang);
+	}
+	else if (text->getHeight() != _font->getHeight())
+	{
+		text->setHeight(_font->getHeight());
+	}
+	return text;
+}
+
+/**
+ * Sets up a text with the contents and font of a cell,
+ * word wrapped the same way as when the row was added.
+ * @param text Text to set up.
+ * @param row Row of the cell.
+ * @param cell Cell to show.
+ */
+void TextList::layoutCell(Text *text, const Row &row, const Cell &cell) const
+{
+	if (row.big)
+	{
+		text->setBig();
+	}
+	else
+	{
+		text->setSmall();
+	}
+	text->setWordWrap(false);
+	text->setText(cell.text);
+	if (cell.wrap)
+	{
+		text->setWordWrap(true, true, _ignoreSeparators);
+	}
+}
+
+/**
+ * Gets the texts showing a row on screen. There's only a set of texts
+ * per visible row, reused for whichever row scrolls into its place.
+ * @param slot Position of the row on screen.
+ * @param row Row to show.
+ * @return Texts for each cell of the row.
+ */
+const std::vector<Text*> &TextList::getVisibleTexts(size_t slot, size_t row)
+{
+	if (_visibleTexts.size() <= slot)
+	{
+		_visibleTexts.resize(slot + 1);
+		_visibleTextRows.resize(slot + 1, NO_ROW);
+	}
+	std::vector<Text*> &texts = _visibleTexts[slot];
+	if (_visibleTextRows[slot] != row)
+	{
+		const Row &data = _texts[row];
+		while (texts.size() > data.cells.size())
+		{
+			delete texts.back();
+			texts.pop_back();
+		}
+		for (size_t i = 0; i < data.cells.size(); ++i)
+		{
+			const Cell &cell = data.cells[i];
+			if (i == texts.size() || texts[i]->getWidth() != cell.width)
+			{
+				Text *txt = new Text(cell.width, _font->getHeight());
+				txt->setPalette(this->getPalette());
+				txt->initText(_big, _small, _lang);
+				if (i == texts.size())
+				{
+					texts.push_back(txt);
+				}
+				else
+				{
+					delete texts[i];
+					texts[i] = txt;
+				}
+			}
+			Text *txt = texts[i];
+			// big text falls back to small if it doesn't fit a line, like when the row was added
+			if (data.big && txt->getHeight() != _big->getHeight())
+			{
+				txt->setHeight(_big->getHeight());
+			}
+			txt->setX(cell.x);
+			txt->setColor(cell.color);
+			txt->setSecondaryColor(cell.color2);
+			txt->setAlign(cell.align);
+			txt->setHighContrast(_contrast);
+			layoutCell(txt, data, cell);
+			if (txt->getHeight() != data.height)
+			{
+				txt->setHeight(data.height);
+			}
+		}
+		_visibleTextRows[slot] = row;
+	}
+	return texts;
+}
+
+/**
+ * Makes the visible texts set themselves up again
+ * the next time they're drawn, after a row changed.
+ * @param row Row that changed, or all of them by default.
+ */
+void TextList::invalidateVisible(size_t row)
+{
+	for (std::vector<size_t>::iterator i = _visibleTextRows.begin(); i < _visibleTextRows.end(); ++i)
+	{
+		if (row == NO_ROW || *i == row)
+		{
+			*i = NO_ROW;
+		}
+	}
+}
+
+/**
+ * Creates arrow buttons until there's a pair for the given amount
+ * of visible rows. They get moved to whichever rows are on screen.
+ * @param count Number of rows.
+ */
+void TextList::addArrows(size_t count)
+{
+	while (_arrowLeft.size() < count)
+	{
+		ArrowShape shape1, shape2;
+		if (_arrowType == ARROW_VERTICAL)
+		{
+			shape1 = ARROW_SMALL_UP;
+			shape2 = ARROW_SMALL_DOWN;
+		}
+		else
+		{
+			shape1 = ARROW_SMALL_LEFT;
+			shape2 = ARROW_SMALL_RIGHT;
+		}
+		// Position defined w.r.t. main window, NOT TextList.
+		ArrowButton *a1 = new ArrowButton(shape1, 11, 8, getX() + _arrowPos, getY());
+		a1->setListButton();
+		a1->setPalette(this->getPalette());
+		a1->setColor(_up->getColor());
+		a1->onMouseClick(_leftClick, 0);
+		a1->onMousePress(_leftPress);
+		a1->onMouseRelease(_leftRelease);
+		_arrowLeft.push_back(a1);
+		ArrowButton *a2 = new ArrowButton(shape2, 11, 8, getX() + _arrowPos + 12, getY());
+		a2->setListButton();
+		a2->setPalette(this->getPalette());
+		a2->setColor(_up->getColor());
+		a2->onMouseClick(_rightClick, 0);
+		a2->onMousePress(_rightPress);
+		a2->onMouseRelease(_rightRelease);
+		_arrowRight.push_back(a2);
+	}
+}
+
 /**
  * Hooks up the button to work as part of an existing combobox,
  * updating the selection when it's pressed.
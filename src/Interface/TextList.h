@@ -40,7 +40,26 @@ class ScrollBar;
 class TextList : public InteractiveSurface
 {
 private:
-	std::vector< std::vector<Text*> > _texts;
+	/// Contents of a cell, only turned into a Text while it's visible.
+	struct Cell
+	{
+		std::string text;
+		int x, width;
+		Uint8 color, color2;
+		TextHAlign align;
+		bool wrap;
+	};
+	/// Contents and layout of a row.
+	struct Row
+	{
+		std::vector<Cell> cells;
+		int y, height;
+		bool big;
+	};
+	std::vector<Row> _texts;
+	std::vector< std::vector<Text*> > _visibleTexts;
+	std::vector<size_t> _visibleTextRows;
+	std::map<int, Text*> _measureTexts;
 	std::vector<size_t> _columns, _rows;
 	Font *_big, *_small, *_font;
 	Language *_lang;
@@ -65,6 +84,16 @@ private:
 	void updateArrows();
 	/// Updates the visible rows.
 	void updateVisible();
+	/// Gets a text for measuring cells of a given width.
+	Text *getMeasureText(int width);
+	/// Lays out the text of a cell.
+	void layoutCell(Text *text, const Row &row, const Cell &cell) const;
+	/// Gets the texts showing a row on screen.
+	const std::vector<Text*> &getVisibleTexts(size_t slot, size_t row);
+	/// Makes the visible texts show their rows again.
+	void invalidateVisible(size_t row = (size_t)-1);
+	/// Creates arrow buttons for the visible rows.
+	void addArrows(size_t count);
 public:
 	/// Creates a text list with the specified size and position.
 	TextList(int width, int height, int x = 0, int y = 0);
@@ -29,11 +29,15 @@
 #include "NewGameState.h"
 #include "NewBattleState.h"
 #include "ListLoadState.h"
+#include "LoadGameState.h"
 #include "OptionsVideoState.h"
 #include "ModListState.h"
 #include "../Engine/Options.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Logger.h"
 #include "../Engine/FileMap.h"
 #include "../Engine/SDL2Helpers.h"
+#include "../Savegame/SaveIndex.h"
 #include <fstream>
 
 namespace OpenXcom
@@ -197,12 +201,40 @@ MainMenuState::MainMenuState(bool updateCheck)
 
 void MainMenuState::init()
 {
+	static bool replayLoaded = false;
+
 	State::init();
-	if (Options::getLoadLastSave() && _game->getSavedGame()->getList(_game->getLanguage(), true).size() > 0)
+	if (replayLoaded)
+	{
+		// back here without the battlescape taking it, the save didn't load
+		Options::replayBattle = "";
+	}
+	if (!Options::replayBattle.empty())
+	{
+		replayLoaded = true;
+		// the battlescape picks up the rest of the replay once the save is loaded
+		std::string filename = Options::replayBattle + ".sav";
+		if (CrossPlatform::fileExists(Options::getMasterUserFolder() + filename))
+		{
+			Log(LOG_INFO) << "Loading battle replay " << Options::replayBattle;
+			_game->pushState(new LoadGameState(OPT_MENU, filename, _palette));
+		}
+		else
+		{
+			Log(LOG_ERROR) << "Battle replay not found: " << filename;
+			Options::replayBattle = "";
+		}
+	}
+	else if (Options::getLoadLastSave() && _game->getSavedGame()->getList(_game->getLanguage(), true).size() > 0)
 	{
 		Log(LOG_INFO) << "Loading last saved game";
 		btnLoadClick(NULL);
 	}
+	else
+	{
+		// get the saves list ready before anyone asks for it
+		SaveIndex::refreshInBackground();
+	}
 }
 
 /**
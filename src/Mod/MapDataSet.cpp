@@ -64,6 +64,21 @@ size_t MapDataSet::getSize() const
 	return _objects.size();
 }
 
+/**
+ * Gets roughly how much memory the loaded objects
+ * and sprites take up.
+ * @return The size in bytes.
+ */
+size_t MapDataSet::getMemorySize() const
+{
+	size_t size = _objects.size() * sizeof(MapData);
+	if (_surfaceSet)
+	{
+		size += _surfaceSet->getTotalFrames() * _surfaceSet->getWidth() * _surfaceSet->getHeight();
+	}
+	return size;
+}
+
 /**
  * Gets the objects in this dataset.
  * @return Pointer to the objects.
@@ -260,6 +275,7 @@ void MapDataSet::unloadData()
 		}
 		_objects.clear();
 		delete _surfaceSet;
+		_surfaceSet = 0;
 		_loaded = false;
 	}
 }
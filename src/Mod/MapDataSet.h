@@ -53,6 +53,8 @@ public:
 	std::string getName() const;
 	/// Gets the dataset size.
 	size_t getSize() const;
+	/// Gets the memory used by the loaded data.
+	size_t getMemorySize() const;
 	/// Gets the objects in this dataset.
 	std::vector<MapData*> *getObjectsRaw();
 	/// Gets an object in this dataset.
@@ -63,6 +65,8 @@ public:
 	void loadData(MCDPatch *patch, bool validate = true);
 	///	Unloads to free memory.
 	void unloadData();
+	/// Checks if the objects are loaded.
+	bool isLoaded() const { return _loaded; }
 	/// Gets a blank floor tile.
 	static MapData *getBlankFloorTile();
 	/// Gets a scorched earth tile.
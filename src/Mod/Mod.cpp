@@ -530,6 +530,7 @@ Mod::Mod()
  */
 Mod::~Mod()
 {
+	Music::stopLoading();
 	delete _muteMusic;
 	delete _muteSound;
 	delete _globe;
@@ -940,6 +941,14 @@ void Mod::playMusic(const std::string &name, int id)
 		if (id == 0)
 		{
 			music = getRandomMusic(name);
+			// the next random pick is likely from the same tracks
+			for (auto& item : _musics)
+			{
+				if (item.second != music && item.first.find(name) != std::string::npos)
+				{
+					item.second->prefetch();
+				}
+			}
 		}
 		else
 		{
@@ -2300,6 +2309,9 @@ void Mod::loadAll()
 	Log(LOG_INFO) << "Loading ended.";
 
 	sortLists();
+	assignRuleIds();
+	linkResearchUnlocks();
+	linkTechTree();
 	modResources();
 }
 
@@ -3851,6 +3863,11 @@ RuleItem *Mod::getItem(const std::string &id, bool error) const
 	{
 		return 0;
 	}
+	auto i = _itemIds.find(id);
+	if (i != _itemIds.end())
+	{
+		return _itemsById[i->second];
+	}
 	return getRule(id, "Item", _items, error);
 }
 
@@ -3924,6 +3941,60 @@ MapDataSet *Mod::getMapDataSet(const std::string &name)
 	}
 }
 
+/**
+ * Loads the data of a map data set for a battle. Sets used by
+ * a recent battle may still be loaded, and are taken out of the
+ * cache until every battle using them has released them again.
+ * @param set Map data set.
+ */
+void Mod::loadMapDataSet(MapDataSet *set)
+{
+	auto cached = std::find(_mapDataSetCache.begin(), _mapDataSetCache.end(), set);
+	if (cached != _mapDataSetCache.end())
+	{
+		_mapDataSetCacheBytes -= std::min(_mapDataSetCacheBytes, set->getMemorySize());
+		_mapDataSetCache.erase(cached);
+	}
+	set->loadData(getMCDPatch(set->getName()));
+	_mapDataSetUsers[set]++;
+}
+
+/**
+ * Releases a map data set loaded with loadMapDataSet().
+ * Once no battle uses it anymore, it's kept loaded for the next one,
+ * and the least recently used sets are unloaded to stay under the
+ * memory budget.
+ * @param set Map data set.
+ */
+void Mod::releaseMapDataSet(MapDataSet *set)
+{
+	auto users = _mapDataSetUsers.find(set);
+	if (users != _mapDataSetUsers.end())
+	{
+		if (--users->second > 0)
+		{
+			return;
+		}
+		_mapDataSetUsers.erase(users);
+	}
+	if (!set->isLoaded() || std::find(_mapDataSetCache.begin(), _mapDataSetCache.end(), set) != _mapDataSetCache.end())
+	{
+		return;
+	}
+
+	_mapDataSetCache.push_front(set);
+	_mapDataSetCacheBytes += set->getMemorySize();
+
+	size_t budget = (size_t)std::max(0, Options::mapDataCacheSize) * 1024 * 1024;
+	while (!_mapDataSetCache.empty() && _mapDataSetCacheBytes > budget)
+	{
+		MapDataSet *oldest = _mapDataSetCache.back();
+		_mapDataSetCacheBytes -= std::min(_mapDataSetCacheBytes, oldest->getMemorySize());
+		_mapDataSetCache.pop_back();
+		oldest->unloadData();
+	}
+}
+
 /**
  * Returns the rules for the specified skill.
  * @param name Skill type.
@@ -4086,6 +4157,39 @@ const std::vector<std::string> &Mod::getArmorsList() const
 	return _armorsIndex;
 }
 
+/**
+ * Gets the manufacture projects, items, crafts and facilities
+ * that list a research project among their requirements.
+ * @param research The research project.
+ * @return Rules requiring it, in list order.
+ */
+const ResearchUnlocks &Mod::getResearchUnlocks(const RuleResearch *research) const
+{
+	static const ResearchUnlocks none;
+	auto i = _researchUnlocksCache.find(research);
+	if (i != _researchUnlocksCache.end())
+	{
+		return i->second;
+	}
+	return none;
+}
+
+/**
+ * Gets the manufacture projects producing a craft.
+ * @param craft Craft rule.
+ * @return List of projects, in the order of the manufacture list.
+ */
+const std::vector<const RuleManufacture*> &Mod::getCraftSources(const RuleCraft *craft) const
+{
+	static const std::vector<const RuleManufacture*> none;
+	auto i = _craftSourcesCache.find(craft);
+	if (i != _craftSourcesCache.end())
+	{
+		return i->second;
+	}
+	return none;
+}
+
 /**
  * Gets the available armors for soldiers.
  */
@@ -4233,6 +4337,11 @@ const std::vector<std::string> &Mod::getInvsList() const
  */
 RuleResearch *Mod::getResearch(const std::string &id, bool error) const
 {
+	auto i = _researchIds.find(id);
+	if (i != _researchIds.end())
+	{
+		return _researchById[i->second];
+	}
 	return getRule(id, "Research", _research, error);
 }
 
@@ -4705,6 +4814,205 @@ struct compareSection
 	}
 };
 
+/**
+ * Gives every item and research project a dense index,
+ * so the savegame can keep per-rule data in flat arrays, and hashes
+ * their names so string lookups don't have to walk the rule maps.
+ */
+void Mod::assignRuleIds()
+{
+	_itemIds.clear();
+	_itemsById.clear();
+	_itemIds.reserve(_items.size());
+	_itemsById.reserve(_items.size());
+	for (auto& pair : _items)
+	{
+		if (pair.second)
+		{
+			pair.second->setId((int)_itemsById.size());
+			_itemIds[pair.first] = pair.second->getId();
+			_itemsById.push_back(pair.second);
+		}
+	}
+
+	_researchIds.clear();
+	_researchById.clear();
+	_researchIds.reserve(_research.size());
+	_researchById.reserve(_research.size());
+	for (auto& pair : _research)
+	{
+		if (pair.second)
+		{
+			pair.second->setId((int)_researchById.size());
+			_researchIds[pair.first] = pair.second->getId();
+			_researchById.push_back(pair.second);
+		}
+	}
+}
+
+/**
+ * Builds the reverse index from research topics to the manufacture projects,
+ * items, crafts and facilities requiring them, so the game doesn't have to
+ * scan every rule when a topic is discovered. Must be done after sorting.
+ */
+void Mod::linkResearchUnlocks()
+{
+	auto add = [](auto &list, auto *rule)
+	{
+		// a rule can list the same topic more than once
+		if (list.empty() || list.back() != rule)
+		{
+			list.push_back(rule);
+		}
+	};
+	for (auto& name : _manufactureIndex)
+	{
+		RuleManufacture *rule = getManufacture(name);
+		for (auto* r : rule->getRequirements())
+		{
+			add(_researchUnlocksCache[r].manufacture, rule);
+		}
+	}
+	for (auto& name : _itemsIndex)
+	{
+		RuleItem *rule = getItem(name);
+		for (auto* r : rule->getRequirements())
+		{
+			add(_researchUnlocksCache[r].items, rule);
+		}
+		for (auto* r : rule->getBuyRequirements())
+		{
+			add(_researchUnlocksCache[r].items, rule);
+		}
+	}
+	for (auto& name : _craftsIndex)
+	{
+		RuleCraft *rule = getCraft(name);
+		for (auto& r : rule->getRequirements())
+		{
+			const RuleResearch *research = getResearch(r);
+			if (research)
+			{
+				add(_researchUnlocksCache[research].crafts, rule);
+			}
+		}
+	}
+	for (auto& name : _facilitiesIndex)
+	{
+		RuleBaseFacility *rule = getBaseFacility(name);
+		for (auto& r : rule->getRequirements())
+		{
+			const RuleResearch *research = getResearch(r);
+			if (research)
+			{
+				add(_researchUnlocksCache[research].facilities, rule);
+			}
+		}
+	}
+}
+
+/**
+ * Builds the rest of the tech tree backwards: which research topics
+ * unlock, disable, reenable, give for free, look up, require or lead to
+ * each topic, and which projects and topics produce each item and craft.
+ * Must be done after assigning the rule ids.
+ */
+void Mod::linkTechTree()
+{
+	std::vector<std::pair<int, const RuleResearch*> > unlockedBy, disabledBy, reenabledBy, getOneFreeFrom, lookupOf, requiredBy, leadsTo, spawnedBy;
+	for (auto& name : _researchIndex)
+	{
+		const RuleResearch *rule = getResearch(name);
+		for (auto* r : rule->getUnlocked())
+		{
+			unlockedBy.push_back(std::make_pair(r->getId(), rule));
+		}
+		for (auto* r : rule->getDisabled())
+		{
+			disabledBy.push_back(std::make_pair(r->getId(), rule));
+		}
+		for (auto* r : rule->getReenabled())
+		{
+			reenabledBy.push_back(std::make_pair(r->getId(), rule));
+		}
+		for (auto* r : rule->getGetOneFree())
+		{
+			getOneFreeFrom.push_back(std::make_pair(r->getId(), rule));
+		}
+		for (auto& protectedFree : rule->getGetOneFreeProtected())
+		{
+			for (auto* r : protectedFree.second)
+			{
+				getOneFreeFrom.push_back(std::make_pair(r->getId(), rule));
+			}
+		}
+		if (!isEmptyRuleName(rule->getLookup()))
+		{
+			const RuleResearch *lookup = getResearch(rule->getLookup());
+			if (lookup)
+			{
+				lookupOf.push_back(std::make_pair(lookup->getId(), rule));
+			}
+		}
+		for (auto* r : rule->getRequirements())
+		{
+			requiredBy.push_back(std::make_pair(r->getId(), rule));
+		}
+		for (auto* r : rule->getDependencies())
+		{
+			leadsTo.push_back(std::make_pair(r->getId(), rule));
+		}
+		if (!isEmptyRuleName(rule->getSpawnedItem()))
+		{
+			const RuleItem *item = getItem(rule->getSpawnedItem());
+			if (item)
+			{
+				spawnedBy.push_back(std::make_pair(item->getId(), rule));
+			}
+		}
+		for (auto& spawned : rule->getSpawnedItemList())
+		{
+			const RuleItem *item = getItem(spawned);
+			if (item)
+			{
+				spawnedBy.push_back(std::make_pair(item->getId(), rule));
+			}
+		}
+	}
+	int researchCount = getResearchIdCount();
+	_researchLinks.unlockedBy.build(researchCount, unlockedBy);
+	_researchLinks.disabledBy.build(researchCount, disabledBy);
+	_researchLinks.reenabledBy.build(researchCount, reenabledBy);
+	_researchLinks.getOneFreeFrom.build(researchCount, getOneFreeFrom);
+	_researchLinks.lookupOf.build(researchCount, lookupOf);
+	_researchLinks.requiredBy.build(researchCount, requiredBy);
+	_researchLinks.leadsTo.build(researchCount, leadsTo);
+	_itemSources.spawnedBy.build((int)_itemsById.size(), spawnedBy);
+
+	std::vector<std::pair<int, const RuleManufacture*> > producedBy;
+	_craftSourcesCache.clear();
+	for (auto& name : _manufactureIndex)
+	{
+		const RuleManufacture *rule = getManufacture(name);
+		for (auto& produced : rule->getProducedItems())
+		{
+			producedBy.push_back(std::make_pair(produced.first->getId(), rule));
+		}
+		for (auto& randomProduced : rule->getRandomProducedItems())
+		{
+			for (auto& produced : randomProduced.second)
+			{
+				producedBy.push_back(std::make_pair(produced.first->getId(), rule));
+			}
+		}
+		if (rule->getProducedCraft())
+		{
+			_craftSourcesCache[rule->getProducedCraft()].push_back(rule);
+		}
+	}
+	_itemSources.producedBy.build((int)_itemsById.size(), producedBy);
+}
+
 /**
  * Sorts all our lists according to their weight.
  */
@@ -6160,7 +6468,11 @@ Music* Mod::loadMusic(MusicFormat fmt, RuleMusic* rule, CatFile* adlibcat, CatFi
 			if (soundContents.find(fname) != soundContents.end())
 			{
 				music = new Music();
-				music->load("SOUND/" + fname);
+				// only the streamed formats are opened in the background
+				if (Options::lazyLoadResources && (fmt == MUSIC_FLAC || fmt == MUSIC_OGG || fmt == MUSIC_MP3))
+					music->defer("SOUND/" + fname);
+				else
+					music->load("SOUND/" + fname);
 			}
 		}
 	}
@@ -18,6 +18,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <map>
+#include <list>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <bitset>
@@ -142,6 +144,86 @@ struct LoadRuleException : Exception
 	}
 };
 
+/**
+ * Rules that list a research topic among their requirements,
+ * in the order of their lists.
+ */
+struct ResearchUnlocks
+{
+	std::vector<RuleManufacture*> manufacture;
+	std::vector<RuleItem*> items;
+	std::vector<RuleCraft*> crafts;
+	std::vector<RuleBaseFacility*> facilities;
+};
+
+/**
+ * Lists of rules linked to other rules, indexed by the dense
+ * id of the rule they're linked to and stored back to back,
+ * so each list can be read without searching.
+ */
+template <typename T>
+class RuleLinks
+{
+private:
+	std::vector<int> _offsets;
+	std::vector<T*> _links;
+public:
+	/// Builds the lists from pairs of id and linked rule, keeping their order.
+	void build(int count, std::vector<std::pair<int, T*> > &links)
+	{
+		std::stable_sort(links.begin(), links.end(), [](const std::pair<int, T*> &a, const std::pair<int, T*> &b) { return a.first < b.first; });
+		_offsets.assign(count + 1, 0);
+		_links.clear();
+		_links.reserve(links.size());
+		for (size_t i = 0; i < links.size(); ++i)
+		{
+			// a rule can be linked the same way more than once
+			if (i > 0 && links[i] == links[i - 1])
+			{
+				continue;
+			}
+			_links.push_back(links[i].second);
+			_offsets[links[i].first + 1] = (int)_links.size();
+		}
+		for (int i = 1; i <= count; ++i)
+		{
+			_offsets[i] = std::max(_offsets[i], _offsets[i - 1]);
+		}
+	}
+	/// Gets the rules linked to the rule with a given id.
+	Collections::Range<T* const*> get(int id) const
+	{
+		if (id < 0 || id + 1 >= (int)_offsets.size())
+		{
+			return Collections::Range<T* const*>(nullptr, nullptr);
+		}
+		return Collections::Range<T* const*>(_links.data() + _offsets[id], _links.data() + _offsets[id + 1]);
+	}
+	/// Checks if any rules are linked to the rule with a given id.
+	bool empty(int id) const
+	{
+		return id < 0 || id + 1 >= (int)_offsets.size() || _offsets[id] == _offsets[id + 1];
+	}
+};
+
+/**
+ * Research topics that point at a research topic,
+ * in the order of the research list.
+ */
+struct ResearchLinks
+{
+	RuleLinks<const RuleResearch> unlockedBy, disabledBy, reenabledBy, getOneFreeFrom, lookupOf, requiredBy, leadsTo;
+};
+
+/**
+ * Rules that produce an item, in the order of their lists.
+ */
+struct ItemSources
+{
+	RuleLinks<const RuleManufacture> producedBy;
+	RuleLinks<const RuleResearch> spawnedBy;
+};
+
 /**
  * Contains all the game-specific static data that never changes
  * throughout the game, like rulesets and resources.
@@ -172,6 +254,9 @@ private:
 	std::map<std::string, RuleUfo*> _ufos;
 	std::map<std::string, RuleTerrain*> _terrains;
 	std::map<std::string, MapDataSet*> _mapDataSets;
+	std::map<MapDataSet*, int> _mapDataSetUsers;
+	std::list<MapDataSet*> _mapDataSetCache;
+	size_t _mapDataSetCacheBytes = 0;
 	std::map<std::string, RuleSkill*> _skills;
 	std::map<std::string, RuleSoldier*> _soldiers;
 	std::map<std::string, Unit*> _units;
@@ -331,6 +416,13 @@ private:
 	std::vector<const Armor*> _armorsForSoldiersCache;
 	std::vector<const RuleItem*> _armorStorageItemsCache;
 	std::vector<const RuleItem*> _craftWeaponStorageItemsCache;
+	std::unordered_map<const RuleResearch*, ResearchUnlocks> _researchUnlocksCache;
+	ResearchLinks _researchLinks;
+	ItemSources _itemSources;
+	std::unordered_map<const RuleCraft*, std::vector<const RuleManufacture*> > _craftSourcesCache;
+	std::unordered_map<std::string, int> _itemIds, _researchIds;
+	std::vector<RuleItem*> _itemsById;
+	std::vector<RuleResearch*> _researchById;
 
 	size_t _surfaceOffsetBigobs = 0;
 	size_t _surfaceOffsetFloorob = 0;
@@ -376,6 +468,12 @@ private:
 	void modResources();
 	/// Sorts all our lists according to their weight.
 	void sortLists();
+	/// Links research topics to the rules they unlock.
+	void linkResearchUnlocks();
+	/// Links rules to the research topics and projects pointing at them.
+	void linkTechTree();
+	/// Assigns dense indexes to the rules looked up the most.
+	void assignRuleIds();
 public:
 	static int DOOR_OPEN;
 	static int SLIDING_DOOR_OPEN;
@@ -711,6 +809,10 @@ public:
 	RuleItem *getItem(const std::string &id, bool error = false) const;
 	/// Gets the available items.
 	const std::vector<std::string> &getItemsList() const;
+	/// Gets the item with the given dense index.
+	RuleItem *getItemById(int id) const { return _itemsById[id]; }
+	/// Gets the number of items with a dense index.
+	int getItemIdCount() const { return (int)_itemsById.size(); }
 	/// Gets the ruleset for a UFO type.
 	RuleUfo *getUfo(const std::string &id, bool error = false) const;
 	/// Gets the available UFOs.
@@ -721,6 +823,10 @@ public:
 	const std::vector<std::string> &getTerrainList() const;
 	/// Gets mapdatafile for battlescape games.
 	MapDataSet *getMapDataSet(const std::string &name);
+	/// Loads a mapdatafile for a battle, reusing it if still cached.
+	void loadMapDataSet(MapDataSet *set);
+	/// Releases a mapdatafile when a battle is done with it.
+	void releaseMapDataSet(MapDataSet *set);
 	/// Gets skill rules.
 	RuleSkill *getSkill(const std::string &name, bool error = false) const;
 	/// Gets soldier unit rules.
@@ -1041,6 +1147,18 @@ public:
 	const std::map<std::string, RuleResearch *> &getResearchMap() const;
 	/// Gets the list of all research projects.
 	const std::vector<std::string> &getResearchList() const;
+	/// Gets the rules that require a research project.
+	const ResearchUnlocks &getResearchUnlocks(const RuleResearch *research) const;
+	/// Gets the research topics pointing at each research topic.
+	const ResearchLinks &getResearchLinks() const { return _researchLinks; }
+	/// Gets the rules producing each item.
+	const ItemSources &getItemSources() const { return _itemSources; }
+	/// Gets the manufacture projects producing a craft.
+	const std::vector<const RuleManufacture*> &getCraftSources(const RuleCraft *craft) const;
+	/// Gets the research project with the given dense index.
+	RuleResearch *getResearchById(int id) const { return _researchById[id]; }
+	/// Gets the number of research projects with a dense index.
+	int getResearchIdCount() const { return (int)_researchById.size(); }
 	/// Gets the ruleset for a specific manufacture project.
 	RuleManufacture *getManufacture (const std::string &id, bool error = false) const;
 	/// Gets the list of all manufacture projects.
@@ -320,6 +320,7 @@ public:
 
 private:
 	std::string _type, _name, _nameAsAmmo; // two types of objects can have the same name
+	int _id = -1;
 	std::string _requiresBuyCountry;
 	std::vector<std::string> _requiresName;
 	std::vector<std::string> _requiresBuyName;
@@ -460,6 +461,10 @@ public:
 	int getExtendedItemReloadCostLocal() const { return _extendedItemReloadCostLocal; }
 	/// Gets the item's type.
 	const std::string &getType() const;
+	/// Gets the dense index of this item, assigned after all rules are loaded.
+	int getId() const { return _id; }
+	/// Sets the dense index of this item.
+	void setId(int id) { _id = id; }
 	/// Gets the item's name.
 	const std::string &getName() const;
 	/// Gets the item's name when loaded in weapon.
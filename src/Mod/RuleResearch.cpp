@@ -98,6 +98,16 @@ void RuleResearch::afterLoad(const Mod* mod)
 	_getOneFree = mod->getResearch(_getOneFreeName);
 	_requires = mod->getResearch(_requiresName);
 
+	// reverse links, so the saved game can track what becomes available without rescanning the whole tree
+	for (auto* r : _dependencies)
+	{
+		mod->getResearch(r->getName(), true)->_dependents.push_back(this);
+	}
+	for (auto* r : _requires)
+	{
+		mod->getResearch(r->getName(), true)->_requiredBy.push_back(this);
+	}
+
 	_getOneFreeProtected.reserve(_getOneFreeProtectedName.size());
 	for (auto& n : _getOneFreeProtectedName)
 	{
@@ -45,6 +45,7 @@ class RuleResearch
 {
  private:
 	std::string _name, _lookup, _cutscene, _spawnedItem, _spawnedEvent;
+	int _id = -1;
 	int _spawnedItemCount;
 	std::vector<std::string> _spawnedItemList;
 	std::vector<std::string> _decreaseCounter, _increaseCounter;
@@ -53,6 +54,7 @@ class RuleResearch
 	RuleBaseFacilityFunctions _requiresBaseFunc;
 	UnitStats _stats;
 	std::vector<const RuleResearch*> _dependencies, _unlocks, _disables, _reenables, _getOneFree, _requires;
+	std::vector<const RuleResearch*> _dependents, _requiredBy;
 	bool _sequentialGetOneFree;
 	std::vector<std::pair<std::string, std::vector<std::string> > > _getOneFreeProtectedName;
 	std::vector<std::pair<const RuleResearch*, std::vector<const RuleResearch*> > > _getOneFreeProtected;
@@ -80,6 +82,10 @@ public:
 	int getCost() const;
 	/// Gets the research name.
 	const std::string &getName() const;
+	/// Gets the dense index of this research, assigned after all rules are loaded.
+	int getId() const { return _id; }
+	/// Sets the dense index of this research.
+	void setId(int id) { _id = id; }
 	/// Gets the research dependencies.
 	const std::vector<const RuleResearch*> &getDependencies() const;
 	/// Checks if this ResearchProject gives free topics in sequential order (or random order).
@@ -108,6 +114,10 @@ public:
 	const std::string &getLookup() const;
 	/// Gets the requirements for this ResearchProject.
 	const std::vector<const RuleResearch*> &getRequirements() const;
+	/// Gets the ResearchProjects that have this one as a dependency.
+	const std::vector<const RuleResearch*> &getDependents() const { return _dependents; }
+	/// Gets the ResearchProjects that have this one as a requirement.
+	const std::vector<const RuleResearch*> &getRequiredBy() const { return _requiredBy; }
 	/// Gets the base requirements for this ResearchProject.
 	RuleBaseFacilityFunctions getRequireBaseFunc() const { return _requiresBaseFunc; }
 	/// Get pointer to this ResearchProject's stats.
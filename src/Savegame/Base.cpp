@@ -61,7 +61,8 @@ namespace OpenXcom
  * @param mod Pointer to mod.
  */
 Base::Base(const Mod *mod): Target(), _mod(mod), _scientists(0), _engineers(0), _trackingBonus(0), _operationsBonus(0), _deploymentHintsBonus(0), _inBattlescape(false),
-	  _retaliationTarget(false), _retaliationMission(nullptr), _fakeUnderwater(false)
+	  _retaliationTarget(false), _retaliationMission(nullptr), _fakeUnderwater(false), _transfersChanged(true),
+	  _capacitiesValid(false), _capacitiesFacilityCount(0)
 {
 	_items = new ItemContainer();
 }
@@ -593,15 +594,6 @@ int Base::getMarker() const
 	return 0;
 }
 
-/**
- * Returns the list of facilities in the base.
- * @return Pointer to the facility list.
- */
-std::vector<BaseFacility*> *Base::getFacilities()
-{
-	return &_facilities;
-}
-
 /**
  * Returns the list of soldiers in the base.
  * @return Pointer to the soldier list.
@@ -684,15 +676,7 @@ void Base::removePrisoner(BasePrisoner* prisoner)
 
 int Base::getAvailableInterrogationSpace()
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getInterrogationSpace();
-		}
-	}
-	return total;
+	return getCapacities().interrogation;
 }
 
 int Base::getUsedInterrogationSpace()
@@ -712,6 +696,24 @@ int Base::getUsedInterrogationSpace()
 	return used;
 }
 
+/**
+ * Finds the transfer to this base that is waiting
+ * for the given arrival event.
+ * @param event Id of the event.
+ * @return Pointer to the transfer, or nullptr if there's none.
+ */
+Transfer *Base::findTransfer(int event) const
+{
+	for (Transfer *transfer : _transfers)
+	{
+		if (transfer->getEvent() == event)
+		{
+			return transfer;
+		}
+	}
+	return nullptr;
+}
+
 /**
  * Returns the amount of scientists currently in the base.
  * @return Number of scientists.
@@ -1099,23 +1101,81 @@ int Base::getUsedQuarters() const
 }
 
 /**
- * Returns the total amount of living quarters
- * available in the base.
- * @return Living space.
+ * Compares two sets of facility capacities.
+ * @param other The capacities to compare with.
+ * @return True if all of them are equal.
  */
-int Base::getAvailableQuarters() const
+bool Base::FacilityCapacities::operator==(const FacilityCapacities &other) const
 {
-	int total = 0;
+	return stores == other.stores && laboratories == other.laboratories && workshops == other.workshops
+		&& quarters == other.quarters && hangars == other.hangars && psiLabs == other.psiLabs
+		&& training == other.training && interrogation == other.interrogation
+		&& prisonSpace == other.prisonSpace && containment == other.containment;
+}
+
+/**
+ * Sums up the space provided by all the finished facilities in the base.
+ * @return Capacities of the base.
+ */
+Base::FacilityCapacities Base::calculateCapacities() const
+{
+	FacilityCapacities total;
 	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
 	{
 		if ((*i)->getBuildTime() == 0)
 		{
-			total += (*i)->getRules()->getPersonnel();
+			const RuleBaseFacility *rules = (*i)->getRules();
+			total.stores += rules->getStorage();
+			total.laboratories += rules->getLaboratories();
+			total.workshops += rules->getWorkshops();
+			total.quarters += rules->getPersonnel();
+			total.hangars += rules->getCrafts();
+			total.psiLabs += rules->getPsiLaboratories();
+			total.training += rules->getTrainingFacilities();
+			total.interrogation += rules->getInterrogationSpace();
+			total.prisonSpace += rules->getFtAPrisoneSpace();
+			total.containment[rules->getPrisonType()] += rules->getAliens();
 		}
 	}
 	return total;
 }
 
+/**
+ * Gets the space provided by the finished facilities in the base.
+ * The sums are only recalculated after a facility was added, removed
+ * or changed its build time, since the UI asks for them on every row.
+ * @return Capacities of the base.
+ */
+const Base::FacilityCapacities &Base::getCapacities() const
+{
+	if (!_capacitiesValid || _capacitiesFacilityCount != _facilities.size())
+	{
+		_capacities = calculateCapacities();
+		_capacitiesValid = true;
+		_capacitiesFacilityCount = _facilities.size();
+	}
+	else if (Options::checkBaseCapacities)
+	{
+		FacilityCapacities check = calculateCapacities();
+		if (!(check == _capacities))
+		{
+			Log(LOG_ERROR) << "Base " << _name << ": facility capacities were not invalidated.";
+			_capacities = check;
+		}
+	}
+	return _capacities;
+}
+
+/**
+ * Returns the total amount of living quarters
+ * available in the base.
+ * @return Living space.
+ */
+int Base::getAvailableQuarters() const
+{
+	return getCapacities().quarters;
+}
+
 /**
  * Returns the amount of stores used up by equipment in the base,
  * and equipment about to arrive.
@@ -1177,15 +1237,7 @@ bool Base::storesOverfullCritical() const
  */
 int Base::getAvailableStores() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getStorage();
-		}
-	}
-	return total;
+	return getCapacities().stores;
 }
 
 /**
@@ -1229,15 +1281,7 @@ int Base::getUsedLaboratories(bool fta, ResearchProject *exclude) const
  */
 int Base::getAvailableLaboratories() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getLaboratories();
-		}
-	}
-	return total;
+	return getCapacities().laboratories;
 }
 
 /**
@@ -1283,15 +1327,7 @@ int Base::getUsedWorkshops(bool fta, Production* exclude) const
  */
 int Base::getAvailableWorkshops() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getWorkshops();
-		}
-	}
-	return total;
+	return getCapacities().workshops;
 }
 
 /**
@@ -1327,15 +1363,7 @@ int Base::getUsedHangars() const
  */
 int Base::getAvailableHangars() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getCrafts();
-		}
-	}
-	return total;
+	return getCapacities().hangars;
 }
 
 /**
@@ -1725,15 +1753,7 @@ const std::vector<Production *> & Base::getProductions() const
  */
 int Base::getAvailablePsiLabs() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getPsiLaboratories();
-		}
-	}
-	return total;
+	return getCapacities().psiLabs;
 }
 
 /**
@@ -1772,15 +1792,7 @@ int Base::getUsedPsiLabs() const
  */
 int Base::getAvailableTraining() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getTrainingFacilities();
-		}
-	}
-	return total;
+	return getCapacities().training;
 }
 
 /**
@@ -1865,28 +1877,14 @@ int Base::getUsedContainment(int prisonType, bool onlyExternal) const
  */
 int Base::getAvailableContainment(int prisonType) const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0 && (*i)->getRules()->getPrisonType() == prisonType)
-		{
-			total += (*i)->getRules()->getAliens();
-		}
-	}
-	return total;
+	const std::map<int, int> &containment = getCapacities().containment;
+	std::map<int, int>::const_iterator i = containment.find(prisonType);
+	return i != containment.end() ? i->second : 0;
 }
 
 int Base::getAvailablePrisonSpace() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getFtAPrisoneSpace();
-		}
-	}
-	return total;
+	return getCapacities().prisonSpace;
 }
 
 /**
@@ -2113,6 +2111,7 @@ int Base::damageFacility(BaseFacility *toBeDamaged)
 		fac->setY(toBeDamaged->getY());
 		fac->setBuildTime(0);
 		_facilities.push_back(fac);
+		_capacitiesValid = false;
 
 		// move the craft from the original hangar to the damaged hangar
 		if (fac->getRules()->getCrafts() > 0)
@@ -2134,6 +2133,7 @@ int Base::damageFacility(BaseFacility *toBeDamaged)
 				_facilities.push_back(fac);
 			}
 		}
+		_capacitiesValid = false;
 	}
 
 	// 2. Now destroy the original
@@ -2435,6 +2435,7 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 	_destroyedFacilitiesCache[(*facility)->getRules()] += 1;
 	delete *facility;
 	_facilities.erase(facility);
+	_capacitiesValid = false;
 }
 
 /**
@@ -108,12 +108,29 @@ private:
 	bool _retaliationTarget;
 	AlienMission* _retaliationMission;
 	bool _fakeUnderwater;
+	bool _transfersChanged;
+	/// Capacities provided by the finished facilities.
+	struct FacilityCapacities
+	{
+		int stores = 0, laboratories = 0, workshops = 0, quarters = 0, hangars = 0;
+		int psiLabs = 0, training = 0, interrogation = 0, prisonSpace = 0;
+		std::map<int, int> containment;
+
+		bool operator==(const FacilityCapacities &other) const;
+	};
+	mutable FacilityCapacities _capacities;
+	mutable bool _capacitiesValid;
+	mutable size_t _capacitiesFacilityCount;
 	std::vector<Vehicle*> _vehicles;
 	std::vector<Vehicle*> _vehiclesFromBase;
 	std::vector<BaseFacility*> _defenses;
 	std::map<const RuleBaseFacility*, int> _destroyedFacilitiesCache;
 
 	using Target::load;
+	/// Sums up the capacities of the finished facilities.
+	FacilityCapacities calculateCapacities() const;
+	/// Gets the facility capacities, recalculating them if outdated.
+	const FacilityCapacities &getCapacities() const;
 public:
 	/// Creates a new base.
 	Base(const Mod *mod);
@@ -133,8 +150,12 @@ public:
 	std::string getName(Language *lang = 0) const override;
 	/// Gets the base's marker sprite.
 	int getMarker() const override;
+	/// Gets the base's facilities, to add or remove some.
+	std::vector<BaseFacility*> *getFacilities() { return &_facilities; }
 	/// Gets the base's facilities.
-	std::vector<BaseFacility*> *getFacilities();
+	const std::vector<BaseFacility*> *getFacilities() const { return &_facilities; }
+	/// Marks the facility capacities as outdated, after adding or removing facilities.
+	void invalidateCapacities() { _capacitiesValid = false; }
 	/// Gets the base's soldiers.
 	std::vector<Soldier*> *getSoldiers();
 	std::vector<Soldier*> getPersonnel(SoldierRole role) const;
@@ -168,10 +189,16 @@ public:
 	int getAvailableInterrogationSpace();
 	/// Gets used interrogation space.
 	int getUsedInterrogationSpace();
-	/// Gets the base's transfers.
-	std::vector<Transfer*> *getTransfers() { return &_transfers; }
+	/// Gets the base's transfers, which may be changed through it.
+	std::vector<Transfer*> *getTransfers() { _transfersChanged = true; return &_transfers; }
 	/// Gets the base's transfers.
 	const std::vector<Transfer*> *getTransfers() const { return &_transfers; }
+	/// Checks if the transfers may have changed since the last time they were scheduled.
+	bool getTransfersChanged() const { return _transfersChanged; }
+	/// Marks the transfers as scheduled.
+	void clearTransfersChanged() { _transfersChanged = false; }
+	/// Finds the transfer with an arrival event.
+	Transfer *findTransfer(int event) const;
 	/// Gets the base's items.
 	ItemContainer *getStorageItems() { return _items; }
 	/// Gets the base's items.
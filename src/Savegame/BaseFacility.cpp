@@ -162,6 +162,10 @@ int BaseFacility::getAdjustedBuildTime() const
 void BaseFacility::setBuildTime(int time)
 {
 	_buildTime = time;
+	if (_base)
+	{
+		_base->invalidateCapacities();
+	}
 }
 
 /**
@@ -172,6 +176,10 @@ void BaseFacility::build()
 	_buildTime--;
 	if (_buildTime <= 0)
 		_hadPreviousFacility = false;
+	if (_base)
+	{
+		_base->invalidateCapacities();
+	}
 }
 
 /**
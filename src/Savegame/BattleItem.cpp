@@ -31,11 +31,24 @@
 #include "../Engine/Script.h"
 #include "../Engine/ScriptBind.h"
 #include "../Engine/RNG.h"
+#include "SerializationHelper.h"
 #include "../fmath.h"
 
 namespace OpenXcom
 {
 
+/// How many bytes various fields use in a serialized item. See header.
+BattleItem::SerializationKey BattleItem::serializationKey =
+{4, // index: id, owner, previous owner, unit, four ammo items
+ 2, // type
+ 2, // slot
+ 2, // position, three of these
+ 2, // small: inventory x/y, painkiller, heal, stimulant, fuse timer, move cost
+ 4, // quantity
+ 1, // one 8-bit bool field
+ 4 + 2 + 4*3 + 2*3 + 4*RuleItem::AmmoSlotMax + 2 + 2*7 + 4 + 1 // total bytes to save one item
+};
+
 /**
  * Initializes a item of the specified type.
  * @param rules Pointer to ruleset.
@@ -206,6 +219,76 @@ YAML::Node BattleItem::save(const ScriptGlobal *shared) const
 	return node;
 }
 
+/**
+ * Loads the item from binary. The id, type and the links to units,
+ * tile and ammo that precede it in the buffer are read by the battle.
+ * @param buffer Pointer to the item's own data.
+ * @param serKey Serialization key.
+ * @param slots Inventory slot table of the save.
+ * @param tags Script values of all binary items, by id.
+ * @param shared Script global data.
+ */
+void BattleItem::loadBinary(Uint8 *buffer, const BattleItem::SerializationKey &serKey, const std::vector<RuleInventory*> &slots, const YAML::Node &tags, const ScriptGlobal *shared)
+{
+	int slot = unserializeInt(&buffer, serKey.slot);
+	if (slot >= 0 && slot < (int)slots.size())
+	{
+		_inventorySlot = slots[slot];
+	}
+	_inventoryX = unserializeInt(&buffer, serKey.small);
+	_inventoryY = unserializeInt(&buffer, serKey.small);
+	_ammoQuantity = unserializeInt(&buffer, serKey.quantity);
+	_painKiller = unserializeInt(&buffer, serKey.small);
+	_heal = unserializeInt(&buffer, serKey.small);
+	_stimulant = unserializeInt(&buffer, serKey.small);
+	int fuseTimer = unserializeInt(&buffer, serKey.small);
+	if (fuseTimer != -1)
+	{
+		setFuseTimer(fuseTimer);
+	}
+	_inventoryMoveCostPercent = unserializeInt(&buffer, serKey.small);
+
+	Uint8 boolFields = unserializeInt(&buffer, serKey.boolFields);
+	if (boolFields & 1)
+	{
+		_fuseEnabled = true;
+	}
+	_droppedOnAlienTurn = (boolFields & 2) ? true : false;
+	_XCOMProperty = (boolFields & 4) ? true : false;
+
+	if (tags)
+	{
+		_scriptValues.load(tags, shared, std::to_string(_id));
+	}
+}
+
+/**
+ * Saves the item to binary. The id, type and the links to units,
+ * tile and ammo that precede it in the buffer are written by the battle.
+ * @param buffer Pointer to buffer.
+ * @param slots Inventory slot table of the save.
+ * @param tags Script values of all binary items, by id.
+ * @param shared Script global data.
+ */
+void BattleItem::saveBinary(Uint8 **buffer, const std::map<const RuleInventory*, int> &slots, YAML::Node &tags, const ScriptGlobal *shared) const
+{
+	std::map<const RuleInventory*, int>::const_iterator slot = slots.find(_inventorySlot);
+	serializeInt(buffer, serializationKey.slot, slot != slots.end() ? slot->second : -1);
+	serializeInt(buffer, serializationKey.small, _inventoryX);
+	serializeInt(buffer, serializationKey.small, _inventoryY);
+	serializeInt(buffer, serializationKey.quantity, _ammoQuantity);
+	serializeInt(buffer, serializationKey.small, _painKiller);
+	serializeInt(buffer, serializationKey.small, _heal);
+	serializeInt(buffer, serializationKey.small, _stimulant);
+	serializeInt(buffer, serializationKey.small, _fuseTimer);
+	serializeInt(buffer, serializationKey.small, _inventoryMoveCostPercent);
+
+	Uint8 boolFields = (_fuseEnabled?1:0) + (_droppedOnAlienTurn?2:0) + (_XCOMProperty?4:0);
+	serializeInt(buffer, serializationKey.boolFields, boolFields);
+
+	_scriptValues.save(tags, shared, std::to_string(_id));
+}
+
 /**
  * Gets the ruleset for the item's type.
  * @return Pointer to ruleset.
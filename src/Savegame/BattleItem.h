@@ -17,6 +17,8 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <map>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 #include "../Mod/RuleItem.h"
 #include "../Engine/Script.h"
@@ -68,12 +70,27 @@ private:
 
 public:
 
+	static struct SerializationKey
+	{
+		// how many bytes to store for each variable or each member of array of the same name
+		Uint8 index; // item id, and ids of the owners and loaded ammo
+		Uint8 type; // index in the item type table
+		Uint8 slot; // index in the inventory slot table
+		Uint8 position; // each coordinate of the tile the item lies on
+		Uint8 small; // inventory x/y, medikit charges, fuse timer, move cost
+		Uint8 quantity; // ammo quantity
+		Uint8 boolFields;
+		Uint32 totalBytes; // per structure, including any data not mentioned here and accounting for all array members!
+	} serializationKey;
+
 	/// Name of class used in script.
 	static constexpr const char *ScriptName = "BattleItem";
 	/// Register all useful function used by script.
 	static void ScriptRegister(ScriptParserBase* parser);
 	/// Init all required data in script using object data.
 	static void ScriptFill(ScriptWorkerBlit* w, const BattleItem* item, const SavedBattleGame* save, int part, int anim_frame, int shade);
+	/// Get all script values.
+	const ScriptValues<BattleItem> &getScriptValuesRaw() const { return _scriptValues; }
 
 	/// Creates a item of the specified type.
 	BattleItem(const RuleItem *rules, int *id);
@@ -83,6 +100,10 @@ public:
 	void load(const YAML::Node& node, Mod *mod, const ScriptGlobal *shared);
 	/// Saves the item to YAML.
 	YAML::Node save(const ScriptGlobal *shared) const;
+	/// Loads the item from binary.
+	void loadBinary(Uint8 *buffer, const SerializationKey &serKey, const std::vector<RuleInventory*> &slots, const YAML::Node &tags, const ScriptGlobal *shared);
+	/// Saves the item to binary.
+	void saveBinary(Uint8 **buffer, const std::map<const RuleInventory*, int> &slots, YAML::Node &tags, const ScriptGlobal *shared) const;
 	/// Gets the item's ruleset.
 	const RuleItem *getRules() const;
 	/// Gets the item's ammo quantity
@@ -51,12 +51,24 @@
 #include "SavedBattleGame.h"
 #include "../Engine/ShaderDraw.h"
 #include "BattleUnitStatistics.h"
+#include "SerializationHelper.h"
 #include "../fmath.h"
 #include "../fallthrough.h"
 
 namespace OpenXcom
 {
 
+/// How many bytes various fields use in a serialized unit. See header.
+BattleUnit::SerializationKey BattleUnit::serializationKey =
+{4, // index: id, murderer id, mind controller id
+ 2, // type: unit type and armor, as indexes into the tables of the save
+ 2, // position, three of these
+ 2, // small: factions, status, directions, turret, rank, kills, turn counters, fire, armor, wounds, experience
+ 4, // value: tu, health, mana, stun, energy, morale, motion points
+ 4, // one 32-bit bool field
+ 4*3 + 2*2 + 2*3 + 2*(17 + SIDE_MAX + BODYPART_MAX + 8) + 4*7 + 4 // total bytes to save one unit
+};
+
 /**
  * Initializes a BattleUnit from a Soldier
  * @param soldier Pointer to the Soldier.
@@ -713,7 +725,6 @@ void BattleUnit::load(const YAML::Node &node, const Mod *mod, const ScriptGlobal
 	_exp.psiStrength = node["expPsiStrength"].as<int>(_exp.psiStrength);
 	_exp.mana = node["expMana"].as<int>(_exp.mana);
 	_exp.melee = node["expMelee"].as<int>(_exp.melee);
-	_stats = node["currStats"].as<UnitStats>(_stats);
 	_turretType = node["turretType"].as<int>(_turretType);
 	_visible = node["visible"].as<bool>(_visible);
 	_wasFriendlyFired = node["wasFriendlyFired"].as<bool>(_wasFriendlyFired);
@@ -730,6 +741,32 @@ void BattleUnit::load(const YAML::Node &node, const Mod *mod, const ScriptGlobal
 	_freshReinforcement = node["freshReinforcement"].as<bool>(_freshReinforcement);
 	_dontReselect = node["dontReselect"].as<bool>(_dontReselect);
 	_charging = 0;
+	_motionPoints = node["motionPoints"].as<int>(0);
+	_alreadyRespawned = node["alreadyRespawned"].as<bool>(_alreadyRespawned);
+	_murdererId = node["murdererId"].as<int>(_murdererId);
+	_fatalShotSide = (UnitSide)node["fatalShotSide"].as<int>(_fatalShotSide);
+	_fatalShotBodyPart = (UnitBodyPart)node["fatalShotBodyPart"].as<int>(_fatalShotBodyPart);
+	_mindControllerID = node["mindControllerID"].as<int>(_mindControllerID);
+	_summonedPlayerUnit = node["summonedPlayerUnit"].as<bool>(_summonedPlayerUnit);
+	_resummonedFakeCivilian = node["resummonedFakeCivilian"].as<bool>(_resummonedFakeCivilian);
+	_pickUpWeaponsMoreActively = node["pickUpWeaponsMoreActively"].as<bool>(_pickUpWeaponsMoreActively);
+	_disableIndicators = node["disableIndicators"].as<bool>(_disableIndicators);
+	_movementType = (MovementType)node["movementType"].as<int>(_movementType);
+	_vip = node["vip"].as<bool>(_vip);
+	_bannedInNextStage = node["bannedInNextStage"].as<bool>(_bannedInNextStage);
+
+	loadNested(node, mod, shared);
+}
+
+/**
+ * Loads the parts of the unit that don't fit in a flat record:
+ * stats, statistics, recolors, move costs, script values and the like.
+ * Used by both the YAML and the binary format.
+ * @param node YAML node.
+ */
+void BattleUnit::loadNested(const YAML::Node &node, const Mod *mod, const ScriptGlobal *shared)
+{
+	_stats = node["currStats"].as<UnitStats>(_stats);
 	if (node["roles"])
 		loadRoles(node["roles"].as<std::vector<int> >());
 
@@ -743,17 +780,12 @@ void BattleUnit::load(const YAML::Node &node, const Mod *mod, const ScriptGlobal
 		}
 	}
 
-	_motionPoints = node["motionPoints"].as<int>(0);
-	_alreadyRespawned = node["alreadyRespawned"].as<bool>(_alreadyRespawned);
 	_activeHand = node["activeHand"].as<std::string>(_activeHand);
 	_preferredHandForReactions = node["preferredHandForReactions"].as<std::string>(_preferredHandForReactions);
 	if (node["tempUnitStatistics"])
 	{
 		_statistics->load(node["tempUnitStatistics"]);
 	}
-	_murdererId = node["murdererId"].as<int>(_murdererId);
-	_fatalShotSide = (UnitSide)node["fatalShotSide"].as<int>(_fatalShotSide);
-	_fatalShotBodyPart = (UnitBodyPart)node["fatalShotBodyPart"].as<int>(_fatalShotBodyPart);
 	_murdererWeapon = node["murdererWeapon"].as<std::string>(_murdererWeapon);
 	_murdererWeaponAmmo = node["murdererWeaponAmmo"].as<std::string>(_murdererWeaponAmmo);
 
@@ -765,20 +797,12 @@ void BattleUnit::load(const YAML::Node &node, const Mod *mod, const ScriptGlobal
 			_recolor.push_back(std::make_pair(p[i][0].as<int>(), p[i][1].as<int>()));
 		}
 	}
-	_mindControllerID = node["mindControllerID"].as<int>(_mindControllerID);
-	_summonedPlayerUnit = node["summonedPlayerUnit"].as<bool>(_summonedPlayerUnit);
-	_resummonedFakeCivilian = node["resummonedFakeCivilian"].as<bool>(_resummonedFakeCivilian);
-	_pickUpWeaponsMoreActively = node["pickUpWeaponsMoreActively"].as<bool>(_pickUpWeaponsMoreActively);
-	_disableIndicators = node["disableIndicators"].as<bool>(_disableIndicators);
-	_movementType = (MovementType)node["movementType"].as<int>(_movementType);
 	if (const YAML::Node& p = node["moveCost"])
 	{
 		_moveCostBase.load(p["basePercent"]);
 		_moveCostBaseFly.load(p["baseFlyPercent"]);
 		_moveCostBaseNormal.load(p["baseNormalPercent"]);
 	}
-	_vip = node["vip"].as<bool>(_vip);
-	_bannedInNextStage = node["bannedInNextStage"].as<bool>(_bannedInNextStage);
 	_meleeAttackedBy = node["meleeAttackedBy"].as<std::vector<int> >(_meleeAttackedBy);
 
 	_scriptValues.load(node, shared);
@@ -825,7 +849,6 @@ YAML::Node BattleUnit::save(const ScriptGlobal *shared) const
 	node["expPsiStrength"] = _exp.psiStrength;
 	node["expMana"] = _exp.mana;
 	node["expMelee"] = _exp.melee;
-	node["currStats"] = _stats;
 	if (_turretType > -1)
 		node["turretType"] = _turretType;
 	if (_visible)
@@ -839,10 +862,6 @@ YAML::Node BattleUnit::save(const ScriptGlobal *shared) const
 	node["turnsSinceStunned"] = _turnsSinceStunned;
 	node["rankInt"] = _rankInt;
 	node["moraleRestored"] = _moraleRestored;
-	if (getAIModule())
-	{
-		node["AI"] = getAIModule()->save();
-	}
 	node["killedBy"] = (int)_killedBy; // does not have a default value, must always be saved
 	if (_originalFaction != _faction)
 		node["originalFaction"] = (int)_originalFaction;
@@ -856,6 +875,49 @@ YAML::Node BattleUnit::save(const ScriptGlobal *shared) const
 		node["freshReinforcement"] = _freshReinforcement;
 	if (_faction == FACTION_PLAYER && _dontReselect)
 		node["dontReselect"] = _dontReselect;
+	node["motionPoints"] = _motionPoints;
+	if (_alreadyRespawned)
+		node["alreadyRespawned"] = _alreadyRespawned;
+	if (_murdererId)
+		node["murdererId"] = _murdererId;
+	if (_fatalShotSide)
+		node["fatalShotSide"] = (int)_fatalShotSide;
+	if (_fatalShotBodyPart)
+		node["fatalShotBodyPart"] = (int)_fatalShotBodyPart;
+	if (_mindControllerID)
+		node["mindControllerID"] = _mindControllerID;
+	if (_summonedPlayerUnit)
+		node["summonedPlayerUnit"] = _summonedPlayerUnit;
+	if (_resummonedFakeCivilian)
+		node["resummonedFakeCivilian"] = _resummonedFakeCivilian;
+	if (_pickUpWeaponsMoreActively)
+		node["pickUpWeaponsMoreActively"] = _pickUpWeaponsMoreActively;
+	if (_disableIndicators)
+		node["disableIndicators"] = _disableIndicators;
+	if (_originalMovementType != _movementType)
+		node["movementType"] = (int)_movementType;
+	if (_vip)
+		node["vip"] = _vip;
+	if (_bannedInNextStage)
+		node["bannedInNextStage"] = _bannedInNextStage;
+
+	saveNested(node, shared);
+
+	return node;
+}
+
+/**
+ * Saves the parts of the unit that don't fit in a flat record.
+ * Used by both the YAML and the binary format.
+ * @param node YAML node to add them to.
+ */
+void BattleUnit::saveNested(YAML::Node &node, const ScriptGlobal *shared) const
+{
+	node["currStats"] = _stats;
+	if (getAIModule())
+	{
+		node["AI"] = getAIModule()->save();
+	}
 
 	if (_spawnUnit)
 	{
@@ -864,19 +926,10 @@ YAML::Node BattleUnit::save(const ScriptGlobal *shared) const
 		node["spawnUnitFaction"] = (int)_spawnUnitFaction;
 	}
 
-	node["motionPoints"] = _motionPoints;
-	if (_alreadyRespawned)
-		node["alreadyRespawned"] = _alreadyRespawned;
 	node["activeHand"] = _activeHand;
 	if (!_preferredHandForReactions.empty())
 		node["preferredHandForReactions"] = _preferredHandForReactions;
 	node["tempUnitStatistics"] = _statistics->save();
-	if (_murdererId)
-		node["murdererId"] = _murdererId;
-	if (_fatalShotSide)
-		node["fatalShotSide"] = (int)_fatalShotSide;
-	if (_fatalShotBodyPart)
-		node["fatalShotBodyPart"] = (int)_fatalShotBodyPart;
 	if (!_murdererWeapon.empty())
 		node["murdererWeapon"] = _murdererWeapon;
 	if (!_murdererWeaponAmmo.empty())
@@ -890,19 +943,6 @@ YAML::Node BattleUnit::save(const ScriptGlobal *shared) const
 		p.push_back((int)_recolor[i].second);
 		node["recolor"].push_back(p);
 	}
-	if (_mindControllerID)
-		node["mindControllerID"] = _mindControllerID;
-	if (_summonedPlayerUnit)
-		node["summonedPlayerUnit"] = _summonedPlayerUnit;
-	if (_resummonedFakeCivilian)
-		node["resummonedFakeCivilian"] = _resummonedFakeCivilian;
-	if (_pickUpWeaponsMoreActively)
-		node["pickUpWeaponsMoreActively"] = _pickUpWeaponsMoreActively;
-	if (_disableIndicators)
-		node["disableIndicators"] = _disableIndicators;
-
-	if (_originalMovementType != _movementType)
-		node["movementType"] = (int)_movementType;
 
 	{
 		YAML::Node p;
@@ -924,18 +964,156 @@ YAML::Node BattleUnit::save(const ScriptGlobal *shared) const
 			node["moveCost"] = p;
 		}
 	}
-	if (_vip)
-		node["vip"] = _vip;
-	if (_bannedInNextStage)
-		node["bannedInNextStage"] = _bannedInNextStage;
 	if (!_meleeAttackedBy.empty())
 	{
 		node["meleeAttackedBy"] = _meleeAttackedBy;
 	}
 
 	_scriptValues.save(node, shared);
+}
 
-	return node;
+/**
+ * Loads the unit from binary. The id, type, armor and original faction
+ * that precede it in the buffer are read by the battle, as it needs them
+ * to create the unit; the rest is loaded from the nested YAML.
+ * @param buffer Pointer to the unit's own data.
+ * @param serKey Serialization key.
+ * @param sides Number of armor sides in the data.
+ * @param bodyParts Number of body parts in the data.
+ * @param nested Nested data of the unit.
+ */
+void BattleUnit::loadBinary(Uint8 *buffer, const BattleUnit::SerializationKey &serKey, int sides, int bodyParts, const YAML::Node &nested, const Mod *mod, const ScriptGlobal *shared)
+{
+	_faction = (UnitFaction)unserializeInt(&buffer, serKey.small);
+	_status = (UnitStatus)unserializeInt(&buffer, serKey.small);
+	_pos.x = unserializeInt(&buffer, serKey.position);
+	_pos.y = unserializeInt(&buffer, serKey.position);
+	_pos.z = unserializeInt(&buffer, serKey.position);
+	_direction = _toDirection = unserializeInt(&buffer, serKey.small);
+	_directionTurret = _toDirectionTurret = unserializeInt(&buffer, serKey.small);
+	_turretType = unserializeInt(&buffer, serKey.small);
+	_tu = unserializeInt(&buffer, serKey.value);
+	_health = unserializeInt(&buffer, serKey.value);
+	_mana = unserializeInt(&buffer, serKey.value);
+	_stunlevel = unserializeInt(&buffer, serKey.value);
+	_energy = unserializeInt(&buffer, serKey.value);
+	_morale = unserializeInt(&buffer, serKey.value);
+	_motionPoints = unserializeInt(&buffer, serKey.value);
+	for (int i = 0; i < sides; i++)
+	{
+		int armor = unserializeInt(&buffer, serKey.small);
+		if (i < SIDE_MAX)
+			_currentArmor[i] = armor;
+	}
+	for (int i = 0; i < bodyParts; i++)
+	{
+		int wounds = unserializeInt(&buffer, serKey.small);
+		if (i < BODYPART_MAX)
+			_fatalWounds[i] = wounds;
+	}
+	_fire = unserializeInt(&buffer, serKey.small);
+	_exp.bravery = unserializeInt(&buffer, serKey.small);
+	_exp.reactions = unserializeInt(&buffer, serKey.small);
+	_exp.firing = unserializeInt(&buffer, serKey.small);
+	_exp.throwing = unserializeInt(&buffer, serKey.small);
+	_exp.psiSkill = unserializeInt(&buffer, serKey.small);
+	_exp.psiStrength = unserializeInt(&buffer, serKey.small);
+	_exp.mana = unserializeInt(&buffer, serKey.small);
+	_exp.melee = unserializeInt(&buffer, serKey.small);
+	_turnsSinceSpotted = unserializeInt(&buffer, serKey.small);
+	_turnsLeftSpottedForSnipers = unserializeInt(&buffer, serKey.small);
+	_turnsSinceStunned = unserializeInt(&buffer, serKey.small);
+	_killedBy = (UnitFaction)unserializeInt(&buffer, serKey.small);
+	_moraleRestored = unserializeInt(&buffer, serKey.small);
+	_rankInt = unserializeInt(&buffer, serKey.small);
+	_kills = unserializeInt(&buffer, serKey.small);
+	_fatalShotSide = (UnitSide)unserializeInt(&buffer, serKey.small);
+	_fatalShotBodyPart = (UnitBodyPart)unserializeInt(&buffer, serKey.small);
+	_movementType = (MovementType)unserializeInt(&buffer, serKey.small);
+	_murdererId = unserializeInt(&buffer, serKey.index);
+	_mindControllerID = unserializeInt(&buffer, serKey.index);
+
+	Uint32 boolFields = unserializeInt(&buffer, serKey.boolFields);
+	_wantsToSurrender = (boolFields & 0x00001) ? true : false;
+	_isSurrendering = (boolFields & 0x00002) ? true : false;
+	_kneeled = (boolFields & 0x00004) ? true : false;
+	_floating = (boolFields & 0x00008) ? true : false;
+	_visible = (boolFields & 0x00010) ? true : false;
+	_wasFriendlyFired = (boolFields & 0x00020) ? true : false;
+	_undercover = (boolFields & 0x00040) ? true : false;
+	_warned = (boolFields & 0x00080) ? true : false;
+	_alarmed = (boolFields & 0x00100) ? true : false;
+	_freshReinforcement = (boolFields & 0x00200) ? true : false;
+	_dontReselect = (boolFields & 0x00400) ? true : false;
+	_alreadyRespawned = (boolFields & 0x00800) ? true : false;
+	_summonedPlayerUnit = (boolFields & 0x01000) ? true : false;
+	_resummonedFakeCivilian = (boolFields & 0x02000) ? true : false;
+	_pickUpWeaponsMoreActively = (boolFields & 0x04000) ? true : false;
+	_disableIndicators = (boolFields & 0x08000) ? true : false;
+	_vip = (boolFields & 0x10000) ? true : false;
+	_bannedInNextStage = (boolFields & 0x20000) ? true : false;
+	_charging = 0;
+
+	loadNested(nested, mod, shared);
+}
+
+/**
+ * Saves the unit to binary. The id, type, armor and original faction
+ * that precede it in the buffer are written by the battle.
+ * @param buffer Pointer to buffer.
+ * @param nested YAML node to add the nested data to.
+ */
+void BattleUnit::saveBinary(Uint8 **buffer, YAML::Node &nested, const ScriptGlobal *shared) const
+{
+	serializeInt(buffer, serializationKey.small, _faction);
+	serializeInt(buffer, serializationKey.small, _status);
+	serializeInt(buffer, serializationKey.position, _pos.x);
+	serializeInt(buffer, serializationKey.position, _pos.y);
+	serializeInt(buffer, serializationKey.position, _pos.z);
+	serializeInt(buffer, serializationKey.small, _direction);
+	serializeInt(buffer, serializationKey.small, _directionTurret);
+	serializeInt(buffer, serializationKey.small, _turretType);
+	serializeInt(buffer, serializationKey.value, _tu);
+	serializeInt(buffer, serializationKey.value, _health);
+	serializeInt(buffer, serializationKey.value, _mana);
+	serializeInt(buffer, serializationKey.value, _stunlevel);
+	serializeInt(buffer, serializationKey.value, _energy);
+	serializeInt(buffer, serializationKey.value, _morale);
+	serializeInt(buffer, serializationKey.value, _motionPoints);
+	for (int i = 0; i < SIDE_MAX; i++)
+		serializeInt(buffer, serializationKey.small, _currentArmor[i]);
+	for (int i = 0; i < BODYPART_MAX; i++)
+		serializeInt(buffer, serializationKey.small, _fatalWounds[i]);
+	serializeInt(buffer, serializationKey.small, _fire);
+	serializeInt(buffer, serializationKey.small, _exp.bravery);
+	serializeInt(buffer, serializationKey.small, _exp.reactions);
+	serializeInt(buffer, serializationKey.small, _exp.firing);
+	serializeInt(buffer, serializationKey.small, _exp.throwing);
+	serializeInt(buffer, serializationKey.small, _exp.psiSkill);
+	serializeInt(buffer, serializationKey.small, _exp.psiStrength);
+	serializeInt(buffer, serializationKey.small, _exp.mana);
+	serializeInt(buffer, serializationKey.small, _exp.melee);
+	serializeInt(buffer, serializationKey.small, _turnsSinceSpotted);
+	serializeInt(buffer, serializationKey.small, _turnsLeftSpottedForSnipers);
+	serializeInt(buffer, serializationKey.small, _turnsSinceStunned);
+	serializeInt(buffer, serializationKey.small, _killedBy);
+	serializeInt(buffer, serializationKey.small, _moraleRestored);
+	serializeInt(buffer, serializationKey.small, _rankInt);
+	serializeInt(buffer, serializationKey.small, _kills);
+	serializeInt(buffer, serializationKey.small, _fatalShotSide);
+	serializeInt(buffer, serializationKey.small, _fatalShotBodyPart);
+	serializeInt(buffer, serializationKey.small, _movementType);
+	serializeInt(buffer, serializationKey.index, _murdererId);
+	serializeInt(buffer, serializationKey.index, _mindControllerID);
+
+	Uint32 boolFields = (_wantsToSurrender?0x00001:0) + (_isSurrendering?0x00002:0) + (_kneeled?0x00004:0) + (_floating?0x00008:0)
+		+ (_visible?0x00010:0) + (_wasFriendlyFired?0x00020:0) + (_undercover?0x00040:0) + (_warned?0x00080:0)
+		+ (_alarmed?0x00100:0) + (_freshReinforcement?0x00200:0) + ((_faction == FACTION_PLAYER && _dontReselect)?0x00400:0) + (_alreadyRespawned?0x00800:0)
+		+ (_summonedPlayerUnit?0x01000:0) + (_resummonedFakeCivilian?0x02000:0) + (_pickUpWeaponsMoreActively?0x04000:0) + (_disableIndicators?0x08000:0)
+		+ (_vip?0x10000:0) + (_bannedInNextStage?0x20000:0);
+	serializeInt(buffer, serializationKey.boolFields, boolFields);
+
+	saveNested(nested, shared);
 }
 
 /**
@@ -209,17 +209,35 @@ private:
 	bool canStackToSlot(BattleItem* item, RuleInventory* slot, int x, int y) const;
 
 	void loadRoles(const std::vector<int>& r);
+	/// Loads the parts of the unit kept in YAML by both formats.
+	void loadNested(const YAML::Node &node, const Mod *mod, const ScriptGlobal *shared);
+	/// Saves the parts of the unit kept in YAML by both formats.
+	void saveNested(YAML::Node &node, const ScriptGlobal *shared) const;
 public:
 	static const int MAX_SOLDIER_ID = 1000000;
 	static const int BUBBLES_FIRST_FRAME = 3;
 	static const int BUBBLES_LAST_FRAME = BUBBLES_FIRST_FRAME + 15;
 
+	static struct SerializationKey
+	{
+		// how many bytes to store for each variable or each member of array of the same name
+		Uint8 index; // unit id, murderer and mind controller ids
+		Uint8 type; // index in the unit type and armor tables
+		Uint8 position; // each coordinate of the unit
+		Uint8 small; // factions, status, directions, rank, kills, armor, wounds, experience, turn counters
+		Uint8 value; // tu, health, mana, stun, energy, morale, motion points
+		Uint8 boolFields;
+		Uint32 totalBytes; // per structure, including any data not mentioned here and accounting for all array members!
+	} serializationKey;
+
 	/// Name of class used in script.
 	static constexpr const char *ScriptName = "BattleUnit";
 	/// Register all useful function used by script.
 	static void ScriptRegister(ScriptParserBase* parser);
 	/// Init all required data in script using object data.
 	static void ScriptFill(ScriptWorkerBlit* w, const BattleUnit* item, const SavedBattleGame* save, int body_part, int anim_frame, int shade, int burn);
+	/// Get all script values.
+	const ScriptValues<BattleUnit> &getScriptValuesRaw() const { return _scriptValues; }
 
 	/// Creates a BattleUnit from solder.
 	BattleUnit(const Mod *mod, Soldier *soldier, int depth, const RuleStartingCondition* sc);
@@ -235,6 +253,10 @@ public:
 	void load(const YAML::Node &node, const Mod *mod, const ScriptGlobal *shared);
 	/// Saves the unit to YAML.
 	YAML::Node save(const ScriptGlobal *shared) const;
+	/// Loads the unit from binary.
+	void loadBinary(Uint8 *buffer, const SerializationKey &serKey, int sides, int bodyParts, const YAML::Node &nested, const Mod *mod, const ScriptGlobal *shared);
+	/// Saves the unit to binary.
+	void saveBinary(Uint8 **buffer, YAML::Node &nested, const ScriptGlobal *shared) const;
 	/// Gets the BattleUnit's ID.
 	int getId() const;
 	/// Calculates the distance squared between the unit and a given position.
@@ -19,6 +19,7 @@
 #include "DiplomacyFaction.h"
 #include <assert.h>
 #include <algorithm>
+#include <SDL.h>
 #include "../fmath.h"
 #include "../Engine/Game.h"
 #include "../Engine/RNG.h"
@@ -207,6 +208,19 @@ void DiplomacyFaction::removeItem(const RuleItem* item, int qty)
  * @param ThinkPeriod - timestep to determine think process
  */
 void DiplomacyFaction::think(Game& engine, ThinkPeriod period)
+{
+	beginThink(engine, period);
+	manage(*engine.getSavedGame(), *engine.getMod(), period);
+	endThink(engine, period);
+}
+
+/**
+ * Handles the Faction logic that comes before its own management:
+ * discovery, reputation and factional events.
+ * @param Game game engine.
+ * @param ThinkPeriod - timestep to determine think process
+ */
+void DiplomacyFaction::beginThink(Game& engine, ThinkPeriod period)
 {
 	SavedGame& save = *engine.getSavedGame();
 	MasterMind& mind = *engine.getMasterMind();
@@ -214,6 +228,7 @@ void DiplomacyFaction::think(Game& engine, ThinkPeriod period)
 	_availableMissionScripts.clear();
 	_eventsToProcess.clear();
 	_avoidRepeatVars.clear();
+	_eventsToSpawn.clear();
 
 	//let's process out daily duty
 	if (period == TIMESTEP_DAILY || period == TIMESTEP_10_DAYS)
@@ -244,9 +259,24 @@ void DiplomacyFaction::think(Game& engine, ThinkPeriod period)
 
 		//ok, what would happen today?
 		processFactionalEvents(engine);
+	}
+}
 
+/**
+ * Handles the Faction's own management: stores, power and research.
+ * Only touches the Faction itself and reads the rest of the game, so
+ * different Factions can be managed in parallel. Anything affecting
+ * the rest of the game is kept for endThink().
+ * @param save Saved game, read only.
+ * @param mod Game mod.
+ * @param ThinkPeriod - timestep to determine think process
+ */
+void DiplomacyFaction::manage(SavedGame& save, Mod& mod, ThinkPeriod period)
+{
+	if (period == TIMESTEP_DAILY || period == TIMESTEP_10_DAYS)
+	{
 		//it's management time!
-		handleSelling(*engine.getMod());
+		handleSelling(mod);
 		if (period == TIMESTEP_10_DAYS)
 		{
 			Log(LOG_INFO) << "Handling restock, Faction:  " << _rule->getName() << " has funds: " << _funds << " and power: " << _power << "."; //#CLEARLOGS
@@ -254,8 +284,29 @@ void DiplomacyFaction::think(Game& engine, ThinkPeriod period)
 		}
 		//manageStaff(); #FINNIKTODO uncomment with alpha 2
 		int64_t reqFunds = managePower(save.getMonthsPassed(), _mod->getDefaultFactionPowerCost());
-		handleResearch(engine, reqFunds);
+		handleResearch(save, reqFunds);
+	}
+}
+
+/**
+ * Handles the Faction logic that affects the rest of the game:
+ * events spawned by its management, treaties, missions and event scripts.
+ * @param Game game engine.
+ * @param ThinkPeriod - timestep to determine think process
+ */
+void DiplomacyFaction::endThink(Game& engine, ThinkPeriod period)
+{
+	SavedGame& save = *engine.getSavedGame();
+	MasterMind& mind = *engine.getMasterMind();
+
+	for (auto spawnedEvent : _eventsToSpawn)
+	{
+		save.spawnEvent(spawnedEvent);
+	}
+	_eventsToSpawn.clear();
 
+	if (period == TIMESTEP_DAILY || period == TIMESTEP_10_DAYS)
+	{
 		if (_discovered)
 		{
 			//process treaty logic
@@ -289,6 +340,83 @@ void DiplomacyFaction::think(Game& engine, ThinkPeriod period)
 	}
 }
 
+namespace
+{
+
+/**
+ * Management of a single Faction, run in its own thread.
+ */
+struct ManageTask
+{
+	DiplomacyFaction *faction;
+	SavedGame *save;
+	Mod *mod;
+	ThinkPeriod period;
+	RNG::RandomState random;
+	Uint32 ticks;
+};
+
+/**
+ * Manages a Faction with its own random sequence.
+ * @param data Pointer to the task.
+ * @return Always 0.
+ */
+int manageTask(void *data)
+{
+	ManageTask *task = (ManageTask*)data;
+	RNG::ScopedState random(task->random);
+	Uint32 start = SDL_GetTicks();
+	task->faction->manage(*task->save, *task->mod, task->period);
+	task->ticks = SDL_GetTicks() - start;
+	return 0;
+}
+
+}
+
+/**
+ * Handles the management of all Factions in parallel, each one
+ * in its own thread. The random sequence of each Faction is split
+ * off the game's in Faction order, so the outcome doesn't depend
+ * on how the threads get scheduled.
+ * @param factions Factions to manage.
+ * @param save Saved game, read only.
+ * @param mod Game mod.
+ * @param ThinkPeriod - timestep to determine think process
+ */
+void DiplomacyFaction::manageAll(const std::vector<DiplomacyFaction*>& factions, SavedGame& save, Mod& mod, ThinkPeriod period)
+{
+	std::vector<ManageTask> tasks;
+	tasks.reserve(factions.size());
+	for (auto faction : factions)
+	{
+		tasks.push_back({ faction, &save, &mod, period, RNG::globalRandomState().subSequence(), 0 });
+	}
+
+	std::vector<SDL_Thread*> threads;
+	for (auto& task : tasks)
+	{
+		SDL_Thread *thread = SDL_CreateThread(manageTask, (void*)&task);
+		if (thread == 0)
+		{
+			// no thread, do it right here
+			manageTask(&task);
+		}
+		threads.push_back(thread);
+	}
+	for (auto thread : threads)
+	{
+		if (thread != 0)
+		{
+			SDL_WaitThread(thread, 0);
+		}
+	}
+
+	for (auto& task : tasks)
+	{
+		Log(LOG_DEBUG) << "Faction: " << task.faction->getRules()->getName() << " managed in " << task.ticks << " ms";
+	}
+}
+
 /**
  * Handle daily reputation change and immidiate reaction to it.
  * @param Game game engine.
@@ -783,9 +911,8 @@ int64_t DiplomacyFaction::managePower(int64_t month, int64_t baseCost) //#FINNIK
  * Handle managing of Faction's staff and non-item equipment.
  * @param mod rulesets to get constant data.
  */
-void DiplomacyFaction::handleResearch(Game& engine, int64_t reqFunds) //#FINNIKTODO - rafactor with new soldier-based scientists logic
+void DiplomacyFaction::handleResearch(SavedGame& save, int64_t reqFunds) //#FINNIKTODO - rafactor with new soldier-based scientists logic
 {
-	SavedGame& save = *engine.getSavedGame();
 
 	bool hasResearch = !_research.empty();
 
@@ -814,7 +941,7 @@ void DiplomacyFaction::handleResearch(Game& engine, int64_t reqFunds) //#FINNIKT
 				auto researchEvent = research->getSpawnedEvent();
 				if (!researchEvent.empty())
 				{
-					save.spawnEvent(engine.getMod()->getEvent(researchEvent));
+					_eventsToSpawn.push_back(_mod->getEvent(researchEvent));
 				}
 
 				// process getOneFree
@@ -70,6 +70,7 @@ private:
 	ItemContainer* _items, *_secretItems;
 	FactionalContainer* _staff;
 	std::vector<FactionalResearch*> _research;
+	std::vector<const RuleEvent*> _eventsToSpawn;
 
 	/// Handle daily reputation change and immidiate reaction to it.
 	void processDailyReputation(Game& engine);
@@ -86,7 +87,7 @@ private:
 	/// Process Faction's power management and returns required funds for further use.
 	int64_t managePower(int64_t month, int64_t baseCost);
 	/// Handle researching.
-	void handleResearch(Game& engine, int64_t reqFunds);
+	void handleResearch(SavedGame& save, int64_t reqFunds);
 	/// Get if research article is unlocked by faction.
 	bool isResearched(const std::string& name) const;
 	bool isResearched(const RuleResearch* rule) const;
@@ -156,6 +157,14 @@ public:
 
 	/// The main handler of Faction logic.
 	void think(Game& engine, ThinkPeriod = TIMESTEP_DAILY);
+	/// Handles the Faction logic that comes before its own management.
+	void beginThink(Game& engine, ThinkPeriod = TIMESTEP_DAILY);
+	/// Handles the Faction's own management, which can run in parallel with other Factions.
+	void manage(SavedGame& save, Mod& mod, ThinkPeriod = TIMESTEP_DAILY);
+	/// Handles the Faction logic that affects the rest of the game.
+	void endThink(Game& engine, ThinkPeriod = TIMESTEP_DAILY);
+	/// Handles the management of all Factions in parallel.
+	static void manageAll(const std::vector<DiplomacyFaction*>& factions, SavedGame& save, Mod& mod, ThinkPeriod = TIMESTEP_DAILY);
 };
 
 }
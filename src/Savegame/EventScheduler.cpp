@@ -0,0 +1,120 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "EventScheduler.h"
+#include "Base.h"
+#include "../Engine/Logger.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Initializes an empty scheduler.
+ */
+EventScheduler::EventScheduler() : _clock(0), _nextId(1)
+{
+}
+
+/**
+ *
+ */
+EventScheduler::~EventScheduler()
+{
+}
+
+/**
+ * Drops all pending events and starts the clock over.
+ */
+void EventScheduler::clear()
+{
+	_clock = 0;
+	_nextId = 1;
+	_queue = std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, std::greater<ScheduledEvent> >();
+}
+
+/**
+ * Advances the clock by an hour.
+ */
+void EventScheduler::advance()
+{
+	_clock++;
+}
+
+/**
+ * Schedules an event. Ids are never reused, so whoever handles
+ * the event can find its object by id and tell when it's gone.
+ * @param due Clock hour the event is due.
+ * @param type Type of event.
+ * @return Id of the event.
+ */
+int EventScheduler::schedule(int due, ScheduledEventType type)
+{
+	ScheduledEvent event = { due, type, _nextId++ };
+	_queue.push(event);
+	return event.id;
+}
+
+/**
+ * Takes out all the events that are due by the current clock hour.
+ * @return Events due, in order of completion time.
+ */
+std::vector<ScheduledEvent> EventScheduler::popDue()
+{
+	std::vector<ScheduledEvent> due;
+	while (!_queue.empty() && _queue.top().due <= _clock)
+	{
+		due.push_back(_queue.top());
+		_queue.pop();
+	}
+	return due;
+}
+
+/**
+ * Logs the pending events, in order of completion time.
+ * Events whose object no longer exists are listed as well.
+ * @param bases Bases still in the game.
+ */
+void EventScheduler::dump(const std::vector<Base*> &bases) const
+{
+	std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, std::greater<ScheduledEvent> > queue = _queue;
+	Log(LOG_INFO) << "Geoscape events pending at hour " << _clock << ": " << queue.size();
+	while (!queue.empty())
+	{
+		const ScheduledEvent &event = queue.top();
+		std::string type = "unknown";
+		switch (event.type)
+		{
+		case SCHEDULED_TRANSFER:
+			type = "transfer";
+			break;
+		}
+		std::string target = "nothing (removed)";
+		for (const Base *base : bases)
+		{
+			if (event.type == SCHEDULED_TRANSFER && base->findTransfer(event.id))
+			{
+				target = base->getName();
+				break;
+			}
+		}
+		Log(LOG_INFO) << "  in " << event.due - _clock << "h: " << type << " " << event.id << " to " << target;
+		queue.pop();
+	}
+}
+
+}
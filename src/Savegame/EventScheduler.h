@@ -0,0 +1,78 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace OpenXcom
+{
+
+class Base;
+
+enum ScheduledEventType { SCHEDULED_TRANSFER };
+
+/**
+ * A geoscape event due at a given hour. Events only carry an id,
+ * which the object they belong to keeps, so an event whose object
+ * is gone simply finds nothing when it comes due.
+ */
+struct ScheduledEvent
+{
+	int due;
+	ScheduledEventType type;
+	int id;
+	bool operator>(const ScheduledEvent &other) const { return due > other.due || (due == other.due && id > other.id); }
+};
+
+/**
+ * Keeps the geoscape events in order of completion time, so
+ * the hourly timers only handle the events that are due
+ * instead of counting down every pending entity.
+ * The clock counts geoscape hours and is saved with the game.
+ */
+class EventScheduler
+{
+private:
+	int _clock, _nextId;
+	std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, std::greater<ScheduledEvent> > _queue;
+public:
+	/// Creates an empty scheduler.
+	EventScheduler();
+	/// Cleans up the scheduler.
+	~EventScheduler();
+	/// Drops all events and resets the clock.
+	void clear();
+	/// Gets the scheduler clock.
+	int getClock() const { return _clock; }
+	/// Sets the scheduler clock.
+	void setClock(int clock) { _clock = clock; }
+	/// Advances the clock by an hour.
+	void advance();
+	/// Schedules an event.
+	int schedule(int due, ScheduledEventType type);
+	/// Takes out all the events that are due.
+	std::vector<ScheduledEvent> popDue();
+	/// Gets the number of pending events.
+	size_t size() const { return _queue.size(); }
+	/// Logs the pending events.
+	void dump(const std::vector<Base*> &bases) const;
+};
+
+}
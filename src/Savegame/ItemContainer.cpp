@@ -19,6 +19,8 @@
 #include "ItemContainer.h"
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
 
 namespace OpenXcom
 {
@@ -26,7 +28,7 @@ namespace OpenXcom
 /**
  * Initializes an item container with no contents.
  */
-ItemContainer::ItemContainer()
+ItemContainer::ItemContainer() : _totalSize(0.0), _totalSizeMod(0)
 {
 }
 
@@ -44,6 +46,7 @@ ItemContainer::~ItemContainer()
 void ItemContainer::load(const YAML::Node &node)
 {
 	_qty = node.as< std::map<std::string, int> >(_qty);
+	_totalSizeMod = 0;
 }
 
 /**
@@ -69,6 +72,7 @@ void ItemContainer::addItem(const std::string &id, int qty)
 		return;
 	}
 	_qty[id] += qty;
+	_totalSizeMod = 0;
 }
 
 /**
@@ -109,6 +113,7 @@ void ItemContainer::removeItem(const std::string &id, int qty)
 	{
 		_qty.erase(it);
 	}
+	_totalSizeMod = 0;
 }
 
 /**
@@ -180,16 +185,28 @@ int ItemContainer::getTotalQuantity() const
 
 /**
  * Returns the total size of the items in the container.
+ * It's kept until the contents change, as the base stores
+ * are checked over and over while buying and transferring.
  * @param mod Pointer to mod.
  * @return Total item size.
  */
 double ItemContainer::getTotalSize(const Mod *mod) const
 {
+	if (_totalSizeMod == mod && !Options::checkBaseCapacities)
+	{
+		return _totalSize;
+	}
 	double total = 0;
 	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
 	{
 		total += mod->getItem(i->first, true)->getSize() * i->second;
 	}
+	if (_totalSizeMod == mod && total != _totalSize)
+	{
+		Log(LOG_ERROR) << "Item container size was not invalidated.";
+	}
+	_totalSize = total;
+	_totalSizeMod = mod;
 	return total;
 }
 
@@ -199,6 +216,8 @@ double ItemContainer::getTotalSize(const Mod *mod) const
  */
 std::map<std::string, int> *ItemContainer::getContents()
 {
+	// the caller may change the quantities
+	_totalSizeMod = 0;
 	return &_qty;
 }
 
@@ -36,6 +36,8 @@ class ItemContainer
 {
 private:
 	std::map<std::string, int> _qty;
+	mutable double _totalSize;
+	mutable const Mod *_totalSizeMod;
 public:
 	/// Creates an empty item container.
 	ItemContainer();
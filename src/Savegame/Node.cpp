@@ -17,10 +17,20 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Node.h"
+#include "SerializationHelper.h"
 
 namespace OpenXcom
 {
 
+/// How many bytes various fields use in a serialized node. See header.
+Node::SerializationKey Node::serializationKey =
+{2, // index: id, links
+ 2, // position, three of these
+ 2, // small: type, rank, flags, reserved, priority
+ 1, // number of links
+ 1, // one 8-bit bool field
+ 2 + 2*3 + 2*5 + 1 + 1 // total bytes to save one node, without its links
+};
 
 Node::Node() : _id(0), _segment(0), _type(0), _rank(0), _flags(0), _reserved(0), _priority(0), _allocated(false), _dummy(false)
 {
@@ -109,6 +119,72 @@ YAML::Node Node::save() const
 	return node;
 }
 
+/**
+ * Loads the node from binary.
+ * @param buffer Pointer to buffer, moved past the node and its links.
+ * @param serKey Serialization key.
+ */
+void Node::loadBinary(Uint8 **buffer, const Node::SerializationKey &serKey)
+{
+	Uint8 *start = *buffer;
+	_id = unserializeInt(buffer, serKey.index);
+	_pos.x = unserializeInt(buffer, serKey.position);
+	_pos.y = unserializeInt(buffer, serKey.position);
+	_pos.z = unserializeInt(buffer, serKey.position);
+	_type = unserializeInt(buffer, serKey.small);
+	_rank = unserializeInt(buffer, serKey.small);
+	_flags = unserializeInt(buffer, serKey.small);
+	_reserved = unserializeInt(buffer, serKey.small);
+	_priority = unserializeInt(buffer, serKey.small);
+
+	Uint8 boolFields = unserializeInt(buffer, serKey.boolFields);
+	_allocated = (boolFields & 1) ? true : false;
+	_dummy = (boolFields & 2) ? true : false;
+
+	int links = unserializeInt(buffer, serKey.links);
+	*buffer = start + serKey.totalBytes;
+	_nodeLinks.clear();
+	for (int i = 0; i < links; ++i)
+	{
+		_nodeLinks.push_back(unserializeInt(buffer, serKey.index));
+	}
+}
+
+/**
+ * Saves the node to binary.
+ * @param buffer Pointer to buffer, moved past the node and its links.
+ */
+void Node::saveBinary(Uint8 **buffer) const
+{
+	serializeInt(buffer, serializationKey.index, _id);
+	serializeInt(buffer, serializationKey.position, _pos.x);
+	serializeInt(buffer, serializationKey.position, _pos.y);
+	serializeInt(buffer, serializationKey.position, _pos.z);
+	serializeInt(buffer, serializationKey.small, _type);
+	serializeInt(buffer, serializationKey.small, _rank);
+	serializeInt(buffer, serializationKey.small, _flags);
+	serializeInt(buffer, serializationKey.small, _reserved);
+	serializeInt(buffer, serializationKey.small, _priority);
+
+	Uint8 boolFields = (_allocated?1:0) + (_dummy?2:0);
+	serializeInt(buffer, serializationKey.boolFields, boolFields);
+
+	serializeInt(buffer, serializationKey.links, (int)_nodeLinks.size());
+	for (std::vector<int>::const_iterator i = _nodeLinks.begin(); i != _nodeLinks.end(); ++i)
+	{
+		serializeInt(buffer, serializationKey.index, *i);
+	}
+}
+
+/**
+ * Gets how many bytes the node takes in binary, links included.
+ * @return Size in bytes.
+ */
+Uint32 Node::getBinarySize() const
+{
+	return serializationKey.totalBytes + serializationKey.index * _nodeLinks.size();
+}
+
 /**
  * Get the node's id
  * @return unique id
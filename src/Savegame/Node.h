@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "../Battlescape/Position.h"
+#include <SDL_types.h>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -50,6 +51,15 @@ public:
 	static const int TYPE_SMALL = 0x02; // large unit can not spawn here when this bit is set
 	static const int TYPE_DANGEROUS = 0x04; // an alien was shot here, stop patrolling to it like an idiot with a death wish
 	static const int nodeRank[8][7]; // maps alien ranks to node (.RMP) ranks
+	static struct SerializationKey
+	{
+		Uint8 index; // node id and each of its links
+		Uint8 position; // each coordinate of the node
+		Uint8 small; // type, rank, flags, reserved, priority
+		Uint8 links; // number of links
+		Uint8 boolFields;
+		Uint32 totalBytes; // per structure, not counting the links that follow it!
+	} serializationKey;
 	/// Creates a Node.
 	Node();
 	Node(int id, Position pos, int segment, int type, int rank, int flags, int reserved, int priority);
@@ -59,6 +69,12 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the node to YAML.
 	YAML::Node save() const;
+	/// Loads the node from binary.
+	void loadBinary(Uint8 **buffer, const SerializationKey &serKey);
+	/// Saves the node to binary.
+	void saveBinary(Uint8 **buffer) const;
+	/// Gets how many bytes the node takes in binary.
+	Uint32 getBinarySize() const;
 	/// get the node's id
 	int getID() const;
 	/// get the node's paths
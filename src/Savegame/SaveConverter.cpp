@@ -740,6 +740,7 @@ void SaveConverter::loadDatBase()
 					facility->setY(y);
 					facility->setBuildTime(days);
 					base->getFacilities()->push_back(facility);
+					base->invalidateCapacities();
 				}
 			}
 			int engineers = load<Uint8>(bdata + _rules->getOffset("BASE.DAT_ENGINEERS"));
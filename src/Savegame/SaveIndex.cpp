@@ -0,0 +1,279 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SaveIndex.h"
+#include <set>
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+
+namespace OpenXcom
+{
+
+const std::string SaveIndex::FILENAME = "saves.idx";
+const int SaveIndex::VERSION = 1;
+std::string SaveIndex::_folder;
+std::map<std::string, SaveIndex::Entry> SaveIndex::_entries;
+bool SaveIndex::_dirty = false;
+SDL_Thread *SaveIndex::_thread = 0;
+
+/**
+ * Loads the index file of a user folder. Does nothing if
+ * that folder's index is the one already in memory.
+ * A missing, outdated or broken index is simply rebuilt.
+ * @param folder Full path to the user folder.
+ */
+void SaveIndex::load(const std::string &folder)
+{
+	if (_folder == folder)
+	{
+		return;
+	}
+	_folder = folder;
+	_entries.clear();
+	_dirty = false;
+
+	std::string filename = _folder + FILENAME;
+	if (!CrossPlatform::fileExists(filename))
+	{
+		return;
+	}
+	try
+	{
+		YAML::Node doc = YAML::Load(*CrossPlatform::readFile(filename));
+		if (doc["version"].as<int>(0) != VERSION)
+		{
+			return;
+		}
+		for (YAML::const_iterator i = doc["saves"].begin(); i != doc["saves"].end(); ++i)
+		{
+			Entry entry;
+			entry.size = (*i)["size"].as<uint64_t>();
+			entry.mtime = (time_t)(*i)["mtime"].as<int64_t>();
+			entry.header = (*i)["header"];
+			_entries[(*i)["file"].as<std::string>()] = entry;
+		}
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_WARNING) << filename << ": " << e.what();
+		_entries.clear();
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_WARNING) << filename << ": " << e.what();
+		_entries.clear();
+	}
+}
+
+/**
+ * Writes the index back to its user folder, if
+ * anything changed since it was loaded.
+ */
+void SaveIndex::save()
+{
+	if (!_dirty)
+	{
+		return;
+	}
+	YAML::Emitter out;
+	YAML::Node doc;
+	doc["version"] = VERSION;
+	for (std::map<std::string, Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		YAML::Node node;
+		node["file"] = i->first;
+		node["size"] = i->second.size;
+		node["mtime"] = (int64_t)i->second.mtime;
+		node["header"] = i->second.header;
+		doc["saves"].push_back(node);
+	}
+	out << doc;
+
+	std::string filename = _folder + FILENAME;
+	if (!CrossPlatform::writeFile(filename, out.c_str()))
+	{
+		Log(LOG_WARNING) << "Failed to save " << filename;
+	}
+	_dirty = false;
+}
+
+/**
+ * Lists the regular saves, autosaves and quicksaves of a user folder.
+ * @param folder Full path to the user folder.
+ * @return List of (filename, is_dir, mtime) tuples.
+ */
+std::vector<std::tuple<std::string, bool, time_t>> SaveIndex::list(const std::string &folder)
+{
+	auto saves = CrossPlatform::getFolderContents(folder, "sav");
+	auto asaves = CrossPlatform::getFolderContents(folder, "asav");
+	saves.insert(saves.begin(), asaves.begin(), asaves.end());
+	return saves;
+}
+
+/**
+ * Compares the index against the save files in a user folder,
+ * parsing the headers of new or modified saves and dropping
+ * the ones that no longer exist.
+ * @param folder Full path to the user folder.
+ * @return List of save files found, as (filename, is_dir, mtime) tuples.
+ */
+std::vector<std::tuple<std::string, bool, time_t>> SaveIndex::refresh(const std::string &folder)
+{
+	load(folder);
+	auto saves = list(folder);
+	std::set<std::string> found;
+	for (auto i = saves.begin(); i != saves.end(); ++i)
+	{
+		const std::string &filename = std::get<0>(*i);
+		time_t mtime = std::get<2>(*i);
+		std::string fullname = folder + filename;
+		uint64_t size = CrossPlatform::getFileSize(fullname);
+		found.insert(filename);
+
+		std::map<std::string, Entry>::iterator entry = _entries.find(filename);
+		if (entry != _entries.end() && entry->second.size == size && entry->second.mtime == mtime)
+		{
+			continue;
+		}
+		_dirty = true;
+		try
+		{
+			Entry parsed;
+			parsed.size = size;
+			parsed.mtime = mtime;
+			parsed.header = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
+			_entries[filename] = parsed;
+		}
+		catch (Exception &e)
+		{
+			Log(LOG_ERROR) << filename << ": " << e.what();
+			_entries.erase(filename);
+		}
+		catch (YAML::Exception &e)
+		{
+			Log(LOG_ERROR) << filename << ": " << e.what();
+			_entries.erase(filename);
+		}
+	}
+	for (std::map<std::string, Entry>::iterator i = _entries.begin(); i != _entries.end();)
+	{
+		if (found.find(i->first) == found.end())
+		{
+			i = _entries.erase(i);
+			_dirty = true;
+		}
+		else
+		{
+			++i;
+		}
+	}
+	save();
+	return saves;
+}
+
+/**
+ * Refreshes the index of the given user folder.
+ * @param folder Pointer to a heap-allocated folder path, freed here.
+ * @return Always 0.
+ */
+int SaveIndex::refreshThread(void *folder)
+{
+	std::string *path = (std::string*)folder;
+	try
+	{
+		refresh(*path);
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_WARNING) << "Failed to refresh saves index: " << e.what();
+	}
+	delete path;
+	return 0;
+}
+
+/**
+ * Starts refreshing the index of the current user folder in
+ * a separate thread, so by the time the player opens a saves
+ * list the new and modified saves have already been parsed.
+ */
+void SaveIndex::refreshInBackground()
+{
+	wait();
+	std::string *folder = new std::string(Options::getMasterUserFolder());
+	_thread = SDL_CreateThread(refreshThread, (void*)folder);
+	if (_thread == 0)
+	{
+		// no thread, no problem, the lists will refresh it on demand
+		delete folder;
+	}
+}
+
+/**
+ * Waits for any background refresh to finish. Must be
+ * called before the index is accessed from the main thread.
+ */
+void SaveIndex::wait()
+{
+	if (_thread != 0)
+	{
+		SDL_WaitThread(_thread, 0);
+		_thread = 0;
+	}
+}
+
+/**
+ * Gets the header of a save file found by the last refresh.
+ * @param file Save filename.
+ * @param header Returns the header document.
+ * @return False if the save couldn't be read.
+ */
+bool SaveIndex::getHeader(const std::string &file, YAML::Node &header)
+{
+	std::map<std::string, Entry>::const_iterator i = _entries.find(file);
+	if (i == _entries.end())
+	{
+		return false;
+	}
+	header = i->second.header;
+	return true;
+}
+
+/**
+ * Stores the header of a save file that was just written,
+ * so it doesn't need to be parsed back next time.
+ * @param folder Full path to the user folder.
+ * @param file Save filename.
+ * @param header Header document written to the save.
+ */
+void SaveIndex::update(const std::string &folder, const std::string &file, const YAML::Node &header)
+{
+	wait();
+	load(folder);
+	std::string fullname = folder + file;
+	Entry entry;
+	entry.size = CrossPlatform::getFileSize(fullname);
+	entry.mtime = CrossPlatform::getDateModified(fullname);
+	entry.header = YAML::Clone(header);
+	_entries[file] = entry;
+	_dirty = true;
+	save();
+}
+
+}
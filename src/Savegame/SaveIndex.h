@@ -0,0 +1,74 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <time.h>
+#include <stdint.h>
+#include <yaml-cpp/yaml.h>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Persistent index of the savegame headers in the user folder,
+ * keyed by filename, size and modification time, so the saves
+ * lists only have to open the files that changed since last time.
+ */
+class SaveIndex
+{
+private:
+	struct Entry
+	{
+		uint64_t size;
+		time_t mtime;
+		YAML::Node header;
+	};
+	static const std::string FILENAME;
+	static const int VERSION;
+	static std::string _folder;
+	static std::map<std::string, Entry> _entries;
+	static bool _dirty;
+	static SDL_Thread *_thread;
+
+	/// Loads the index of a user folder, unless it's already loaded.
+	static void load(const std::string &folder);
+	/// Writes the index back to the user folder if it changed.
+	static void save();
+	/// Lists the save files in a user folder.
+	static std::vector<std::tuple<std::string, bool, time_t>> list(const std::string &folder);
+	/// Entry point of the background refresh.
+	static int refreshThread(void *folder);
+public:
+	/// Brings the index up to date with the save files on disk.
+	static std::vector<std::tuple<std::string, bool, time_t>> refresh(const std::string &folder);
+	/// Starts bringing the index up to date in a separate thread.
+	static void refreshInBackground();
+	/// Waits for a background refresh to finish.
+	static void wait();
+	/// Gets the header of an indexed save file.
+	static bool getHeader(const std::string &file, YAML::Node &header);
+	/// Stores the header of a save file that was just written.
+	static void update(const std::string &folder, const std::string &file, const YAML::Node &header);
+};
+
+}
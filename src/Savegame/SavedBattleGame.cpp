@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
+#include <algorithm>
+#include <functional>
 #include <vector>
 #include "BattleItem.h"
 #include "BattleObject.h"
@@ -97,7 +99,7 @@ SavedBattleGame::~SavedBattleGame()
 {
 	for (std::vector<MapDataSet*>::iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
 	{
-		(*i)->unloadData();
+		_rule->releaseMapDataSet(*i);
 	}
 
 	for (std::vector<Node*>::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
@@ -145,6 +147,7 @@ SavedBattleGame::~SavedBattleGame()
  */
 void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGame)
 {
+	Uint32 startTime = SDL_GetTicks();
 	int mapsize_x = node["width"].as<int>(_mapsize_x);
 	int mapsize_y = node["length"].as<int>(_mapsize_y);
 	int mapsize_z = node["height"].as<int>(_mapsize_z);
@@ -250,13 +253,61 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 			calculateModuleMap();
 		}
 	}
-	for (YAML::const_iterator i = node["nodes"].begin(); i != node["nodes"].end(); ++i)
+	if (!node["nodeTotalBytesPer"])
 	{
-		Node *n = new Node();
-		n->load(*i);
-		_nodes.push_back(n);
+		for (YAML::const_iterator i = node["nodes"].begin(); i != node["nodes"].end(); ++i)
+		{
+			Node *n = new Node();
+			n->load(*i);
+			_nodes.push_back(n);
+		}
+	}
+	else
+	{
+		// load key to how the node data was saved
+		Node::SerializationKey serKey;
+		memset(&serKey, 0, sizeof(Node::SerializationKey));
+		serKey.index = node["nodeIndexSize"].as<char>(serKey.index);
+		serKey.totalBytes = node["nodeTotalBytesPer"].as<Uint32>(serKey.totalBytes);
+		serKey.position = node["nodePositionSize"].as<char>(serKey.position);
+		serKey.small = node["nodeSmallSize"].as<char>(serKey.small);
+		serKey.links = node["nodeLinksSize"].as<char>(serKey.links);
+		serKey.boolFields = node["nodeBoolFieldsSize"].as<char>(serKey.boolFields);
+
+		YAML::Binary binNodes = node["binNodes"].as<YAML::Binary>();
+		Uint8 *r = (Uint8*)binNodes.data();
+		Uint8 *dataEnd = r + binNodes.size();
+
+		while (r < dataEnd)
+		{
+			Node *n = new Node();
+			n->loadBinary(&r, serKey); // advances r past the node's links
+			_nodes.push_back(n);
+		}
 	}
 
+	// match up units with the selection and their AI
+	auto addUnit = [&](BattleUnit *unit, const YAML::Node &ai)
+	{
+		// Handling of special built-in weapons will be done during and after the load of items
+		// unit->setSpecialWeapon(this, true);
+		_units.push_back(unit);
+		if (unit->getFaction() == FACTION_PLAYER)
+		{
+			if ((unit->getId() == selectedUnit) || (_selectedUnit == 0 && !unit->isOut()))
+				_selectedUnit = unit;
+		}
+		if (unit->getStatus() != STATUS_DEAD && !unit->isIgnored())
+		{
+			if (ai && unit->getFaction() != FACTION_PLAYER)
+			{
+				AIModule *aiModule = new AIModule(this, unit, 0);
+				aiModule->load(ai);
+				unit->setAIModule(aiModule);
+			}
+		}
+	};
+
 	for (YAML::const_iterator i = node["units"].begin(); i != node["units"].end(); ++i)
 	{
 		UnitFaction faction = (UnitFaction)(*i)["faction"].as<int>();
@@ -277,30 +328,54 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 			unit = new BattleUnit(mod, mod->getUnit(type), originalFaction, id, nullptr, mod->getArmor(armor), mod->getStatAdjustment(savedGame->getDifficulty()), _depth, nullptr);
 		}
 		unit->load(*i, this->getMod(), this->getMod()->getScriptGlobal());
-		// Handling of special built-in weapons will be done during and after the load of items
-		// unit->setSpecialWeapon(this, true);
-		_units.push_back(unit);
-		if (faction == FACTION_PLAYER)
-		{
-			if ((unit->getId() == selectedUnit) || (_selectedUnit == 0 && !unit->isOut()))
-				_selectedUnit = unit;
-		}
-		if (unit->getStatus() != STATUS_DEAD && !unit->isIgnored())
-		{
-			if (const YAML::Node &ai = (*i)["AI"])
+		addUnit(unit, (*i)["AI"]);
+	}
+
+	if (node["unitTotalBytesPer"])
+	{
+		// load key to how the unit data was saved
+		BattleUnit::SerializationKey serKey;
+		memset(&serKey, 0, sizeof(BattleUnit::SerializationKey));
+		serKey.index = node["unitIndexSize"].as<char>(serKey.index);
+		serKey.totalBytes = node["unitTotalBytesPer"].as<Uint32>(serKey.totalBytes);
+		serKey.type = node["unitTypeSize"].as<char>(serKey.type);
+		serKey.position = node["unitPositionSize"].as<char>(serKey.position);
+		serKey.small = node["unitSmallSize"].as<char>(serKey.small);
+		serKey.value = node["unitValueSize"].as<char>(serKey.value);
+		serKey.boolFields = node["unitBoolFieldsSize"].as<char>(serKey.boolFields);
+		int sides = node["unitArmorSides"].as<int>(SIDE_MAX);
+		int bodyParts = node["unitBodyParts"].as<int>(BODYPART_MAX);
+		std::vector<std::string> types = node["binUnitTypes"].as<std::vector<std::string> >(std::vector<std::string>());
+		std::vector<std::string> armors = node["binUnitArmors"].as<std::vector<std::string> >(std::vector<std::string>());
+		const YAML::Node &nested = node["binUnitNested"];
+
+		YAML::Binary binUnits = node["binUnits"].as<YAML::Binary>();
+		Uint8 *r = (Uint8*)binUnits.data();
+		Uint8 *dataEnd = r + binUnits.size();
+
+		for (size_t n = 0; r < dataEnd; ++n, r += serKey.totalBytes)
+		{
+			Uint8 *data = r;
+			int id = unserializeInt(&data, serKey.index);
+			int type = unserializeInt(&data, serKey.type);
+			int armor = unserializeInt(&data, serKey.type);
+			UnitFaction originalFaction = (UnitFaction)unserializeInt(&data, serKey.small);
+			BattleUnit *unit;
+			if (id < BattleUnit::MAX_SOLDIER_ID) // Unit is linked to a geoscape soldier
 			{
-				AIModule *aiModule;
-				if (faction != FACTION_PLAYER)
-				{
-					aiModule = new AIModule(this, unit, 0);
-				}
-				else
-				{
-					continue;
-				}
-				aiModule->load(ai);
-				unit->setAIModule(aiModule);
+				// look up the matching soldier
+				unit = new BattleUnit(mod, savedGame->getSoldier(id), _depth, nullptr);
+			}
+			else
+			{
+				Unit *unitRule = (type >= 0 && type < (int)types.size()) ? mod->getUnit(types[type]) : nullptr;
+				Armor *armorRule = (armor >= 0 && armor < (int)armors.size()) ? mod->getArmor(armors[armor]) : nullptr;
+				// create a new Unit.
+				if (!unitRule || !armorRule) continue;
+				unit = new BattleUnit(mod, unitRule, originalFaction, id, nullptr, armorRule, mod->getStatAdjustment(savedGame->getDifficulty()), _depth, nullptr);
 			}
+			unit->loadBinary(data, serKey, sides, bodyParts, nested[n], this->getMod(), this->getMod()->getScriptGlobal());
+			addUnit(unit, nested[n]["AI"]);
 		}
 	}
 
@@ -322,21 +397,107 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 
 	using ItemVec = std::vector<BattleItem*>&;
 
-	// node to load from, vector to load into, offset for matching ammo
-	std::tuple<YAML::Node, ItemVec, size_t> toContainer[] =
+	// YAML node to load from, binary node to load from, vector to load into
+	std::tuple<YAML::Node, YAML::Node, ItemVec> toContainer[] =
 	{
-		std::make_tuple(node["items"], std::ref(_items), 0u),
-		std::make_tuple(node["recoverConditional"], std::ref(_recoverConditional), 0u),
-		std::make_tuple(node["recoverGuaranteed"], std::ref(_recoverGuaranteed), 0u),
-		std::make_tuple(node["itemsSpecial"], std::ref(_items), 0u),
+		std::make_tuple(node["items"], node["binItems"], std::ref(_items)),
+		std::make_tuple(node["recoverConditional"], node["binRecoverConditional"], std::ref(_recoverConditional)),
+		std::make_tuple(node["recoverGuaranteed"], node["binRecoverGuaranteed"], std::ref(_recoverGuaranteed)),
+		std::make_tuple(node["itemsSpecial"], node["binItemsSpecial"], std::ref(_items)),
 	};
 
+	// ammo ids of each loaded weapon, matched once all items exist
+	struct AmmoLink
+	{
+		BattleItem *weapon;
+		std::vector<BattleItem*> *container;
+		int ammo[RuleItem::AmmoSlotMax];
+	};
+	std::vector<AmmoLink> ammoLinks;
+
+	// match up items with units and tiles
+	auto linkItem = [&](BattleItem *item, int owner, int prevOwner, int unit, Position pos)
+	{
+		for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end() && owner != -1; ++bu)
+		{
+			if ((*bu)->getId() == owner)
+			{
+				item->setOwner(*bu);
+				if (item->isSpecialWeapon())
+				{
+					(*bu)->addLoadedSpecialWeapon(item);
+				}
+				else
+				{
+					(*bu)->getInventory()->push_back(item);
+				}
+				break;
+			}
+		}
+		for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end() && prevOwner != -1; ++bu)
+		{
+			if ((*bu)->getId() == prevOwner)
+			{
+				item->setPreviousOwner(*bu);
+				break;
+			}
+		}
+		for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end() && unit != -1; ++bu)
+		{
+			if ((*bu)->getId() == unit)
+			{
+				item->setUnit(*bu);
+				break;
+			}
+		}
+
+		if (item->getSlot() && item->getSlot()->getType() == INV_GROUND)
+		{
+			if (pos.x != -1)
+				getTile(pos)->addItem(item, item->getSlot());
+		}
+	};
+
+	// load key and string tables of the binary items, if any
+	BattleItem::SerializationKey itemKey;
+	memset(&itemKey, 0, sizeof(BattleItem::SerializationKey));
+	int itemAmmoSlots = 0;
+	std::vector<const RuleItem*> itemTypes;
+	std::vector<RuleInventory*> itemSlots;
+	if (node["itemTotalBytesPer"])
+	{
+		itemKey.index = node["itemIndexSize"].as<char>(itemKey.index);
+		itemKey.totalBytes = node["itemTotalBytesPer"].as<Uint32>(itemKey.totalBytes);
+		itemKey.type = node["itemTypeSize"].as<char>(itemKey.type);
+		itemKey.slot = node["itemSlotSize"].as<char>(itemKey.slot);
+		itemKey.position = node["itemPositionSize"].as<char>(itemKey.position);
+		itemKey.small = node["itemSmallSize"].as<char>(itemKey.small);
+		itemKey.quantity = node["itemQuantitySize"].as<char>(itemKey.quantity);
+		itemKey.boolFields = node["itemBoolFieldsSize"].as<char>(itemKey.boolFields);
+		itemAmmoSlots = node["itemAmmoSlots"].as<int>(itemAmmoSlots);
+
+		for (YAML::const_iterator i = node["binItemTypes"].begin(); i != node["binItemTypes"].end(); ++i)
+		{
+			std::string type = i->as<std::string>();
+			itemTypes.push_back(mod->getItem(type));
+			if (!itemTypes.back())
+			{
+				Log(LOG_ERROR) << "Failed to load item " << type;
+			}
+		}
+		for (YAML::const_iterator i = node["binItemSlots"].begin(); i != node["binItemSlots"].end(); ++i)
+		{
+			RuleInventory *slot = mod->getInventory(i->as<std::string>());
+			itemSlots.push_back(slot ? slot : mod->getInventoryGround());
+		}
+	}
+	const YAML::Node &itemTags = node["binItemTags"];
+
 	for (auto& pass : toContainer)
 	{
-		// update start point for matching ammo
-		std::get<size_t>(pass) = std::get<ItemVec>(pass).size();
+		ItemVec items = std::get<ItemVec>(pass);
 
-		for (YAML::const_iterator i = std::get<YAML::Node>(pass).begin(); i != std::get<YAML::Node>(pass).end(); ++i)
+		for (YAML::const_iterator i = std::get<0>(pass).begin(); i != std::get<0>(pass).end(); ++i)
 		{
 			std::string type = (*i)["type"].as<std::string>();
 			if (mod->getItem(type))
@@ -345,56 +506,70 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 				_itemId = std::max(_itemId, id);
 				BattleItem *item = new BattleItem(mod->getItem(type), &id);
 				item->load(*i, mod, this->getMod()->getScriptGlobal());
-				int owner = (*i)["owner"].as<int>(-1);
-				int prevOwner = (*i)["previousOwner"].as<int>(-1);
-				int unit = (*i)["unit"].as<int>(-1);
+				linkItem(item, (*i)["owner"].as<int>(-1), (*i)["previousOwner"].as<int>(-1), (*i)["unit"].as<int>(-1), (*i)["position"].as<Position>(Position(-1, -1, -1)));
+				items.push_back(item);
 
-				// match up items and units
-				for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end() && owner != -1; ++bu)
+				AmmoLink link = { item, &items, { } };
+				std::fill(std::begin(link.ammo), std::end(link.ammo), -1);
+				if (const YAML::Node& ammoSlots = (*i)["ammoItemSlots"])
 				{
-					if ((*bu)->getId() == owner)
+					for (int slot = 0; slot < RuleItem::AmmoSlotMax; ++slot)
 					{
-						item->setOwner(*bu);
-						if (item->isSpecialWeapon())
-						{
-							(*bu)->addLoadedSpecialWeapon(item);
-						}
-						else
-						{
-							(*bu)->getInventory()->push_back(item);
-						}
-						break;
+						link.ammo[slot] = ammoSlots[slot].as<int>(-1);
 					}
 				}
-				for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end() && prevOwner != -1; ++bu)
+				else
 				{
-					if ((*bu)->getId() == prevOwner)
-					{
-						item->setPreviousOwner(*bu);
-						break;
-					}
+					link.ammo[0] = (*i)["ammoItem"].as<int>(-1);
 				}
-				for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end() && unit != -1; ++bu)
+				ammoLinks.push_back(link);
+			}
+			else
+			{
+				Log(LOG_ERROR) << "Failed to load item " << type;
+			}
+		}
+
+		if (const YAML::Node &bin = std::get<1>(pass))
+		{
+			YAML::Binary binItems = bin.as<YAML::Binary>();
+			Uint8 *r = (Uint8*)binItems.data();
+			Uint8 *dataEnd = r + binItems.size();
+
+			while (r < dataEnd)
+			{
+				Uint8 *next = r + itemKey.totalBytes; // skip any obsolete fields present in the data
+				int id = unserializeInt(&r, itemKey.index);
+				int type = unserializeInt(&r, itemKey.type);
+				int owner = unserializeInt(&r, itemKey.index);
+				int prevOwner = unserializeInt(&r, itemKey.index);
+				int unit = unserializeInt(&r, itemKey.index);
+				Position pos;
+				pos.x = unserializeInt(&r, itemKey.position);
+				pos.y = unserializeInt(&r, itemKey.position);
+				pos.z = unserializeInt(&r, itemKey.position);
+				AmmoLink link = { nullptr, &items, { } };
+				std::fill(std::begin(link.ammo), std::end(link.ammo), -1);
+				for (int slot = 0; slot < itemAmmoSlots; ++slot)
 				{
-					if ((*bu)->getId() == unit)
+					int ammoId = unserializeInt(&r, itemKey.index);
+					if (slot < RuleItem::AmmoSlotMax)
 					{
-						item->setUnit(*bu);
-						break;
+						link.ammo[slot] = ammoId;
 					}
 				}
 
-				// match up items and tiles
-				if (item->getSlot() && item->getSlot()->getType() == INV_GROUND)
+				if (type >= 0 && type < (int)itemTypes.size() && itemTypes[type])
 				{
-					Position pos = (*i)["position"].as<Position>(Position(-1, -1, -1));
-					if (pos.x != -1)
-						getTile(pos)->addItem(item, item->getSlot());
+					_itemId = std::max(_itemId, id);
+					BattleItem *item = new BattleItem(itemTypes[type], &id);
+					item->loadBinary(r, itemKey, itemSlots, itemTags, this->getMod()->getScriptGlobal());
+					linkItem(item, owner, prevOwner, unit, pos);
+					items.push_back(item);
+					link.weapon = item;
+					ammoLinks.push_back(link);
 				}
-				std::get<ItemVec>(pass).push_back(item);
-			}
-			else
-			{
-				Log(LOG_ERROR) << "Failed to load item " << type;
+				r = next;
 			}
 		}
 	}
@@ -412,53 +587,30 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 		unit->setSpecialWeapon(this, true);
 	}
 
-	// tie ammo items to their weapons, running through the items again
-	for (auto& pass : toContainer)
+	// tie ammo items to their weapons
+	for (auto& link : ammoLinks)
 	{
-		for (YAML::const_iterator i = std::get<YAML::Node>(pass).begin(); i != std::get<YAML::Node>(pass).end(); ++i)
+		for (int slot = 0; slot < RuleItem::AmmoSlotMax; ++slot)
 		{
-			if (mod->getItem((*i)["type"].as<std::string>()))
+			int ammoId = link.ammo[slot];
+			if (ammoId == -1)
 			{
-				// get next weapon to match ammo
-				auto* weapon = std::get<ItemVec>(pass)[std::get<size_t>(pass)++];
-
-				auto setItem = [&](int slot, const YAML::Node& n)
-				{
-					if (n)
-					{
-						int ammoId = n.as<int>(-1);
-						if (ammoId != -1)
-						{
-							if (ammoId == weapon->getId())
-							{
-								weapon->setAmmoForSlot(slot, weapon);
-							}
-							else
-							{
-								for (auto* item : std::get<ItemVec>(pass))
-								{
-									if (item->getId() == ammoId)
-									{
-										weapon->setAmmoForSlot(slot, item);
-										break;
-									}
-								}
-							}
-						}
-					}
-				};
-
-				if (const YAML::Node& ammoSlots = (*i)["ammoItemSlots"])
+				continue;
+			}
+			if (ammoId == link.weapon->getId())
+			{
+				link.weapon->setAmmoForSlot(slot, link.weapon);
+			}
+			else
+			{
+				for (auto* item : *link.container)
 				{
-					for (int slot = 0; slot < RuleItem::AmmoSlotMax; ++slot)
+					if (item->getId() == ammoId)
 					{
-						setItem(slot, ammoSlots[slot]);
+						link.weapon->setAmmoForSlot(slot, item);
+						break;
 					}
 				}
-				else
-				{
-					setItem(0, (*i)["ammoItem"]);
-				}
 			}
 		}
 	}
@@ -503,6 +655,8 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 	_toggleNightVision = node["toggleNightVision"].as<bool>(_toggleNightVision);
 	_toggleBrightness = node["toggleBrightness"].as<int>(_toggleBrightness);
 	_scriptValues.load(node, _rule->getScriptGlobal());
+
+	Log(LOG_DEBUG) << "Battle loaded in " << SDL_GetTicks() - startTime << " ms (" << (node["unitTotalBytesPer"] ? "binary" : "YAML") << " units, " << (node["itemTotalBytesPer"] ? "binary" : "YAML") << " items, " << (node["nodeTotalBytesPer"] ? "binary" : "YAML") << " nodes)";
 }
 
 /**
@@ -513,7 +667,7 @@ void SavedBattleGame::loadMapResources(Mod *mod)
 {
 	for (std::vector<MapDataSet*>::const_iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
 	{
-		(*i)->loadData(mod->getMCDPatch((*i)->getName()));
+		mod->loadMapDataSet(*i);
 	}
 
 	int mdsID, mdID;
@@ -548,6 +702,7 @@ void SavedBattleGame::loadMapResources(Mod *mod)
  */
 YAML::Node SavedBattleGame::save() const
 {
+	Uint32 startTime = SDL_GetTicks();
 	YAML::Node node;
 	if (_vipSurvivalPercentage > 0)
 	{
@@ -645,27 +800,186 @@ YAML::Node SavedBattleGame::save() const
 	node["binTiles"] = YAML::Binary(tileData, tileDataSize);
 	free(tileData);
 #endif
-	for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+	size_t binarySize = tileDataSize;
+	if (!Options::binaryBattleSaves)
 	{
-		node["nodes"].push_back((*i)->save());
+		for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+		{
+			node["nodes"].push_back((*i)->save());
+		}
+	}
+	else
+	{
+		node["nodeIndexSize"] = static_cast<char>(Node::serializationKey.index);
+		node["nodeTotalBytesPer"] = Node::serializationKey.totalBytes;
+		node["nodePositionSize"] = static_cast<char>(Node::serializationKey.position);
+		node["nodeSmallSize"] = static_cast<char>(Node::serializationKey.small);
+		node["nodeLinksSize"] = static_cast<char>(Node::serializationKey.links);
+		node["nodeBoolFieldsSize"] = static_cast<char>(Node::serializationKey.boolFields);
+
+		size_t nodeDataSize = 0;
+		for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+		{
+			nodeDataSize += (*i)->getBinarySize();
+		}
+		Uint8* nodeData = (Uint8*) calloc(nodeDataSize + 1, 1);
+		Uint8* w = nodeData;
+		for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+		{
+			(*i)->saveBinary(&w);
+		}
+		node["binNodes"] = YAML::Binary(nodeData, nodeDataSize);
+		free(nodeData);
+		binarySize += nodeDataSize;
 	}
 	if (_missionType == "STR_BASE_DEFENSE")
 	{
 		node["moduleMap"] = _baseModules;
 	}
-	for (std::vector<BattleUnit*>::const_iterator i = _units.begin(); i != _units.end(); ++i)
+	if (!Options::binaryBattleSaves)
 	{
-		node["units"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
+		for (std::vector<BattleUnit*>::const_iterator i = _units.begin(); i != _units.end(); ++i)
+		{
+			node["units"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
+		}
 	}
-	for (std::vector<BattleItem*>::const_iterator i = _items.begin(); i != _items.end(); ++i)
+	else
 	{
-		if ((*i)->isSpecialWeapon())
+		node["unitIndexSize"] = static_cast<char>(BattleUnit::serializationKey.index);
+		node["unitTotalBytesPer"] = BattleUnit::serializationKey.totalBytes;
+		node["unitTypeSize"] = static_cast<char>(BattleUnit::serializationKey.type);
+		node["unitPositionSize"] = static_cast<char>(BattleUnit::serializationKey.position);
+		node["unitSmallSize"] = static_cast<char>(BattleUnit::serializationKey.small);
+		node["unitValueSize"] = static_cast<char>(BattleUnit::serializationKey.value);
+		node["unitBoolFieldsSize"] = static_cast<char>(BattleUnit::serializationKey.boolFields);
+		node["unitArmorSides"] = (int)SIDE_MAX;
+		node["unitBodyParts"] = (int)BODYPART_MAX;
+
+		// unit types and armors are saved as indexes into these tables
+		std::map<std::string, int> types, armors;
+		auto getIndex = [&](std::map<std::string, int> &table, const std::string &name, const char *list)
+		{
+			std::map<std::string, int>::iterator i = table.find(name);
+			if (i == table.end())
+			{
+				i = table.insert(std::make_pair(name, (int)table.size())).first;
+				node[list].push_back(name);
+			}
+			return i->second;
+		};
+
+		size_t unitDataSize = BattleUnit::serializationKey.totalBytes * _units.size();
+		Uint8* unitData = (Uint8*) calloc(unitDataSize + 1, 1);
+		Uint8* w = unitData;
+		for (std::vector<BattleUnit*>::const_iterator i = _units.begin(); i != _units.end(); ++i)
 		{
-			node["itemsSpecial"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
+			serializeInt(&w, BattleUnit::serializationKey.index, (*i)->getId());
+			serializeInt(&w, BattleUnit::serializationKey.type, getIndex(types, (*i)->getType(), "binUnitTypes"));
+			serializeInt(&w, BattleUnit::serializationKey.type, getIndex(armors, (*i)->getArmor()->getType(), "binUnitArmors"));
+			serializeInt(&w, BattleUnit::serializationKey.small, (*i)->getOriginalFaction());
+			YAML::Node nested(YAML::NodeType::Map);
+			(*i)->saveBinary(&w, nested, this->getMod()->getScriptGlobal());
+			node["binUnitNested"].push_back(nested);
 		}
-		else
+		node["binUnits"] = YAML::Binary(unitData, unitDataSize);
+		free(unitData);
+		binarySize += unitDataSize;
+	}
+	if (!Options::binaryBattleSaves)
+	{
+		for (std::vector<BattleItem*>::const_iterator i = _items.begin(); i != _items.end(); ++i)
+		{
+			if ((*i)->isSpecialWeapon())
+			{
+				node["itemsSpecial"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
+			}
+			else
+			{
+				node["items"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
+			}
+		}
+		for (std::vector<BattleItem*>::const_iterator i = _recoverGuaranteed.begin(); i != _recoverGuaranteed.end(); ++i)
+		{
+			node["recoverGuaranteed"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
+		}
+		for (std::vector<BattleItem*>::const_iterator i = _recoverConditional.begin(); i != _recoverConditional.end(); ++i)
 		{
-			node["items"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
+			node["recoverConditional"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
+		}
+	}
+	else
+	{
+		node["itemIndexSize"] = static_cast<char>(BattleItem::serializationKey.index);
+		node["itemTotalBytesPer"] = BattleItem::serializationKey.totalBytes;
+		node["itemTypeSize"] = static_cast<char>(BattleItem::serializationKey.type);
+		node["itemSlotSize"] = static_cast<char>(BattleItem::serializationKey.slot);
+		node["itemPositionSize"] = static_cast<char>(BattleItem::serializationKey.position);
+		node["itemSmallSize"] = static_cast<char>(BattleItem::serializationKey.small);
+		node["itemQuantitySize"] = static_cast<char>(BattleItem::serializationKey.quantity);
+		node["itemBoolFieldsSize"] = static_cast<char>(BattleItem::serializationKey.boolFields);
+		node["itemAmmoSlots"] = RuleItem::AmmoSlotMax;
+
+		// item types and inventory slots are saved as indexes into these tables
+		std::map<const RuleItem*, int> types;
+		std::map<const RuleInventory*, int> slots;
+		for (std::map<std::string, RuleInventory*>::const_iterator i = _rule->getInventories()->begin(); i != _rule->getInventories()->end(); ++i)
+		{
+			int index = slots.size();
+			slots[i->second] = index;
+			node["binItemSlots"].push_back(i->first);
+		}
+		YAML::Node tags;
+
+		auto saveItems = [&](const std::vector<BattleItem*> &items, const std::string &name, std::function<bool(const BattleItem*)> filter)
+		{
+			size_t itemDataSize = BattleItem::serializationKey.totalBytes * items.size();
+			Uint8* itemData = (Uint8*) calloc(itemDataSize + 1, 1);
+			Uint8* w = itemData;
+			for (std::vector<BattleItem*>::const_iterator i = items.begin(); i != items.end(); ++i)
+			{
+				const BattleItem *item = *i;
+				if (!filter(item))
+				{
+					itemDataSize -= BattleItem::serializationKey.totalBytes;
+					continue;
+				}
+				std::map<const RuleItem*, int>::iterator type = types.find(item->getRules());
+				if (type == types.end())
+				{
+					type = types.insert(std::make_pair(item->getRules(), (int)types.size())).first;
+					node["binItemTypes"].push_back(item->getRules()->getType());
+				}
+				Position pos = item->getTile() ? item->getTile()->getPosition() : Position(-1, -1, -1);
+
+				serializeInt(&w, BattleItem::serializationKey.index, item->getId());
+				serializeInt(&w, BattleItem::serializationKey.type, type->second);
+				serializeInt(&w, BattleItem::serializationKey.index, item->getOwner() ? item->getOwner()->getId() : -1);
+				serializeInt(&w, BattleItem::serializationKey.index, item->getPreviousOwner() ? item->getPreviousOwner()->getId() : -1);
+				serializeInt(&w, BattleItem::serializationKey.index, item->getUnit() ? item->getUnit()->getId() : -1);
+				serializeInt(&w, BattleItem::serializationKey.position, pos.x);
+				serializeInt(&w, BattleItem::serializationKey.position, pos.y);
+				serializeInt(&w, BattleItem::serializationKey.position, pos.z);
+				for (int slot = 0; slot < RuleItem::AmmoSlotMax; ++slot)
+				{
+					const BattleItem *ammo = item->getAmmoForSlot(slot);
+					serializeInt(&w, BattleItem::serializationKey.index, ammo ? ammo->getId() : -1);
+				}
+				item->saveBinary(&w, slots, tags, this->getMod()->getScriptGlobal());
+			}
+			if (itemDataSize > 0)
+			{
+				node[name] = YAML::Binary(itemData, itemDataSize);
+			}
+			free(itemData);
+			binarySize += itemDataSize;
+		};
+		saveItems(_items, "binItems", [](const BattleItem *item) { return !item->isSpecialWeapon(); });
+		saveItems(_items, "binItemsSpecial", [](const BattleItem *item) { return item->isSpecialWeapon(); });
+		saveItems(_recoverGuaranteed, "binRecoverGuaranteed", [](const BattleItem *) { return true; });
+		saveItems(_recoverConditional, "binRecoverConditional", [](const BattleItem *) { return true; });
+		if (tags.size() > 0)
+		{
+			node["binItemTags"] = tags;
 		}
 	}
 	for (std::vector<BattleObject*>::const_iterator i = _battleObjects.begin(); i != _battleObjects.end(); ++i)
@@ -684,14 +998,6 @@ YAML::Node SavedBattleGame::save() const
 	node["minAmbienceRandomDelay"] = _minAmbienceRandomDelay;
 	node["maxAmbienceRandomDelay"] = _maxAmbienceRandomDelay;
 	node["currentAmbienceDelay"] = _currentAmbienceDelay;
-	for (std::vector<BattleItem*>::const_iterator i = _recoverGuaranteed.begin(); i != _recoverGuaranteed.end(); ++i)
-	{
-		node["recoverGuaranteed"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
-	}
-	for (std::vector<BattleItem*>::const_iterator i = _recoverConditional.begin(); i != _recoverConditional.end(); ++i)
-	{
-		node["recoverConditional"].push_back((*i)->save(this->getMod()->getScriptGlobal()));
-	}
 	node["music"] = _music;
 	node["baseItems"] = _baseItems->save();
 	node["turnLimit"] = _turnLimit;
@@ -702,6 +1008,7 @@ YAML::Node SavedBattleGame::save() const
 	node["toggleBrightness"] = _toggleBrightness;
 	_scriptValues.save(node, _rule->getScriptGlobal());
 
+	Log(LOG_DEBUG) << "Battle saved in " << SDL_GetTicks() - startTime << " ms (" << (Options::binaryBattleSaves ? "binary" : "YAML") << " units, items and nodes, " << binarySize << " bytes of binary data)";
 	return node;
 }
 
@@ -723,6 +1030,10 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool
 
 	if (resetTerrain)
 	{
+		for (auto* set : _mapDataSets)
+		{
+			_rule->releaseMapDataSet(set);
+		}
 		_mapDataSets.clear();
 	}
 
@@ -733,6 +1044,8 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool
 
 	_tiles.clear();
 	_tiles.reserve(_mapsize_z * _mapsize_y * _mapsize_x);
+	_activeTiles.clear();
+	_dangerousTiles.clear();
 	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
 	{
 		_tiles.push_back(Tile(getTileCoords(i), this));
@@ -2491,11 +2804,13 @@ void SavedBattleGame::prepareNewTurn()
 	std::vector<Tile*> tilesOnSmoke;
 
 	// prepare a list of tiles on fire
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	// only tiles that have had fire or smoke are looked at, but sorted into map order like a full scan
+	std::sort(_activeTiles.begin(), _activeTiles.end());
+	for (Tile *tile : _activeTiles)
 	{
-		if (getTile(i)->getFire() > 0)
+		if (tile->getFire() > 0)
 		{
-			tilesOnFire.push_back(getTile(i));
+			tilesOnFire.push_back(tile);
 		}
 	}
 
@@ -2560,14 +2875,19 @@ void SavedBattleGame::prepareNewTurn()
 	}
 
 	// prepare a list of tiles on fire/with smoke in them (smoke acts as fire intensity)
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	std::sort(_activeTiles.begin(), _activeTiles.end());
+	for (Tile *tile : _activeTiles)
 	{
-		if (getTile(i)->getSmoke() > 0)
+		if (tile->getSmoke() > 0)
 		{
-			tilesOnSmoke.push_back(getTile(i));
+			tilesOnSmoke.push_back(tile);
 		}
-		getTile(i)->setDangerous(false);
 	}
+	for (Tile *tile : _dangerousTiles)
+	{
+		tile->setDangerous(false);
+	}
+	_dangerousTiles.clear();
 
 	// now make the smoke spread.
 	for (std::vector<Tile*>::iterator i = tilesOnSmoke.begin(); i != tilesOnSmoke.end(); ++i)
@@ -2624,13 +2944,17 @@ void SavedBattleGame::prepareNewTurn()
 	if (!tilesOnFire.empty() || !tilesOnSmoke.empty())
 	{
 		// do damage to units, average out the smoke, etc.
-		for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+		std::sort(_activeTiles.begin(), _activeTiles.end());
+		for (Tile *tile : _activeTiles)
 		{
-			if (getTile(i)->getSmoke() != 0)
-				getTile(i)->prepareNewTurn(getDepth() == 0);
+			if (tile->getSmoke() != 0)
+				tile->prepareNewTurn(getDepth() == 0);
 		}
 	}
 
+	// drop the tiles where everything burnt out
+	_activeTiles.erase(std::remove_if(_activeTiles.begin(), _activeTiles.end(), [](Tile *tile) { return tile->removeInactive(); }), _activeTiles.end());
+
 	Mod *mod = getBattleState()->getGame()->getMod();
 	for (std::vector<BattleUnit*>::iterator i = getUnits()->begin(); i != getUnits()->end(); ++i)
 	{
@@ -77,6 +77,7 @@ private:
 	int _mapsize_x, _mapsize_y, _mapsize_z;
 	std::vector<MapDataSet*> _mapDataSets;
 	std::vector<Tile> _tiles;
+	std::vector<Tile*> _activeTiles, _dangerousTiles;
 	BattleUnit *_selectedUnit, *_lastSelectedUnit;
 	std::vector<Node*> _nodes;
 	std::vector<BattleUnit*> _units;
@@ -313,6 +314,11 @@ public:
 		return &_tiles[i];
 	}
 
+	/// Adds a tile with fire or smoke to the ones updated every turn.
+	void addActiveTile(Tile *tile) { _activeTiles.push_back(tile); }
+	/// Adds a tile the AI avoids until the next turn.
+	void addDangerousTile(Tile *tile) { _dangerousTiles.push_back(tile); }
+
 	/**
 	 * Get tile that is below current one (const version).
 	 * @param tile
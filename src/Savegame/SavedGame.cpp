@@ -22,6 +22,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <ctime>
+#include <SDL.h>
 #include <yaml-cpp/yaml.h>
 #include "../version.h"
 #include "../Engine/Logger.h"
@@ -35,7 +36,9 @@
 #include "../FTA/MasterMind.h"
 #include "SavedBattleGame.h"
 #include "SerializationHelper.h"
+#include "SaveIndex.h"
 #include "GameTime.h"
+#include "EventScheduler.h"
 #include "Country.h"
 #include "Base.h"
 #include "Craft.h"
@@ -148,13 +151,14 @@ bool haveReserchVector(const std::vector<const RuleResearch*> &vec,  const std::
  * Initializes a brand new saved game according to the specified difficulty.
  */
 SavedGame::SavedGame() :
-	_difficulty(DIFF_BEGINNER), _end(END_NONE), _ironman(false), _globeLon(0.0), _globeLat(0.0), _globeZoom(0), _battleGame(0),
+	_difficulty(DIFF_BEGINNER), _end(END_NONE), _ironman(false), _globeLon(0.0), _globeLat(0.0), _globeZoom(0), _battleGame(0), _researchIndexMod(0),
 	_previewBase(nullptr), _debug(false), _warned(false), _ftaGame(false),
 	_togglePersonalLight(true), _toggleNightVision(false), _toggleBrightness(0),
 	_monthsPassed(-1), _loyalty(0), _lastMonthsLoyalty(0), _selectedBase(0), _autosales(),
 	_disableSoldierEquipment(false), _alienContainmentChecked(false)
 {
 	_time = new GameTime(6, 1, 1, 1999, 12, 0, 0);
+	_events = new EventScheduler();
 	_alienStrategy = new AlienStrategy();
 	_funds.push_back(0);
 	_maintenance.push_back(0);
@@ -175,6 +179,7 @@ SavedGame::SavedGame() :
 SavedGame::~SavedGame()
 {
 	delete _time;
+	delete _events;
 	for (std::vector<Country*>::iterator i = _countries.begin(); i != _countries.end(); ++i)
 	{
 		delete *i;
@@ -298,19 +303,24 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 {
 	std::vector<SaveInfo> info;
 	std::string curMaster = Options::getActiveMaster();
-	auto saves = CrossPlatform::getFolderContents(Options::getMasterUserFolder(), "sav");
+	SaveIndex::wait();
+	auto saves = SaveIndex::refresh(Options::getMasterUserFolder());
 
-	if (autoquick)
-	{
-		auto asaves = CrossPlatform::getFolderContents(Options::getMasterUserFolder(), "asav");
-		saves.insert(saves.begin(), asaves.begin(), asaves.end());
-	}
 	for (auto i = saves.begin(); i != saves.end(); ++i)
 	{
 		auto filename = std::get<0>(*i);
+		if (!autoquick && CrossPlatform::compareExt(filename, "asav"))
+		{
+			continue;
+		}
+		YAML::Node doc;
+		if (!SaveIndex::getHeader(filename, doc))
+		{
+			continue;
+		}
 		try
 		{
-			SaveInfo saveInfo = getSaveInfo(filename, lang);
+			SaveInfo saveInfo = getSaveInfo(filename, std::get<2>(*i), doc, lang);
 			if (!_isCurrentGameType(saveInfo, curMaster))
 			{
 				continue;
@@ -335,12 +345,12 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 /**
  * Gets the info of a specific save file.
  * @param file Save filename.
+ * @param timestamp Save modification time.
+ * @param doc Save header.
  * @param lang Loaded language.
  */
-SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
+SaveInfo SavedGame::getSaveInfo(const std::string &file, time_t timestamp, const YAML::Node &doc, Language *lang)
 {
-	std::string fullname = Options::getMasterUserFolder() + file;
-	YAML::Node doc = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
 	SaveInfo save;
 
 	save.fileName = file;
@@ -383,7 +393,7 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 		save.reserved = false;
 	}
 
-	save.timestamp = CrossPlatform::getDateModified(fullname);
+	save.timestamp = timestamp;
 	std::pair<std::string, std::string> str = CrossPlatform::timeToString(save.timestamp);
 	save.isoDate = str.first;
 	save.isoTime = str.second;
@@ -421,6 +431,7 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
  */
 void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 {
+	Uint32 startTime = SDL_GetTicks();
 	std::string filepath = Options::getMasterUserFolder() + filename;
 	std::vector<YAML::Node> file = YAML::LoadAll(*CrossPlatform::readFile(filepath));
 	// Get brief save info
@@ -440,6 +451,7 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 	// Get full save data
 	YAML::Node doc = file[1];
 	_difficulty = (GameDifficulty)doc["difficulty"].as<int>(_difficulty);
+	_events->setClock(doc["eventClock"].as<int>(0));
 	_end = (GameEnding)doc["end"].as<int>(_end);
 	if (doc["rng"] && (_ironman || !Options::newSeedOnLoad))
 		RNG::setSeed(doc["rng"].as<uint64_t>());
@@ -624,6 +636,7 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 		if (mod->getResearch(research))
 		{
 			_discovered.push_back(mod->getResearch(research));
+			setDiscoveredId(_discovered.back(), true);
 		}
 		else
 		{
@@ -631,6 +644,7 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 		}
 	}
 	sortReserchVector(_discovered);
+	_researchIndexMod = 0;
 
 	for (YAML::const_iterator it = doc["performedCovertOperations"].begin(); it != doc["performedCovertOperations"].end(); ++it)
 	{
@@ -815,11 +829,13 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 		}
 	}
 
-	for (YAML::const_iterator i = doc["missionStatistics"].begin(); i != doc["missionStatistics"].end(); ++i)
+	// only needed by the diaries and the debriefing, so loaded on first use;
+	// kept as text, as a node would keep the whole parsed save alive
+	if (doc["missionStatistics"])
 	{
-		MissionStatistics *ms = new MissionStatistics();
-		ms->load(*i);
-		_missionStatistics.push_back(ms);
+		YAML::Emitter out;
+		out << doc["missionStatistics"];
+		_missionStatisticsData = out.c_str();
 	}
 
 	for (YAML::const_iterator it = doc["autoSales"].begin(); it != doc["autoSales"].end(); ++it)
@@ -835,6 +851,8 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 	{
 		_battleGame = new SavedBattleGame(mod, lang);
 		_battleGame->load(battle, mod, this);
+		Log(LOG_INFO) << "Battle save " << filename << " loaded in " << SDL_GetTicks() - startTime << " ms, " << CrossPlatform::getFileSize(filepath) << " bytes ("
+			<< (battle["unitTotalBytesPer"] ? "binary" : "YAML") << " battle data)";
 	}
 
 	_scriptValues.load(doc, mod->getScriptGlobal());
@@ -846,6 +864,7 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
  */
 void SavedGame::save(const std::string &filename, Mod *mod) const
 {
+	Uint32 startTime = SDL_GetTicks();
 	YAML::Emitter out;
 
 	// Saves the brief game info used in the saves list
@@ -885,6 +904,7 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	out << YAML::BeginDoc;
 	YAML::Node node;
 	node["difficulty"] = (int)_difficulty;
+	node["eventClock"] = _events->getClock();
 	node["end"] = (int)_end;
 	node["monthsPassed"] = _monthsPassed;
 	node["graphRegionToggles"] = _graphRegionToggles;
@@ -1020,9 +1040,17 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	}
 	if (Options::soldierDiaries)
 	{
-		for (std::vector<MissionStatistics*>::const_iterator i = _missionStatistics.begin(); i != _missionStatistics.end(); ++i)
+		if (!_missionStatisticsData.empty())
+		{
+			// never touched since loading, write them back untouched
+			node["missionStatistics"] = YAML::Load(_missionStatisticsData);
+		}
+		else
 		{
-			node["missionStatistics"].push_back((*i)->save());
+			for (std::vector<MissionStatistics*>::const_iterator i = _missionStatistics.begin(); i != _missionStatistics.end(); ++i)
+			{
+				node["missionStatistics"].push_back((*i)->save());
+			}
 		}
 	}
 	for (std::set<const RuleItem*>::const_iterator i = _autosales.begin(); i != _autosales.end(); ++i)
@@ -1052,6 +1080,12 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	{
 		throw Exception("Failed to save " + filepath);
 	}
+	if (_battleGame != 0)
+	{
+		Log(LOG_INFO) << "Battle save " << filename << " written in " << SDL_GetTicks() - startTime << " ms, " << out.size() << " bytes ("
+			<< (Options::binaryBattleSaves ? "binary" : "YAML") << " battle data)";
+	}
+	SaveIndex::update(Options::getMasterUserFolder(), filename, brief);
 }
 
 /**
@@ -1310,6 +1344,63 @@ void SavedGame::setTime(const GameTime& time)
 	_time = new GameTime(time);
 }
 
+/**
+ * Returns the scheduler that keeps the geoscape events
+ * in order of completion time.
+ * @return Pointer to the event scheduler.
+ */
+EventScheduler *SavedGame::getEventScheduler() const
+{
+	return _events;
+}
+
+/**
+ * Advances the event clock by an hour and delivers the transfers
+ * arriving at that hour. Transfers added to a base since the last
+ * hour are scheduled first, so only the bases whose transfers
+ * changed and the transfers that arrive are looked at.
+ * @return True if any transfer arrived.
+ */
+bool SavedGame::deliverTransfers()
+{
+	for (Base *base : _bases)
+	{
+		if (base->getTransfersChanged())
+		{
+			const Base *constBase = base; // looking doesn't count as changing
+			for (Transfer *transfer : *constBase->getTransfers())
+			{
+				if (transfer->getEvent() == 0 && !transfer->isDelivered())
+				{
+					transfer->schedule(_events);
+				}
+			}
+			base->clearTransfersChanged();
+		}
+	}
+
+	bool arrived = false;
+	_events->advance();
+	for (const ScheduledEvent &event : _events->popDue())
+	{
+		if (event.type != SCHEDULED_TRANSFER)
+		{
+			continue;
+		}
+		// the transfer may have been sold, or lost with its base, since
+		for (Base *base : _bases)
+		{
+			if (Transfer *transfer = base->findTransfer(event.id))
+			{
+				transfer->deliver(base);
+				arrived = true;
+				break;
+			}
+		}
+	}
+	return arrived;
+}
+
 /**
  * Returns the latest ID for the specified object
  * and increases it.
@@ -1680,6 +1771,11 @@ void SavedGame::removeDiscoveredResearch(const RuleResearch * research)
 	if (r != _discovered.end())
 	{
 		_discovered.erase(r);
+		if (!haveReserchVector(_discovered, research))
+		{
+			setDiscoveredId(research, false);
+			updateResearchIndex(research, false);
+		}
 	}
 }
 
@@ -1689,8 +1785,14 @@ void SavedGame::removeDiscoveredResearch(const RuleResearch * research)
  */
 void SavedGame::addFinishedResearchSimple(const RuleResearch * research)
 {
+	bool wasDiscovered = haveDiscovered(research);
 	_discovered.push_back(research);
 	sortReserchVector(_discovered);
+	if (!wasDiscovered)
+	{
+		setDiscoveredId(research, true);
+		updateResearchIndex(research, true);
+	}
 }
 
 /**
@@ -1735,6 +1837,8 @@ void SavedGame::addFinishedResearch(const RuleResearch * research, const Mod * m
 		{
 			_discovered.push_back(currentQueueItem);
 			sortReserchVector(_discovered);
+			setDiscoveredId(currentQueueItem, true);
+			updateResearchIndex(currentQueueItem, true);
 			if (!hasUndiscoveredProtectedUnlocks && !hasAnyUndiscoveredGetOneFrees)
 			{
 				// If the currentQueueItem can't tell you anything anymore, remove it from popped research
@@ -1840,63 +1944,181 @@ const std::vector<const RuleResearch *> & SavedGame::getDiscoveredResearch() con
 }
 
 /**
- * Get the list of RuleResearch which can be researched in a Base.
- * @param projects the list of ResearchProject which are available.
+ * Counts what is still missing before a research topic or a manufacture
+ * project can become available, for every one in the mod, and collects
+ * the ones with nothing missing. Afterwards the index is only adjusted
+ * by updateResearchIndex().
  * @param mod the game Mod
- * @param base a pointer to a Base
- * @param considerDebugMode Should debug mode be considered or not.
  */
-void SavedGame::getAvailableResearchProjects(std::vector<RuleResearch *> &projects, const Mod *mod, Base *base, bool considerDebugMode) const
+void SavedGame::buildResearchIndex(const Mod *mod) const
 {
-	// This list is used for topics that can be researched even if *not all* dependencies have been discovered yet (e.g. STR_ALIEN_ORIGINS)
-	// Note: all requirements of such topics *have to* be discovered though! This will be handled elsewhere.
-	std::vector<const RuleResearch *> unlocked;
+	_researchIndexMod = mod;
+	_researchCounters.clear();
+	_researchIndex.clear();
+	_productionCounters.clear();
+	_productionIndex.clear();
+	for (auto& pair : mod->getResearchMap())
+	{
+		ResearchCounters &counters = _researchCounters[pair.second];
+		for (auto* dep : pair.second->getDependencies())
+		{
+			if (!haveDiscovered(dep))
+			{
+				counters.missingDependencies++;
+			}
+		}
+		for (auto* req : pair.second->getRequirements())
+		{
+			if (!haveDiscovered(req))
+			{
+				counters.missingRequirements++;
+			}
+		}
+	}
 	for (const RuleResearch *research : _discovered)
 	{
-		for (auto& itUnlocked : research->getUnlocked())
+		for (auto* unlocked : research->getUnlocked())
 		{
-			unlocked.push_back(itUnlocked);
+			_researchCounters[unlocked].unlockedBy++;
 		}
-		sortReserchVector(unlocked);
 	}
-
-	// Create a list of research topics available for research in the given base
 	for (auto& pair : mod->getResearchMap())
 	{
-		// This research topic is permanently disabled, ignore it!
-		if (isResearchRuleStatusDisabled(pair.first))
+		refreshResearchIndex(pair.second);
+	}
+
+	int position = 0;
+	for (auto& name : mod->getManufactureList())
+	{
+		RuleManufacture *m = mod->getManufacture(name);
+		ProductionCounters &counters = _productionCounters[m];
+		counters.position = position++;
+		const auto &reqs = m->getRequirements();
+		for (auto i = reqs.begin(); i != reqs.end(); ++i)
 		{
-			continue;
+			// count each topic once, same as Mod::getResearchUnlocks() does
+			if (std::find(reqs.begin(), i, *i) == i && !haveDiscovered(*i))
+			{
+				counters.missingRequirements++;
+			}
 		}
-
-		RuleResearch *research = pair.second;
-
-		// This research topic is hidden, don't ever show it to the player!
-		if (research->isHidden())
+		if (counters.missingRequirements == 0)
 		{
-			continue;
+			_productionIndex[counters.position] = m;
 		}
+	}
+}
+
+/**
+ * Gets the research topics whose dependencies (or an unlock) and
+ * requirements are discovered, building the index on first use.
+ * @param mod the game Mod
+ * @return Map of topics by name.
+ */
+const std::map<std::string, RuleResearch*> &SavedGame::getResearchIndex(const Mod *mod) const
+{
+	if (_researchIndexMod != mod)
+	{
+		buildResearchIndex(mod);
+	}
+	return _researchIndex;
+}
+
+/**
+ * Puts a research topic in the availability index or takes it out,
+ * depending on its counters.
+ * @param research The research topic to check.
+ */
+void SavedGame::refreshResearchIndex(const RuleResearch *research) const
+{
+	const ResearchCounters &counters = _researchCounters[research];
+	// Topics on the "unlocked list" can be researched even if *not all* dependencies have been discovered yet (e.g. STR_ALIEN_ORIGINS)
+	// Note: all requirements of such topics *have to* be discovered though!
+	if ((counters.unlockedBy > 0 || counters.missingDependencies == 0) && counters.missingRequirements == 0)
+	{
+		_researchIndex[research->getName()] = _researchIndexMod->getResearch(research->getName());
+	}
+	else
+	{
+		_researchIndex.erase(research->getName());
+	}
+}
 
-		if ((considerDebugMode && _debug) || haveReserchVector(unlocked, research))
+/**
+ * Adjusts the counters of every topic related to a research topic
+ * that was just discovered, or just removed from the discovered list.
+ * @param research The research topic.
+ * @param discovered True if it was discovered, false if removed.
+ */
+void SavedGame::updateResearchIndex(const RuleResearch *research, bool discovered)
+{
+	if (!_researchIndexMod)
+	{
+		// not built yet, will be counted from scratch when needed
+		return;
+	}
+	int change = discovered ? -1 : 1;
+	for (auto* dependent : research->getDependents())
+	{
+		_researchCounters[dependent].missingDependencies += change;
+		refreshResearchIndex(dependent);
+	}
+	for (auto* required : research->getRequiredBy())
+	{
+		_researchCounters[required].missingRequirements += change;
+		refreshResearchIndex(required);
+	}
+	for (auto* unlocked : research->getUnlocked())
+	{
+		_researchCounters[unlocked].unlockedBy -= change;
+		refreshResearchIndex(unlocked);
+	}
+	for (auto* m : _researchIndexMod->getResearchUnlocks(research).manufacture)
+	{
+		ProductionCounters &counters = _productionCounters[m];
+		counters.missingRequirements += change;
+		if (counters.missingRequirements == 0)
 		{
-			// Empty, these research topics are on the "unlocked list", *don't* check the dependencies!
+			_productionIndex[counters.position] = m;
 		}
 		else
 		{
-			// These items are not on the "unlocked list", we must check if "dependencies" are satisfied!
-			if (!isResearched(research->getDependencies(), considerDebugMode))
-			{
-				continue;
-			}
+			_productionIndex.erase(counters.position);
 		}
+	}
+}
 
-		// Check if "requires" are satisfied
-		// IMPORTANT: research topics with "requires" will NEVER be directly visible to the player anyway
-		//   - there is an additional filter in NewResearchListState::fillProjectList(), see comments there for more info
-		//   - there is an additional filter in NewPossibleResearchState::NewPossibleResearchState()
-		//   - we do this check for other functionality using this method, namely SavedGame::addFinishedResearch()
-		//     - Note: when called from there, parameter considerDebugMode = false
-		if (!isResearched(research->getRequirements(), considerDebugMode))
+/**
+ * Get the list of RuleResearch which can be researched in a Base.
+ * @param projects the list of ResearchProject which are available.
+ * @param mod the game Mod
+ * @param base a pointer to a Base
+ * @param considerDebugMode Should debug mode be considered or not.
+ */
+void SavedGame::getAvailableResearchProjects(std::vector<RuleResearch *> &projects, const Mod *mod, Base *base, bool considerDebugMode) const
+{
+	// In debug mode every topic counts as having its dependencies and requirements discovered,
+	// otherwise only look at the topics in the availability index.
+	// IMPORTANT: research topics with "requires" will NEVER be directly visible to the player anyway
+	//   - there is an additional filter in NewResearchListState::fillProjectList(), see comments there for more info
+	//   - there is an additional filter in NewPossibleResearchState::NewPossibleResearchState()
+	//   - we do this check for other functionality using this method, namely SavedGame::addFinishedResearch()
+	//     - Note: when called from there, parameter considerDebugMode = false
+	const std::map<std::string, RuleResearch*> &candidates = (considerDebugMode && _debug) ? mod->getResearchMap() : getResearchIndex(mod);
+
+	// Create a list of research topics available for research in the given base
+	for (auto& pair : candidates)
+	{
+		// This research topic is permanently disabled, ignore it!
+		if (isResearchRuleStatusDisabled(pair.first))
+		{
+			continue;
+		}
+
+		RuleResearch *research = pair.second;
+
+		// This research topic is hidden, don't ever show it to the player!
+		if (research->isHidden())
 		{
 			continue;
 		}
@@ -1985,35 +2207,46 @@ void SavedGame::getNewlyAvailableResearchProjects(std::vector<RuleResearch *> &
  */
 void SavedGame::getAvailableProductions (std::vector<RuleManufacture *> & productions, const Mod * mod, Base * base, ManufacturingFilterType filter) const
 {
-	const std::vector<std::string> &items = mod->getManufactureList();
 	const std::vector<Production *> &baseProductions = base->getProductions();
 	auto baseFunc = base->getProvidedBaseFunc({});
 
-	for (std::vector<std::string>::const_iterator iter = items.begin();
-		iter != items.end();
-		++iter)
+	auto check = [&](RuleManufacture *m)
 	{
-		RuleManufacture *m = mod->getManufacture(*iter);
-		if (!isResearched(m->getRequirements()))
-		{
-			continue;
-		}
 		if (std::find_if (baseProductions.begin(), baseProductions.end(), equalProduction(m)) != baseProductions.end())
 		{
-			continue;
+			return;
 		}
 		if ((~baseFunc & m->getRequireBaseFunc()).any())
 		{
 			if (filter != MANU_FILTER_FACILITY_REQUIRED)
-				continue;
+				return;
 		}
 		else
 		{
 			if (filter == MANU_FILTER_FACILITY_REQUIRED)
-				continue;
+				return;
 		}
 
 		productions.push_back(m);
+	};
+
+	if (_debug)
+	{
+		// everything counts as researched
+		for (auto& name : mod->getManufactureList())
+		{
+			check(mod->getManufacture(name));
+		}
+		return;
+	}
+
+	if (_researchIndexMod != mod)
+	{
+		buildResearchIndex(mod);
+	}
+	for (auto& pair : _productionIndex)
+	{
+		check(pair.second);
 	}
 }
 
@@ -2026,20 +2259,17 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufacture *> & produc
  */
 void SavedGame::getDependableManufacture (std::vector<RuleManufacture *> & dependables, const RuleResearch *research, const Mod * mod, Base *) const
 {
-	const std::vector<std::string> &mans = mod->getManufactureList();
-	for (std::vector<std::string>::const_iterator iter = mans.begin(); iter != mans.end(); ++iter)
+	for (auto* m : mod->getResearchUnlocks(research).manufacture)
 	{
 		// don't show previously unlocked (and seen!) manufacturing topics
-		std::map<std::string, int>::const_iterator i = _manufactureRuleStatus.find(*iter);
+		std::map<std::string, int>::const_iterator i = _manufactureRuleStatus.find(m->getName());
 		if (i != _manufactureRuleStatus.end())
 		{
 			if (i->second != RuleManufacture::MANU_STATUS_NEW)
 				continue;
 		}
 
-		RuleManufacture *m = mod->getManufacture(*iter);
-		const auto &reqs = m->getRequirements();
-		if (isResearched(reqs) && std::find(reqs.begin(), reqs.end(), research) != reqs.end())
+		if (isResearched(m->getRequirements()))
 		{
 			dependables.push_back(m);
 		}
@@ -2081,22 +2311,13 @@ void SavedGame::getAvailableTransformations (std::vector<RuleSoldierTransformati
  */
 void SavedGame::getDependablePurchase(std::vector<RuleItem *> & dependables, const RuleResearch *research, const Mod * mod) const
 {
-	const std::vector<std::string> &itemlist = mod->getItemsList();
-	for (std::vector<std::string>::const_iterator iter = itemlist.begin(); iter != itemlist.end(); ++iter)
+	for (auto* item : mod->getResearchUnlocks(research).items)
 	{
-		RuleItem *item = mod->getItem(*iter);
 		if (item->getBuyCost() != 0)
 		{
-			const std::vector<const RuleResearch *> &reqs = item->getRequirements();
-			bool found = std::find(reqs.begin(), reqs.end(), research) != reqs.end();
-			const std::vector<const RuleResearch *> &reqsBuy = item->getBuyRequirements();
-			bool foundBuy = std::find(reqsBuy.begin(), reqsBuy.end(), research) != reqsBuy.end();
-			if (found || foundBuy)
+			if (isResearched(item->getBuyRequirements()) && isResearched(item->getRequirements()))
 			{
-				if (isResearched(item->getBuyRequirements()) && isResearched(item->getRequirements()))
-				{
-					dependables.push_back(item);
-				}
+				dependables.push_back(item);
 			}
 		}
 	}
@@ -2110,19 +2331,13 @@ void SavedGame::getDependablePurchase(std::vector<RuleItem *> & dependables, con
  */
 void SavedGame::getDependableCraft(std::vector<RuleCraft *> & dependables, const RuleResearch *research, const Mod * mod) const
 {
-	const std::vector<std::string> &craftlist = mod->getCraftsList();
-	for (std::vector<std::string>::const_iterator iter = craftlist.begin(); iter != craftlist.end(); ++iter)
+	for (auto* craftItem : mod->getResearchUnlocks(research).crafts)
 	{
-		RuleCraft *craftItem = mod->getCraft(*iter);
 		if (craftItem->getBuyCost() != 0)
 		{
-			const std::vector<std::string> &reqs = craftItem->getRequirements();
-			if (std::find(reqs.begin(), reqs.end(), research->getName()) != reqs.end())
+			if (isResearched(craftItem->getRequirements()))
 			{
-				if (isResearched(craftItem->getRequirements()))
-				{
-					dependables.push_back(craftItem);
-				}
+				dependables.push_back(craftItem);
 			}
 		}
 	}
@@ -2136,17 +2351,11 @@ void SavedGame::getDependableCraft(std::vector<RuleCraft *> & dependables, const
  */
 void SavedGame::getDependableFacilities(std::vector<RuleBaseFacility *> & dependables, const RuleResearch *research, const Mod * mod) const
 {
-	const std::vector<std::string> &facilitylist = mod->getBaseFacilitiesList();
-	for (std::vector<std::string>::const_iterator iter = facilitylist.begin(); iter != facilitylist.end(); ++iter)
+	for (auto* facilityItem : mod->getResearchUnlocks(research).facilities)
 	{
-		RuleBaseFacility *facilityItem = mod->getBaseFacility(*iter);
-		const std::vector<std::string> &reqs = facilityItem->getRequirements();
-		if (std::find(reqs.begin(), reqs.end(), research->getName()) != reqs.end())
+		if (isResearched(facilityItem->getRequirements()))
 		{
-			if (isResearched(facilityItem->getRequirements()))
-			{
-				dependables.push_back(facilityItem);
-			}
+			dependables.push_back(facilityItem);
 		}
 	}
 }
@@ -2267,6 +2476,58 @@ bool SavedGame::hasUndiscoveredProtectedUnlock(const RuleResearch * r, const Mod
 	return false;
 }
 
+/**
+ * Marks a research topic as discovered or not in the table indexed
+ * by the dense research indexes, which mirrors the discovered list.
+ * @param research The research topic.
+ * @param discovered Whether it's discovered.
+ */
+void SavedGame::setDiscoveredId(const RuleResearch *research, bool discovered)
+{
+	int id = research->getId();
+	if (id < 0)
+	{
+		return;
+	}
+	if ((size_t)id >= _discoveredIds.size())
+	{
+		_discoveredIds.resize(id + 1, false);
+	}
+	_discoveredIds[id] = discovered;
+}
+
+/**
+ * Checks if a research topic is in the discovered list,
+ * without searching the list.
+ * @param research The research topic.
+ * @return Whether it's discovered.
+ */
+bool SavedGame::haveDiscovered(const RuleResearch *research) const
+{
+	int id = research->getId();
+	if (id < 0)
+	{
+		return haveReserchVector(_discovered, research);
+	}
+	return (size_t)id < _discoveredIds.size() && _discoveredIds[id];
+}
+
+/**
+ * Checks if a research topic is in the discovered list,
+ * looking up its rule by name instead of comparing every name.
+ * @param research The research topic name.
+ * @return Whether it's discovered.
+ */
+bool SavedGame::haveDiscovered(const std::string &research) const
+{
+	if (_game == 0 || _game->getMod() == 0)
+	{
+		return haveReserchVector(_discovered, research);
+	}
+	const RuleResearch *rule = _game->getMod()->getResearch(research);
+	return rule != 0 && haveDiscovered(rule);
+}
+
 /**
  * Returns if a certain research topic has been completed.
  * @param research Research ID.
@@ -2280,7 +2541,7 @@ bool SavedGame::isResearched(const std::string &research, bool considerDebugMode
 	if (considerDebugMode && _debug)
 		return true;
 
-	return haveReserchVector(_discovered, research);
+	return haveDiscovered(research);
 }
 
 bool SavedGame::isResearched(const RuleResearch *research, bool considerDebugMode) const
@@ -2290,7 +2551,7 @@ bool SavedGame::isResearched(const RuleResearch *research, bool considerDebugMod
 	if (considerDebugMode && _debug)
 		return true;
 
-	return haveReserchVector(_discovered, research);
+	return haveDiscovered(research);
 }
 
 bool SavedGame::isResearched(const std::vector<std::string> &research, bool considerDebugMode) const
@@ -2302,7 +2563,7 @@ bool SavedGame::isResearched(const std::vector<std::string> &research, bool cons
 
 	for (const std::string &r : research)
 	{
-		if (!haveReserchVector(_discovered, r))
+		if (!haveDiscovered(r))
 		{
 			return false;
 		}
@@ -2343,7 +2604,7 @@ bool SavedGame::isResearched(const std::vector<const RuleResearch *> &research,
 
 	for (auto& r : matches)
 	{
-		if (!haveReserchVector(_discovered, r))
+		if (!haveDiscovered(r))
 		{
 			return false;
 		}
@@ -2627,7 +2888,7 @@ int SavedGame::getSoldierIdleDays(Soldier *soldier)
 	if (lastMissionId == -1)
 		return idleDays;
 
-	for (auto missionInfo : _missionStatistics)
+	for (auto missionInfo : *getMissionStatistics())
 	{
 		if (missionInfo->id == lastMissionId)
 		{
@@ -3244,6 +3505,18 @@ void SavedGame::setGlobalCraftLoadoutName(int index, const std::string &name)
  */
 std::vector<MissionStatistics*> *SavedGame::getMissionStatistics()
 {
+	if (!_missionStatisticsData.empty())
+	{
+		YAML::Node data = YAML::Load(_missionStatisticsData);
+		for (YAML::const_iterator i = data.begin(); i != data.end(); ++i)
+		{
+			MissionStatistics *ms = new MissionStatistics();
+			ms->load(*i);
+			_missionStatistics.push_back(ms);
+		}
+		_missionStatisticsData.clear();
+		_missionStatisticsData.shrink_to_fit();
+	}
 	return &_missionStatistics;
 }
 
@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <set>
 #include <string>
@@ -39,6 +40,7 @@ class Game;
 class Mod;
 class MasterMind;
 class GameTime;
+class EventScheduler;
 class Country;
 class Base;
 class Region;
@@ -142,6 +144,7 @@ private:
 	GameEnding _end;
 	bool _ironman;
 	GameTime *_time;
+	EventScheduler *_events;
 	std::vector<std::string> _userNotes;
 	std::vector<int> _researchScores;
 	std::vector<int64_t> _funds, _maintenance, _incomes, _expenditures;
@@ -158,6 +161,25 @@ private:
 	AlienStrategy *_alienStrategy;
 	SavedBattleGame *_battleGame;
 	std::vector<const RuleResearch*> _discovered;
+	std::vector<bool> _discoveredIds;
+	/// How far a research topic is from being available, kept up to date as topics are discovered.
+	struct ResearchCounters
+	{
+		int missingDependencies = 0;
+		int missingRequirements = 0;
+		int unlockedBy = 0;
+	};
+	mutable const Mod *_researchIndexMod;
+	mutable std::unordered_map<const RuleResearch*, ResearchCounters> _researchCounters;
+	mutable std::map<std::string, RuleResearch*> _researchIndex;
+	/// Undiscovered requirements of a manufacture project, and its place in the manufacture list.
+	struct ProductionCounters
+	{
+		int position = 0;
+		int missingRequirements = 0;
+	};
+	mutable std::unordered_map<const RuleManufacture*, ProductionCounters> _productionCounters;
+	mutable std::map<int, RuleManufacture*> _productionIndex;
 	std::vector<std::string> _performedOperations;
 	std::map<std::string, int> _missionScriptsTimers, _eventScriptsTimers;
 	std::map<std::string, int> _generatedEvents;
@@ -190,13 +212,14 @@ private:
 	std::string _globalCraftLoadoutName[MAX_CRAFT_LOADOUT_TEMPLATES];
 	ItemContainer *_globalCraftLoadout[MAX_CRAFT_LOADOUT_TEMPLATES];
 	std::vector<MissionStatistics*> _missionStatistics;
+	std::string _missionStatisticsData;
 	std::set<int> _ignoredUfos;
 	std::set<const RuleItem *> _autosales;
 	bool _disableSoldierEquipment;
 	bool _alienContainmentChecked;
 	ScriptValues<SavedGame> _scriptValues;
 
-	static SaveInfo getSaveInfo(const std::string &file, Language *lang);
+	static SaveInfo getSaveInfo(const std::string &file, time_t timestamp, const YAML::Node &doc, Language *lang);
 public:
 	static const std::string AUTOSAVE_GEOSCAPE, AUTOSAVE_BATTLESCAPE, QUICKSAVE;
 	/// Creates a new saved game.
@@ -273,6 +296,10 @@ public:
 	GameTime *getTime() const;
 	/// Sets the current game time.
 	void setTime(const GameTime& time);
+	/// Gets the scheduler of the geoscape events.
+	EventScheduler *getEventScheduler() const;
+	/// Advances the event clock and delivers the transfers that arrived.
+	bool deliverTransfers();
 	/// Gets the current ID for an object.
 	int getId(const std::string &name);
 	/// Gets the last ID for an object.
@@ -333,6 +360,20 @@ public:
 	void addFinishedResearch(const RuleResearch *research, const Mod *mod, Base *base, bool score = true);
 	/// Get the list of already discovered research projects
 	const std::vector<const RuleResearch*> & getDiscoveredResearch() const;
+	/// Marks a research topic in the flat discovered table.
+	void setDiscoveredId(const RuleResearch *research, bool discovered);
+	/// Checks the flat discovered table for a research topic.
+	bool haveDiscovered(const RuleResearch *research) const;
+	/// Checks the flat discovered table for a research topic.
+	bool haveDiscovered(const std::string &research) const;
+	/// Updates the research availability index after a topic was discovered or forgotten.
+	void updateResearchIndex(const RuleResearch *research, bool discovered);
+	/// Adds or removes a research topic from the availability index.
+	void refreshResearchIndex(const RuleResearch *research) const;
+	/// Counts the undiscovered dependencies and requirements of all topics and manufacture projects.
+	void buildResearchIndex(const Mod *mod) const;
+	/// Gets the topics whose dependencies and requirements are met.
+	const std::map<std::string, RuleResearch*> &getResearchIndex(const Mod *mod) const;
 	/// Get the list of ResearchProject which can be researched in a Base
 	void getAvailableResearchProjects(std::vector<RuleResearch*> & projects, const Mod *mod, Base *base, bool considerDebugMode = false) const;
 	/// Get the list of newly available research projects once a research has been completed.
@@ -115,7 +115,7 @@ Soldier::Soldier(const RuleSoldier *rules, Armor *armor, int nationality, int id
 	_improvement(0), _psiStrImprovement(0), _rules(rules), _rank(RANK_ROOKIE), _craft(0), _covertOperation(0), _researchProject(0), _production(0), _intelProject(0), _prisoner(0),
 	_gender(GENDER_MALE), _look(LOOK_BLONDE), _lookVariant(0), _missions(0), _kills(0), _stuns(0), _recentlyPromoted(false),
 	_psiTraining(false), _training(false), _returnToTrainingWhenHealed(false), _justSaved(false), _imprisoned(false), _returnToTrainingsWhenOperationOver(NONE),
-	_armor(armor), _replacedArmor(0), _transformedArmor(0), _personalEquipmentArmor(nullptr), _death(0), _diary(new SoldierDiary()),
+	_armor(armor), _replacedArmor(0), _transformedArmor(0), _personalEquipmentArmor(nullptr), _death(0), _diary(new SoldierDiary()), _diaryMod(0),
 	_corpseRecovered(false)
 {
 	if (id != 0)
@@ -400,8 +400,14 @@ void Soldier::load(const YAML::Node& node, const Mod *mod, SavedGame *save, cons
 	}
 	if (node["diary"])
 	{
-		_diary = new SoldierDiary();
-		_diary->load(node["diary"], mod);
+		// most diaries are only ever looked at on the diary screens, so keep them as text until then;
+		// holding on to the node itself would keep the whole parsed save alive
+		delete _diary;
+		_diary = 0;
+		YAML::Emitter out;
+		out << node["diary"];
+		_diaryData = out.c_str();
+		_diaryMod = mod;
 	}
 	calcStatString(mod->getStatStrings(), (Options::psiStrengthEval && save->isResearched(mod->getPsiRequirements())));
 	_corpseRecovered = node["corpseRecovered"].as<bool>(_corpseRecovered);
@@ -528,9 +534,17 @@ YAML::Node Soldier::save(const ScriptGlobal *shared)
 	{
 		node["death"] = _death->save();
 	}
-	if (Options::soldierDiaries && (!_diary->getMissionIdList().empty() || !_diary->getSoldierCommendations()->empty() || _diary->getMonthsService() > 0))
+	if (Options::soldierDiaries)
 	{
-		node["diary"] = _diary->save();
+		if (_diary == 0)
+		{
+			// never touched since loading, write it back untouched
+			node["diary"] = YAML::Load(_diaryData);
+		}
+		else if (!_diary->getMissionIdList().empty() || !_diary->getSoldierCommendations()->empty() || _diary->getMonthsService() > 0)
+		{
+			node["diary"] = _diary->save();
+		}
 	}
 	if (_corpseRecovered)
 		node["corpseRecovered"] = _corpseRecovered;
@@ -1849,6 +1863,13 @@ void Soldier::clearEquipmentLayout()
  */
 SoldierDiary *Soldier::getDiary()
 {
+	if (_diary == 0)
+	{
+		_diary = new SoldierDiary();
+		_diary->load(YAML::Load(_diaryData), _diaryMod);
+		_diaryData.clear();
+		_diaryData.shrink_to_fit();
+	}
 	return _diary;
 }
 
@@ -1859,6 +1880,7 @@ void Soldier::resetDiary()
 {
 	delete _diary;
 	_diary = new SoldierDiary();
+	_diaryData.clear();
 }
 
 /**
@@ -2089,7 +2111,7 @@ bool Soldier::isEligibleForTransformation(RuleSoldierTransformation *transformat
 	for (auto reqd_comm : transformationRule->getRequiredCommendations())
 	{
 		bool found = false;
-		for (auto comm : *_diary->getSoldierCommendations())
+		for (auto comm : *getDiary()->getSoldierCommendations())
 		{
 			if (comm->getDecorationLevelInt() >= reqd_comm.second && comm->getType() == reqd_comm.first)
 			{
@@ -2582,7 +2604,7 @@ const std::vector<const RuleSoldierBonus*> *Soldier::getBonuses(const Mod *mod)
 
 			addSorted(bonusRule);
 		}
-		for (auto commendation : *_diary->getSoldierCommendations())
+		for (auto commendation : *getDiary()->getSoldierCommendations())
 		{
 			auto bonusRule = commendation->getRule()->getSoldierBonus(commendation->getDecorationLevelInt());
 
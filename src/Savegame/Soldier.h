@@ -126,6 +126,8 @@ private:
 	const Armor* _personalEquipmentArmor;
 	SoldierDeath *_death;
 	SoldierDiary *_diary;
+	std::string _diaryData;   // diary as loaded, in YAML, only turned into a SoldierDiary when somebody asks for it
+	const Mod *_diaryMod;
 	std::string _statString;
 	bool _corpseRecovered;
 	std::map<std::string, int> _previousTransformations, _transformationBonuses, _pendingTransformations;
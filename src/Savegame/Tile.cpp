@@ -114,6 +114,7 @@ void Tile::load(const YAML::Node &node)
 	{
 		_animationOffset = RNG::seedless(0, 3);
 	}
+	updateActive();
 }
 
 /**
@@ -145,6 +146,7 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	{
 		_animationOffset = RNG::seedless(0, 3);
 	}
+	updateActive();
 }
 
 
@@ -707,6 +709,7 @@ void Tile::ignite(int power)
 				_overlaps = 1;
 				_fire = getFuel() + 1;
 				_animationOffset = RNG::generate(0,3);
+				updateActive();
 			}
 		}
 	}
@@ -786,6 +789,7 @@ void Tile::setFire(int fire)
 {
 	_fire = Clamp(fire, 0, 255);
 	_animationOffset = RNG::generate(0,3);
+	updateActive();
 }
 
 /**
@@ -815,6 +819,7 @@ void Tile::addSmoke(int smoke)
 		}
 		_animationOffset = RNG::generate(0,3);
 		addOverlap();
+		updateActive();
 	}
 }
 
@@ -826,6 +831,35 @@ void Tile::setSmoke(int smoke)
 {
 	_smoke = Clamp(smoke, 0, 255);
 	_animationOffset = RNG::generate(0,3);
+	updateActive();
+}
+
+/**
+ * Adds the tile to the battle's list of tiles with fire or smoke,
+ * the only ones that need updating at the start of a turn.
+ */
+void Tile::updateActive()
+{
+	if ((_fire || _smoke) && !_cache.isActive)
+	{
+		_cache.isActive = 1;
+		_save->addActiveTile(this);
+	}
+}
+
+/**
+ * Takes the tile off the battle's list of tiles with fire or smoke
+ * once both are gone.
+ * @return True if the tile can be removed from the list.
+ */
+bool Tile::removeInactive()
+{
+	if (_fire || _smoke)
+	{
+		return false;
+	}
+	_cache.isActive = 0;
+	return true;
 }
 
 
@@ -1098,6 +1132,10 @@ void Tile::addOverlap()
  */
 void Tile::setDangerous(bool danger)
 {
+	if (danger && !_cache.danger)
+	{
+		_save->addDangerousTile(this);
+	}
 	_cache.danger = danger;
 }
 
@@ -104,6 +104,7 @@ public:
 		Uint8 isNoFloor:1;
 		Uint8 bigWall:1;
 		Uint8 danger:1;
+		Uint8 isActive:1;
 	};
 
 protected:
@@ -347,6 +348,10 @@ public:
 	void setSmoke(int smoke);
 	/// Get smoke.
 	int getSmoke() const;
+	/// Add the tile to the battle's active tiles if it has fire or smoke.
+	void updateActive();
+	/// Take the tile off the active tiles if it has no fire or smoke.
+	bool removeInactive();
 	/// Get flammability.
 	int getFlammability() const;
 	/// Get turns to burn
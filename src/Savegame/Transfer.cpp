@@ -17,7 +17,9 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Transfer.h"
+#include <algorithm>
 #include "Base.h"
+#include "EventScheduler.h"
 #include "Soldier.h"
 #include "Craft.h"
 #include "ItemContainer.h"
@@ -32,7 +34,7 @@ namespace OpenXcom
  * Initializes a transfer.
  * @param hours Hours in-transit.
  */
-Transfer::Transfer(int hours) : _hours(hours), _soldier(0), _craft(0), _itemQty(0), _scientists(0), _engineers(0), _delivered(false)
+Transfer::Transfer(int hours) : _hours(hours), _arrival(-1), _event(0), _soldier(0), _craft(0), _itemQty(0), _scientists(0), _engineers(0), _delivered(false)
 {
 }
 
@@ -59,6 +61,7 @@ Transfer::~Transfer()
 bool Transfer::load(const YAML::Node& node, Base *base, const Mod *mod, SavedGame *save)
 {
 	_hours = node["hours"].as<int>(_hours);
+	_arrival = node["arrival"].as<int>(_arrival);
 	if (const YAML::Node &soldier = node["soldier"])
 	{
 		std::string type = soldier["type"].as<std::string>(mod->getSoldiersList().front());
@@ -114,7 +117,14 @@ bool Transfer::load(const YAML::Node& node, Base *base, const Mod *mod, SavedGam
 YAML::Node Transfer::save(const Base *b, const Mod *mod) const
 {
 	YAML::Node node;
-	node["hours"] = _hours;
+	if (_arrival < 0)
+	{
+		node["hours"] = _hours;
+	}
+	else
+	{
+		node["arrival"] = _arrival;
+	}
 	if (_soldier != 0)
 	{
 		node["soldier"] = _soldier->save(mod->getScriptGlobal());
@@ -237,10 +247,15 @@ std::string Transfer::getName(Language *lang) const
 /**
  * Returns the time remaining until the
  * transfer arrives at its destination.
+ * @param clock Current hour of the event clock.
  * @return Amount of hours.
  */
-int Transfer::getHours() const
+int Transfer::getHours(int clock) const
 {
+	if (_arrival >= 0)
+	{
+		return std::max(0, _arrival - clock);
+	}
 	return _hours;
 }
 
@@ -291,39 +306,52 @@ TransferType Transfer::getType() const
 }
 
 /**
- * Advances the transfer and takes care of
- * the delivery once it's arrived.
+ * Schedules the transfer's arrival once the event clock has advanced
+ * by its remaining hours, unless it already has an arrival hour
+ * from the save. Transfers always take at least an hour.
+ * @param events Pointer to the event scheduler.
+ */
+void Transfer::schedule(EventScheduler *events)
+{
+	if (_arrival < 0)
+	{
+		_arrival = events->getClock() + std::max(1, _hours);
+	}
+	_event = events->schedule(_arrival, SCHEDULED_TRANSFER);
+}
+
+/**
+ * Takes care of the delivery once the transfer has arrived.
  * @param base Pointer to destination base.
  */
-void Transfer::advance(Base *base)
+void Transfer::deliver(Base *base)
 {
-	_hours--;
-	if (_hours <= 0)
+	_hours = 0;
+	_arrival = -1;
+	_event = 0;
+	if (_soldier != 0)
 	{
-		if (_soldier != 0)
-		{
-			base->getSoldiers()->push_back(_soldier);
-		}
-		else if (_craft != 0)
-		{
-			base->getCrafts()->push_back(_craft);
-			_craft->setBase(base);
-			_craft->checkup();
-		}
-		else if (_itemQty != 0)
-		{
-			base->getStorageItems()->addItem(_itemId, _itemQty);
-		}
-		else if (_scientists != 0)
-		{
-			base->setScientists(base->getScientists() + _scientists);
-		}
-		else if (_engineers != 0)
-		{
-			base->setEngineers(base->getEngineers() + _engineers);
-		}
-		_delivered = true;
+		base->getSoldiers()->push_back(_soldier);
+	}
+	else if (_craft != 0)
+	{
+		base->getCrafts()->push_back(_craft);
+		_craft->setBase(base);
+		_craft->checkup();
+	}
+	else if (_itemQty != 0)
+	{
+		base->getStorageItems()->addItem(_itemId, _itemQty);
+	}
+	else if (_scientists != 0)
+	{
+		base->setScientists(base->getScientists() + _scientists);
+	}
+	else if (_engineers != 0)
+	{
+		base->setEngineers(base->getEngineers() + _engineers);
 	}
+	_delivered = true;
 }
 
 /**
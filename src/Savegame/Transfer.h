@@ -54,6 +54,7 @@ class Language;
 class Base;
 class Mod;
 class SavedGame;
+class EventScheduler;
 
 /**
  * Represents an item transfer.
@@ -64,6 +65,7 @@ class Transfer
 {
 private:
 	int _hours;
+	int _arrival, _event;
 	Soldier *_soldier;
 	Craft *_craft;
 	std::string _itemId;
@@ -95,13 +97,19 @@ public:
 	/// Gets the name of the transfer.
 	std::string getName(Language *lang) const;
 	/// Gets the hours remaining of the transfer.
-	int getHours() const;
+	int getHours(int clock) const;
 	/// Gets the quantity of the transfer.
 	int getQuantity() const;
 	/// Gets the type of the transfer.
 	TransferType getType() const;
-	/// Advances the transfer.
-	void advance(Base *base);
+	/// Schedules the transfer's arrival.
+	void schedule(EventScheduler *events);
+	/// Gets the id of the transfer's arrival event.
+	int getEvent() const { return _event; }
+	/// Checks if the transfer was delivered.
+	bool isDelivered() const { return _delivered; }
+	/// Delivers the transfer.
+	void deliver(Base *base);
 	/// Get a pointer to the soldier being transferred.
 	Soldier *getSoldier();
 
@@ -0,0 +1,339 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <SDL.h>
+#include <yaml-cpp/yaml.h>
+#include "Engine/Benchmark.h"
+#include "Engine/CrossPlatform.h"
+#include "Engine/Exception.h"
+#include "Engine/FileMap.h"
+#include "Engine/Game.h"
+#include "Engine/Logger.h"
+#include "Engine/Options.h"
+#include "Engine/Script.h"
+#include "Engine/Surface.h"
+#include "Battlescape/AIModule.h"
+#include "Battlescape/BattlescapeState.h"
+#include "Mod/Mod.h"
+#include "Mod/RuleItem.h"
+#include "Mod/RuleResearch.h"
+#include "Savegame/Base.h"
+#include "Savegame/BattleUnit.h"
+#include "Savegame/ItemContainer.h"
+#include "Savegame/SavedBattleGame.h"
+#include "Savegame/SavedGame.h"
+
+/**
+ * Headless benchmark runner, built as openxcom_bench.
+ *
+ * It starts the game on SDL's dummy video and audio drivers, so it can run
+ * on a machine without a display. Point -user at a folder holding an
+ * options.cfg with the test mod enabled and the reference saves (*.sav);
+ * the timings are logged and compared with benchmark_headless.yml in
+ * that folder. Pass -baseline 1 to store them as the new baseline.
+ */
+
+using namespace OpenXcom;
+
+namespace
+{
+
+/// Keeps the results of the lookups from being optimized away.
+volatile size_t sink;
+
+/// Item rules by name, kept in a tree map as Mod looked them up before the hashed tables.
+std::map<std::string, RuleItem*> itemMap;
+
+/**
+ * Times looking up every item and research rule by name, through a tree
+ * map as it was done before the dense indexes, and through Mod.
+ * @param mod Loaded mod.
+ * @param bench Benchmark to add the results to.
+ */
+void benchRuleLookups(const Mod *mod, Benchmark &bench)
+{
+	std::map<std::string, RuleResearch*> researchMap;
+	for (const std::string &type : mod->getItemsList())
+	{
+		itemMap[type] = mod->getItem(type);
+	}
+	for (const std::string &name : mod->getResearchList())
+	{
+		researchMap[name] = mod->getResearch(name);
+	}
+
+	bench.run("Item lookups (std::map)", 200, [&]
+	{
+		size_t found = 0;
+		for (const std::string &type : mod->getItemsList())
+		{
+			found += itemMap.find(type)->second != 0;
+		}
+		sink = found;
+	});
+	bench.run("Item lookups (Mod::getItem)", 200, [&]
+	{
+		size_t found = 0;
+		for (const std::string &type : mod->getItemsList())
+		{
+			found += mod->getItem(type) != 0;
+		}
+		sink = found;
+	});
+	bench.run("Research lookups (std::map)", 200, [&]
+	{
+		size_t found = 0;
+		for (const std::string &name : mod->getResearchList())
+		{
+			found += researchMap.find(name)->second != 0;
+		}
+		sink = found;
+	});
+	bench.run("Research lookups (Mod::getResearch)", 200, [&]
+	{
+		size_t found = 0;
+		for (const std::string &name : mod->getResearchList())
+		{
+			found += mod->getResearch(name) != 0;
+		}
+		sink = found;
+	});
+}
+
+/**
+ * Times the storage calculations of every base in a save. The item
+ * sizes are summed without the cached container totals, once looking
+ * the rules up through a tree map as before and once through Mod.
+ * @param save Loaded save.
+ * @param mod Loaded mod.
+ * @param bench Benchmark to add the results to.
+ * @param name Name of the save, used in the result names.
+ */
+void benchStores(SavedGame *save, const Mod *mod, Benchmark &bench, const std::string &name)
+{
+	bench.run(name + " Base item sizes (std::map)", 200, [&]
+	{
+		double total = 0;
+		for (Base *base : *save->getBases())
+		{
+			for (const auto &item : *base->getStorageItems()->getContents())
+			{
+				total += itemMap.find(item.first)->second->getSize() * item.second;
+			}
+		}
+		sink = (size_t)total;
+	});
+	bench.run(name + " Base item sizes (Mod::getItem)", 200, [&]
+	{
+		double total = 0;
+		for (Base *base : *save->getBases())
+		{
+			for (const auto &item : *base->getStorageItems()->getContents())
+			{
+				total += mod->getItem(item.first, true)->getSize() * item.second;
+			}
+		}
+		sink = (size_t)total;
+	});
+	bench.run(name + " Base::getUsedStores", 200, [&]
+	{
+		double total = 0;
+		for (const Base *base : *save->getBases())
+		{
+			total += base->getUsedStores();
+		}
+		sink = (size_t)total;
+	});
+}
+
+/**
+ * Times the battlescape AI and the unit recolor scripts on a loaded battle.
+ * @param game Game with the battle loaded.
+ * @param bench Benchmark to add the results to.
+ * @param name Name of the save, used in the result names.
+ */
+void benchBattle(Game *game, Benchmark &bench, const std::string &name)
+{
+	SavedBattleGame *battle = game->getSavedGame()->getSavedBattle();
+	battle->loadMapResources(game->getMod());
+	BattlescapeState *bs = new BattlescapeState;
+	battle->setBattleState(bs);
+
+	std::vector<BattleUnit*> aliens;
+	std::vector<BattleUnit*> units;
+	for (BattleUnit *unit : *battle->getUnits())
+	{
+		if (unit->isOut() || !unit->getTile())
+		{
+			continue;
+		}
+		units.push_back(unit);
+		if (unit->getFaction() != FACTION_PLAYER)
+		{
+			if (!unit->getAIModule())
+			{
+				unit->setAIModule(new AIModule(battle, unit, 0));
+			}
+			aliens.push_back(unit);
+		}
+	}
+
+	if (!aliens.empty())
+	{
+		bench.run(name + " AIModule::think", 10, [&]
+		{
+			for (BattleUnit *unit : aliens)
+			{
+				BattleAction action;
+				action.actor = unit;
+				action.number = 1;
+				unit->think(&action);
+			}
+		});
+	}
+
+	// the recolor scripts are run on every pixel of a unit sprite
+	Surface sprite(32, 40), canvas(32, 40);
+	for (int y = 0; y < sprite.getHeight(); ++y)
+	{
+		for (int x = 0; x < sprite.getWidth(); ++x)
+		{
+			sprite.setPixel(x, y, (x + y) & 0xFF);
+		}
+	}
+	bench.run(name + " RecolorUnitSprite", 20, [&]
+	{
+		ScriptWorkerBlit work;
+		for (BattleUnit *unit : units)
+		{
+			for (int part = 0; part < 6; ++part)
+			{
+				BattleUnit::ScriptFill(&work, unit, battle, part, 0, 0, 0);
+				work.executeBlit(&sprite, &canvas, 0, 0, 0);
+			}
+		}
+	});
+
+	battle->setBattleState(0);
+	delete bs;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_putenv((char *)"SDL_VIDEODRIVER=dummy");
+	SDL_putenv((char *)"SDL_AUDIODRIVER=dummy");
+
+	CrossPlatform::processArgs(argc, argv);
+	if (!Options::init())
+		return EXIT_SUCCESS;
+	Options::baseXResolution = Options::displayWidth;
+	Options::baseYResolution = Options::displayHeight;
+
+	Game *game = new Game("OpenXcom benchmark");
+	State::setGamePtr(game);
+	int result = EXIT_SUCCESS;
+	try
+	{
+		Benchmark bench("headless");
+		bench.run("Mod::loadAll", 3, [&]{ game->loadMods(); });
+		game->loadLanguages();
+		benchRuleLookups(game->getMod(), bench);
+
+		Surface src(320, 200), dest(320, 200);
+		for (int y = 0; y < src.getHeight(); ++y)
+		{
+			for (int x = 0; x < src.getWidth(); ++x)
+			{
+				src.setPixel(x, y, (x * y) & 0xFF);
+			}
+		}
+		bench.run("Surface::blit", 200, [&]{ src.blit(dest.getSurface()); });
+		bench.run("Surface::blitNShade", 200, [&]{ src.blitNShade(&dest, 0, 0, 4); });
+
+		const std::string output = "benchmark.tmp";
+		std::vector<std::string> saves;
+		for (const auto &file : CrossPlatform::getFolderContents(Options::getMasterUserFolder(), "sav"))
+		{
+			saves.push_back(std::get<0>(file));
+		}
+		std::sort(saves.begin(), saves.end());
+		for (const std::string &name : saves)
+		{
+			bench.run(name + " SavedGame::load", 5, [&]
+			{
+				SavedGame save;
+				save.load(name, game->getMod(), game->getLanguage());
+			});
+
+			SavedGame *save = new SavedGame();
+			save->load(name, game->getMod(), game->getLanguage());
+			game->setSavedGame(save);
+			save->setGamePtr(game);
+			bench.run(name + " SavedGame::save", 5, [&]{ save->save(output, game->getMod()); });
+			CrossPlatform::deleteFile(Options::getMasterUserFolder() + output);
+			benchStores(save, game->getMod(), bench, name);
+
+			if (save->getSavedBattle())
+			{
+				benchBattle(game, bench, name);
+			}
+			game->setSavedGame(0);
+		}
+
+		bool saveBaseline = false;
+		const auto &args = CrossPlatform::getArgs();
+		for (size_t i = 1; i + 1 < args.size(); ++i)
+		{
+			if (args[i] == "-baseline" && args[i + 1] != "0")
+			{
+				saveBaseline = true;
+			}
+		}
+		bench.report(saveBaseline);
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << e.what();
+		result = EXIT_FAILURE;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << e.what();
+		result = EXIT_FAILURE;
+	}
+
+	delete game;
+	FileMap::clear(true, false);
+	return result;
+}
+
+namespace OpenXcom
+{
+	Exception::Exception(const std::string &msg) : runtime_error(msg) {
+#ifdef DUMP_CORE
+		__builtin_trap();
+#endif
+	}
+}